@@ -0,0 +1,298 @@
+/**
+ * @file ai.c
+ * @brief Автоматический игрок.
+ *
+ * Для текущей фигуры перебираются все достижимые места: каждое состояние
+ * поворота, достижимое поворотами на начальной позиции, и каждый столбец,
+ * достижимый сдвигами после поворота. Фигура опускается мгновенным
+ * падением (landingRow()), поле после фиксации и удаления линий
+ * оценивается взвешенной суммой признаков (см. AiWeights). При включённом
+ * просмотре вперёд оценка места - лучшая оценка среди мест следующей
+ * фигуры (nextID) на получившемся поле. Если игроку задана таблица
+ * транспозиций (table.h), оценка поля, к которому разные места приводят
+ * повторно, берётся из неё по хешу Зобриста поля.
+ *
+ * Одна оценка - это копия поля (64 байта), фиксация фигуры масками строк и
+ * один проход по строкам, поэтому игрок подходит и для нагрузочных
+ * прогонов (см. `sim -A`).
+ */
+
+#include "ai.h"
+
+#include <float.h>
+
+#include "search.h"
+#include "table.h"
+
+#define AI_TOP_OUT_SCORE \
+  (-DBL_MAX) /*!< Оценка места, после которого игра заканчивается */
+
+/**
+ * @brief Инициализирует автоматического игрока весами по умолчанию.
+ * @param ai Указатель на игрока.
+ * @param lookahead Учитывать следующую фигуру.
+ */
+void initAutoplayer(Autoplayer *ai, bool lookahead) {
+  ai->weights.height = -0.510066;
+  ai->weights.lines = 0.760666;
+  ai->weights.holes = -0.35663;
+  ai->weights.bumpiness = -0.184483;
+  ai->lookahead = lookahead;
+  ai->pieces = -1;
+  ai->target.score = 0;
+  ai->counters = (AiCounters){0, 0, 0};
+  ai->pool = NULL;
+  ai->table = NULL;
+}
+
+/**
+ * @brief Оценивает поле взвешенной суммой признаков.
+ *
+ * Высоты столбцов берутся из Field::heights. Дыры - пустые клетки, над
+ * которыми в том же столбце есть блок, - считаются по маскам строк: маска
+ * столбцов, уже закрытых сверху, пересекается с пустыми клетками строки.
+ *
+ * @param field Указатель на поле.
+ * @param lines Количество линий, удалённых при получении поля.
+ * @param weights Веса признаков.
+ * @return Оценка поля, чем больше - тем лучше.
+ */
+double evaluateField(const Field *field, int lines, const AiWeights *weights) {
+  int height = field->heights[0];
+  int bumpiness = 0;
+  for (int j = 1; j < FIELD_WIDTH; j++) {
+    height += field->heights[j];
+    bumpiness += abs(field->heights[j] - field->heights[j - 1]);
+  }
+
+  int holes = 0;
+  uint16_t covered = 0;
+  for (int i = 0; i < FIELD_HEIGHT; i++) {
+    holes += __builtin_popcount(covered & (uint16_t)~field->rows[i]);
+    covered |= field->rows[i];
+  }
+
+  return weights->height * height + weights->lines * lines +
+         weights->holes * holes + weights->bumpiness * bumpiness;
+}
+
+/**
+ * @brief Перечисляет все места, достижимые фигурой из текущей позиции.
+ *
+ * Фигура поворачивается на месте (как rotate(), без смещений у стен), пока
+ * поворот не упрётся в блоки; для каждого состояния поворота она
+ * сдвигается влево и вправо до столкновения и опускается в место падения.
+ *
+ * @param field Указатель на поле.
+ * @param figure Указатель на фигуру в исходной позиции.
+ * @param placements Массив не менее чем из AI_MAX_PLACEMENTS мест.
+ * @return Количество найденных мест (0, если фигура уже сталкивается).
+ */
+int findPlacements(const Field *field, const Figure *figure,
+                   Placement *placements) {
+  int count = 0;
+  Figure rotated = *figure;
+  for (int r = 0; r < ROTATIONS_COUNT && !figureCollides(field, &rotated);
+       r++) {
+    Figure probe = rotated;
+    while (!figureCollides(field, &probe)) probe.x--;
+    for (probe.x++; !figureCollides(field, &probe); probe.x++) {
+      placements[count].figure = probe;
+      placements[count].figure.y = landingRow(field, &probe);
+      placements[count].score = 0;
+      count++;
+    }
+    rotationFigure(&rotated);
+  }
+  return count;
+}
+
+/**
+ * @brief Фиксирует фигуру на копии поля и удаляет заполненные линии.
+ * @param field Указатель на исходное поле.
+ * @param figure Указатель на фигуру в месте падения.
+ * @param result Указатель на поле-результат.
+ * @return Количество удалённых линий.
+ */
+int placeFigure(const Field *field, const Figure *figure, Field *result) {
+  *result = *field;
+  plantShape(result, figure);
+  return eraseLines(result);
+}
+
+/**
+ * @brief Оценивает поле после фиксации фигуры без учёта удалённых ею линий.
+ *
+ * Оценка зависит только от поля и следующей фигуры, поэтому кешируется в
+ * таблице транспозиций игрока по ключу `Field::hash ^ nextKeys[nextID]`
+ * вместе с лучшим местом следующей фигуры.
+ *
+ * @param ai Указатель на игрока.
+ * @param board Указатель на поле.
+ * @param nextID Идентификатор следующей фигуры.
+ * @param counters Счётчики оценённых полей и поисков в таблице.
+ * @return Оценка поля; AI_TOP_OUT_SCORE, если следующей фигуре негде
+ * появиться.
+ */
+static double boardValue(const Autoplayer *ai, const Field *board, int nextID,
+                         AiCounters *counters) {
+  static const uint64_t nextKeys[FIGURES_COUNT] = {
+      0x57AE0BD39182A311ULL, 0xC0FE68584DA675CFULL, 0xF1A49BD61364AB96ULL,
+      0xB05EC793EF6103F8ULL, 0x85D0493962AB557BULL, 0xFEA4A403432601EBULL,
+      0x87EBB431317A6FD5ULL};
+  uint64_t key = board->hash ^ nextKeys[nextID];
+  double value = AI_TOP_OUT_SCORE;
+  bool found = false;
+  if (ai->table) {
+    counters->probes++;
+    found = probeTable(ai->table, key, &value, NULL);
+    counters->hits += found;
+  }
+  if (!found) {
+    Figure best;
+    spawnFigure(&best, nextID);
+    if (figureCollides(board, &best)) {
+      counters->evaluations++;
+    } else if (!ai->lookahead) {
+      value = evaluateField(board, 0, &ai->weights);
+      counters->evaluations++;
+    } else {
+      Placement placements[AI_MAX_PLACEMENTS];
+      int count = findPlacements(board, &best, placements);
+      for (int i = 0; i < count; i++) {
+        Field after;
+        int lines = placeFigure(board, &placements[i].figure, &after);
+        double next = evaluateField(&after, lines, &ai->weights);
+        if (next > value) {
+          value = next;
+          best = placements[i].figure;
+        }
+      }
+      counters->evaluations += count;
+    }
+    if (ai->table) storeTable(ai->table, key, value, &best);
+  }
+  return value;
+}
+
+/**
+ * @brief Оценивает место фигуры.
+ *
+ * Функция не изменяет игрока, поэтому места одной позиции можно оценивать
+ * в разных потоках (см. search.h); таблица транспозиций допускает
+ * одновременный доступ.
+ *
+ * @param ai Указатель на игрока (веса и режим просмотра вперёд).
+ * @param field Указатель на поле до фиксации фигуры.
+ * @param placed Указатель на фигуру в месте падения.
+ * @param nextID Идентификатор следующей фигуры.
+ * @param counters Счётчики вызывающего потока, увеличиваются на число
+ * оценённых полей и поисков в таблице.
+ * @return Оценка места; AI_TOP_OUT_SCORE, если следующей фигуре негде
+ * появиться.
+ */
+double scorePlacement(const Autoplayer *ai, const Field *field,
+                      const Figure *placed, int nextID,
+                      AiCounters *counters) {
+  Field board;
+  int lines = placeFigure(field, placed, &board);
+  double score = boardValue(ai, &board, nextID, counters);
+  if (score != AI_TOP_OUT_SCORE) score += ai->weights.lines * lines;
+  return score;
+}
+
+/**
+ * @brief Выбирает лучшее место для текущей фигуры игры.
+ *
+ * Если достижимых мест нет, возвращается текущее положение фигуры.
+ *
+ * @param ai Указатель на игрока.
+ * @param game Указатель на игру.
+ * @return Лучшее место.
+ */
+Placement bestPlacement(Autoplayer *ai, const Game *game) {
+  Placement placements[AI_MAX_PLACEMENTS];
+  int count = findPlacements(game->field, game->figure, placements);
+
+  for (int i = 0; i < count; i++)
+    placements[i].score =
+        scorePlacement(ai, game->field, &placements[i].figure,
+                       game->gameInfo->nextID, &ai->counters);
+  return choosePlacement(game->figure, placements, count);
+}
+
+/**
+ * @brief Выбирает место с наибольшей оценкой.
+ *
+ * При равных оценках выбирается место, перечисленное раньше, поэтому
+ * результат не зависит от порядка, в котором оценивались места.
+ *
+ * @param figure Указатель на фигуру в исходной позиции.
+ * @param placements Оценённые места.
+ * @param count Количество мест.
+ * @return Лучшее место или исходное положение фигуры, если мест нет.
+ */
+Placement choosePlacement(const Figure *figure, const Placement *placements,
+                          int count) {
+  Placement best = {*figure, AI_TOP_OUT_SCORE};
+  for (int i = 0; i < count; i++)
+    if (i == 0 || placements[i].score > best.score) best = placements[i];
+  return best;
+}
+
+/**
+ * @brief Составляет последовательность действий, ведущую фигуру к месту.
+ *
+ * Сначала фигура поворачивается, затем сдвигается по горизонтали и
+ * опускается мгновенным падением - в том же порядке, в котором места
+ * перечисляет findPlacements().
+ *
+ * @param figure Указатель на фигуру в исходной позиции.
+ * @param target Указатель на выбранное место.
+ * @param actions Массив не менее чем из AI_MAX_PLAN действий.
+ * @return Количество действий.
+ */
+int planActions(const Figure *figure, const Placement *target,
+                UserAction *actions) {
+  int count = 0;
+  int turns = (target->figure.rotation - figure->rotation + ROTATIONS_COUNT) %
+              ROTATIONS_COUNT;
+  for (int i = 0; i < turns; i++) actions[count++] = ROTATE;
+  for (int x = figure->x; x < target->figure.x; x++) actions[count++] = RIGHT;
+  for (int x = figure->x; x > target->figure.x; x--) actions[count++] = LEFT;
+  actions[count++] = HARD_DROP;
+  return count;
+}
+
+/**
+ * @brief Возвращает следующее действие автоматического игрока.
+ *
+ * Место выбирается один раз при появлении новой фигуры. Затем действие
+ * определяется по разнице между фигурой и выбранным местом, поэтому
+ * отклонения от плана (например, сдвиг фигуры вниз по таймеру) не требуют
+ * повторного поиска. На паузе и после окончания игры возвращается ACTION.
+ *
+ * @param ai Указатель на игрока.
+ * @param game Указатель на игру.
+ * @return Действие игрока.
+ */
+UserAction aiAction(Autoplayer *ai, const Game *game) {
+  UserAction action = ACTION;
+  if (!game->gameInfo->pause && game->gameInfo->state != GameOver) {
+    if (ai->pieces != game->gameInfo->pieces) {
+      ai->target = ai->pool ? parallelPlacement(ai->pool, ai, game)
+                            : bestPlacement(ai, game);
+      ai->pieces = game->gameInfo->pieces;
+    }
+    const Figure *figure = game->figure;
+    if (figure->rotation != ai->target.figure.rotation)
+      action = ROTATE;
+    else if (figure->x < ai->target.figure.x)
+      action = RIGHT;
+    else if (figure->x > ai->target.figure.x)
+      action = LEFT;
+    else
+      action = HARD_DROP;
+  }
+  return action;
+}
@@ -0,0 +1,80 @@
+#ifndef AI_H_
+#define AI_H_
+
+#include "tetris.h"
+
+#define AI_MAX_PLACEMENTS \
+  (ROTATIONS_COUNT * FIELD_WIDTH) /*!< Наибольшее число мест для фигуры */
+#define AI_MAX_PLAN \
+  (ROTATIONS_COUNT + FIELD_WIDTH + 1) /*!< Наибольшая длина плана действий */
+
+/**
+ * @struct AiWeights
+ * @brief Веса признаков поля в оценке позиции.
+ */
+typedef struct AiWeights {
+  double height;     ///< Сумма высот столбцов
+  double lines;      ///< Количество удалённых линий
+  double holes;      ///< Количество пустых клеток под блоками
+  double bumpiness;  ///< Сумма перепадов высот соседних столбцов
+} AiWeights;
+
+/**
+ * @struct Placement
+ * @brief Место, на котором фигура будет зафиксирована.
+ */
+typedef struct Placement {
+  Figure figure;  ///< Фигура в месте падения
+  double score;   ///< Оценка поля после фиксации
+} Placement;
+
+/**
+ * @struct AiCounters
+ * @brief Счётчики работы автоматического игрока.
+ *
+ * Каждый поток поиска ведёт собственные счётчики, а сумма собирается при
+ * выводе статистики, поэтому общая таблица транспозиций счётчиков не
+ * содержит.
+ */
+typedef struct AiCounters {
+  long long evaluations;  ///< Количество оценённых мест
+  long long probes;       ///< Поисков в таблице транспозиций
+  long long hits;         ///< Найденных в таблице записей
+} AiCounters;
+
+/**
+ * @struct Autoplayer
+ * @brief Состояние автоматического игрока.
+ *
+ * Для каждой новой фигуры выбирается лучшее достижимое место, после чего
+ * aiAction() выдаёт действия, ведущие к нему: повороты, сдвиги и
+ * мгновенное падение. Если задан пул потоков, места оцениваются
+ * параллельно. Если задана таблица транспозиций, оценки полей кешируются;
+ * при смене весов или режима просмотра вперёд таблицу нужно очистить.
+ */
+typedef struct Autoplayer {
+  AiWeights weights;   ///< Веса оценки поля
+  bool lookahead;      ///< Учитывать следующую фигуру (nextID)
+  int pieces;          ///< Номер фигуры, для которой выбрано место
+  Placement target;    ///< Выбранное место текущей фигуры
+  AiCounters counters; ///< Счётчики оценок и таблицы транспозиций
+  struct SearchPool *pool;  ///< Пул потоков для поиска или NULL (search.h)
+  struct TransTable *table;  ///< Кеш оценок полей или NULL (table.h)
+} Autoplayer;
+
+void initAutoplayer(Autoplayer *ai, bool lookahead);
+double evaluateField(const Field *field, int lines, const AiWeights *weights);
+int findPlacements(const Field *field, const Figure *figure,
+                   Placement *placements);
+int placeFigure(const Field *field, const Figure *figure, Field *result);
+double scorePlacement(const Autoplayer *ai, const Field *field,
+                      const Figure *placed, int nextID,
+                      AiCounters *counters);
+Placement bestPlacement(Autoplayer *ai, const Game *game);
+Placement choosePlacement(const Figure *figure, const Placement *placements,
+                          int count);
+int planActions(const Figure *figure, const Placement *target,
+                UserAction *actions);
+UserAction aiAction(Autoplayer *ai, const Game *game);
+
+#endif
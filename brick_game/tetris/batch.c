@@ -0,0 +1,504 @@
+/**
+ * @file batch.c
+ * @brief Пакетный шаг многих игр в одном вызове.
+ *
+ * stepBatch() продвигает все игры набора на один тик по тем же правилам,
+ * что и stepGame(). Частые случаи - шаг фигуры вниз по таймеру, сдвиги,
+ * поворот и пустое действие - выполняются проходами по блокам из
+ * BATCH_BLOCK игр: поля, которые читают проходы, одной ширины (32 бита),
+ * в телах циклов нет ветвлений (условия объединяются побитовыми `&` и `|`)
+ * и косвенных обращений, а число итераций известно при компиляции, поэтому
+ * компилятор векторизует их уже при -O2. Столкновения проверяются ядрами
+ * collideBatch() (simd.c).
+ *
+ * Фиксация фигуры по таймеру выполняется над строками набора: форма
+ * добавляется в `rows`, заполненные строки находятся ядром
+ * fullRowsBatchRange() только для зафиксировавших фигуру игр и удаляются
+ * сдвигом строк. Самые
+ * редкие случаи - мгновенное падение, пауза, начало и конец игры -
+ * выполняются для отдельной игры самой stepGame() над снимком её
+ * состояния.
+ */
+
+#include "batch.h"
+
+#include <string.h>
+
+#include "figures.h"
+#include "profile.h"
+
+#define BATCH_ALIGN 64 /*!< Выравнивание массивов набора в байтах */
+
+#if defined(__GNUC__) && !defined(__clang__)
+#define BATCH_IVDEP \
+  _Pragma("GCC ivdep") /*!< Итерации следующего цикла независимы */
+#else
+#define BATCH_IVDEP /*!< Итерации следующего цикла независимы */
+#endif
+
+/**
+ * @brief Округляет размер массива вверх до BATCH_ALIGN.
+ * @param size Размер в байтах.
+ * @return Округлённый размер.
+ */
+static size_t alignBatch(size_t size) {
+  return (size + BATCH_ALIGN - 1) & ~(size_t)(BATCH_ALIGN - 1);
+}
+
+/**
+ * @brief Размещает массивы набора в блоке памяти.
+ *
+ * При `base == 0` только вычисляет размер блока; указатели набора при этом
+ * не используются и перезаписываются следующим вызовом.
+ *
+ * @param batch Указатель на набор с заполненным `count`.
+ * @param base Адрес блока, выровненный на BATCH_ALIGN.
+ * @return Размер блока в байтах.
+ */
+static size_t layoutBatch(GameBatch *batch, uintptr_t base) {
+  size_t count = (size_t)batch->lanes;
+  size_t offset = 0;
+#define BATCH_ARRAY(member)                 \
+  (batch->member = (void *)(base + offset), \
+   offset += alignBatch(count * sizeof(*batch->member)))
+  BATCH_ARRAY(rows);
+  BATCH_ARRAY(x);
+  BATCH_ARRAY(y);
+  BATCH_ARRAY(id);
+  BATCH_ARRAY(rotation);
+  BATCH_ARRAY(nextID);
+  BATCH_ARRAY(state);
+  BATCH_ARRAY(pause);
+  BATCH_ARRAY(action);
+  BATCH_ARRAY(score);
+  BATCH_ARRAY(highScore);
+  BATCH_ARRAY(level);
+  BATCH_ARRAY(ticks);
+  BATCH_ARRAY(ticksLeft);
+  BATCH_ARRAY(pieces);
+  BATCH_ARRAY(random);
+  BATCH_ARRAY(seed);
+  BATCH_ARRAY(useBag);
+  BATCH_ARRAY(bagLeft);
+  BATCH_ARRAY(bag);
+  BATCH_ARRAY(cx);
+  BATCH_ARRAY(cy);
+  BATCH_ARRAY(crotation);
+  BATCH_ARRAY(hit);
+  BATCH_ARRAY(slow);
+  BATCH_ARRAY(due);
+  BATCH_ARRAY(full);
+#undef BATCH_ARRAY
+  return offset;
+}
+
+/**
+ * @brief Создаёт набор игр в начальном состоянии.
+ *
+ * Игра с номером `i` получает начальное значение генератора
+ * `config->seed + i`; в остальном игры совпадают с игрой из
+ * initGameWith(config). Игры, дополняющие набор до `lanes`, стоят в
+ * GameOver с пустым действием.
+ *
+ * @param count Количество игр (не меньше 1).
+ * @param config Параметры игр, NULL - параметры по умолчанию.
+ * @return Указатель на набор или NULL, если не удалось выделить память.
+ */
+GameBatch *createBatch(int count, const GameConfig *config) {
+  GameConfig defaults = {HIGH_SCORE_FILE, (uint64_t)time(NULL), false};
+  if (!config) config = &defaults;
+  if (count < 1) count = 1;
+
+  GameBatch *batch = (GameBatch *)malloc(sizeof(GameBatch));
+  void *block = NULL;
+  if (batch) {
+    batch->count = count;
+    batch->lanes = (count + BATCH_BLOCK - 1) / BATCH_BLOCK * BATCH_BLOCK;
+    block = aligned_alloc(BATCH_ALIGN, layoutBatch(batch, 0));
+    if (!block) {
+      free(batch);
+      batch = NULL;
+    }
+  }
+
+  if (batch) {
+    memset(block, 0, layoutBatch(batch, (uintptr_t)block));
+    for (int id = 0; id < FIGURES_COUNT; id++)
+      for (int r = 0; r < ROTATIONS_COUNT; r++) {
+        const FigureShape *shape = &figureShapes[id][r];
+        BatchShape *packed = &batch->shapes[id][r];
+        packed->rows = 0;
+        for (int i = 0; i < FIGURE_HEIGHT - 1; i++)
+          packed->rows |= (uint64_t)shape->rows[i] << (16 * i);
+        packed->last = shape->rows[FIGURE_HEIGHT - 1];
+        packed->left = shape->left;
+        packed->right = shape->right;
+      }
+    int highScore =
+        config->highScorePath ? loadHighScoreFrom(config->highScorePath) : 0;
+    for (int i = 0; i < batch->lanes; i++) {
+      GameSnapshot snapshot = {0};
+      Game game = snapshotView(&snapshot, NULL);
+      seedRandom(&snapshot.gameInfo.random, config->seed + i);
+      snapshot.gameInfo.seed = config->seed + i;
+      snapshot.gameInfo.useBag = config->useBag;
+      snapshot.gameInfo.high_score = highScore;
+      resetGame(&game);
+      if (i >= count) {
+        snapshot.gameInfo.state = GameOver;
+        snapshot.player.action = ACTION;
+      }
+      restoreBatchGame(batch, i, &snapshot);
+    }
+  }
+  return batch;
+}
+
+/**
+ * @brief Освобождает набор игр.
+ * @param batch Указатель на набор или NULL.
+ */
+void freeBatch(GameBatch *batch) {
+  if (batch) {
+    free(batch->rows);
+    free(batch);
+  }
+}
+
+/**
+ * @brief Выбирает значение без ветвления.
+ * @param take Условие: 0 или 1.
+ * @param a Значение при `take == 1`.
+ * @param b Значение при `take == 0`.
+ * @return `take ? a : b`.
+ */
+static inline int32_t pickLane(int32_t take, int32_t a, int32_t b) {
+  return b ^ ((a ^ b) & -take);
+}
+
+/**
+ * @brief Выбирает следующую фигуру игры набора, как randomFigure().
+ * @param batch Указатель на набор.
+ * @param b Номер игры.
+ * @return Идентификатор фигуры.
+ */
+static int nextBatchFigure(GameBatch *batch, int b) {
+  GameInfo info;
+  info.random.state = batch->random[b];
+  info.random.inc = batch->inc;
+  info.useBag = batch->useBag[b];
+  info.bagLeft = batch->bagLeft[b];
+  memcpy(info.bag, batch->bag[b], sizeof(info.bag));
+  int id = randomFigure(&info);
+  batch->random[b] = info.random.state;
+  batch->bagLeft[b] = (int8_t)info.bagLeft;
+  memcpy(batch->bag[b], info.bag, sizeof(info.bag));
+  return id;
+}
+
+/**
+ * @brief Добавляет фигуру игры набора в строки её поля.
+ *
+ * Форма сдвигается так же, как в проверке столкновений (simd.c); биты за
+ * стенами отбрасываются маской FIELD_FULL_ROW, а строки рамки остаются
+ * заполненными.
+ *
+ * @param batch Указатель на набор.
+ * @param b Номер игры.
+ */
+static void plantBatchShape(GameBatch *batch, int b) {
+  const BatchShape *shape = &batch->shapes[batch->id[b]][batch->rotation[b]];
+  int x = batch->x[b];
+  uint64_t form = x >= 0 ? shape->rows << x : shape->rows >> -x;
+  uint32_t last =
+      x >= 0 ? (uint32_t)shape->last << x : (uint32_t)shape->last >> -x;
+  uint16_t *rows = &batch->rows[b][BATCH_TOP + batch->y[b]];
+  for (int i = 0; i < FIGURE_HEIGHT - 1; i++)
+    rows[i] |= (uint16_t)(form >> (16 * i)) & FIELD_FULL_ROW;
+  rows[FIGURE_HEIGHT - 1] |= (uint16_t)last & FIELD_FULL_ROW;
+}
+
+/**
+ * @brief Удаляет заполненные строки поля игры набора.
+ * @param batch Указатель на набор.
+ * @param b Номер игры.
+ * @param full Маска заполненных строк (см. fullRowsBatch()).
+ * @return Количество удалённых строк.
+ */
+static int clearBatchRows(GameBatch *batch, int b, uint32_t full) {
+  uint16_t *rows = &batch->rows[b][BATCH_TOP];
+  int to = 31 - __builtin_clz(full);
+  for (int from = to; from >= 0; from--)
+    if (!((full >> from) & 1)) rows[to--] = rows[from];
+  while (to >= 0) rows[to--] = 0;
+  return __builtin_popcount(full);
+}
+
+/**
+ * @brief Проверяет, сталкивается ли только что появившаяся фигура игры.
+ *
+ * Фигура стоит в начальном положении spawnFigure() (поворот 0, `y` равно
+ * 0) целиком между стенами, поэтому достаточно сравнить строки.
+ *
+ * @param batch Указатель на набор.
+ * @param b Номер игры.
+ * @return true, если фигура сталкивается с блоками поля.
+ */
+static bool spawnCollides(const GameBatch *batch, int b) {
+  const BatchShape *shape = &batch->shapes[batch->id[b]][0];
+  const uint16_t *rows = &batch->rows[b][BATCH_TOP];
+  int x = batch->x[b];
+  uint64_t window = (uint64_t)rows[0] | (uint64_t)rows[1] << 16 |
+                    (uint64_t)rows[2] << 32 | (uint64_t)rows[3] << 48;
+  return ((shape->rows << x) & window) != 0 ||
+         (((uint32_t)shape->last << x) & rows[FIGURE_HEIGHT - 1]) != 0;
+}
+
+/**
+ * @brief Фиксирует фигуру игры набора, как lockFigure().
+ *
+ * Фигура добавляется в строки поля, заполненные строки находятся
+ * fullRowsBatchRange() и удаляются, очки и уровень считаются как в
+ * countScore(). Затем появляется следующая фигура; если она сталкивается с
+ * полем, игра заканчивается.
+ *
+ * @param batch Указатель на набор.
+ * @param b Номер игры.
+ */
+static void lockBatchGame(GameBatch *batch, int b) {
+  static const int points[] = {0, 100, 300, 700, 1500};
+  PROFILE_COUNT(CounterLocks, 1);
+  plantBatchShape(batch, b);
+  fullRowsBatchRange(batch, batch->full, b, b + 1);
+  int lines = batch->full[b] ? clearBatchRows(batch, b, batch->full[b]) : 0;
+  PROFILE_COUNT(CounterLines, lines);
+  batch->score[b] += points[lines];
+  if (batch->score[b] > batch->highScore[b])
+    batch->highScore[b] = batch->score[b];
+  int level = batch->score[b] / 600 + 1;
+  if (level > batch->level[b] && level <= LEVELS_COUNT) {
+    batch->level[b] = level;
+    batch->ticks[b] = levelTicks(level);
+  }
+
+  batch->x[b] = FIELD_WIDTH / 2 - FIGURE_WIDTH / 2;
+  batch->y[b] = 0;
+  batch->id[b] = batch->nextID[b];
+  batch->rotation[b] = 0;
+  batch->nextID[b] = (int8_t)nextBatchFigure(batch, b);
+  batch->pieces[b]++;
+  PROFILE_COUNT(CounterSpawns, 1);
+  batch->state[b] = spawnCollides(batch, b) ? GameOver : Spawn;
+}
+
+/**
+ * @brief Выполняет шаг вниз по таймеру в играх, отмеченных в `due`.
+ *
+ * Проверяемым положением таких игр было положение на строку ниже. Если оно
+ * свободно, фигура опускается, иначе фиксируется (lockBatchGame()). После
+ * этого, как в calculate(), из действия игрока выбирается положение для
+ * сдвига или поворота, и оно проверяется для одной игры
+ * collideBatchRange().
+ *
+ * @param batch Указатель на набор.
+ */
+static void fallBatch(GameBatch *batch) {
+  for (int b = 0; b < batch->count; b++) {
+    if (!batch->due[b]) continue;
+    batch->ticksLeft[b] = batch->ticks[b];
+    if (batch->hit[b]) {
+      lockBatchGame(batch, b);
+    } else {
+      batch->y[b]++;
+      batch->state[b] = Moving;
+    }
+    if (batch->state[b] != GameOver) {
+      int act = batch->action[b];
+      batch->cx[b] = batch->x[b] + (act == RIGHT) - (act == LEFT);
+      batch->cy[b] = batch->y[b] + (act == DOWN);
+      batch->crotation[b] =
+          (batch->rotation[b] + (act == ROTATE)) % ROTATIONS_COUNT;
+      collideBatchRange(batch, b, b + 1);
+    }
+  }
+}
+
+/**
+ * @brief Выполняет тик одной игры набора функцией stepGame().
+ * @param batch Указатель на набор.
+ * @param index Номер игры.
+ * @param action Действие игрока.
+ */
+static void stepBatchGame(GameBatch *batch, int index, UserAction action) {
+  GameSnapshot snapshot;
+  snapshotBatchGame(batch, index, &snapshot);
+  Game game = snapshotView(&snapshot, NULL);
+  stepGame(&game, action);
+  restoreBatchGame(batch, index, &snapshot);
+}
+
+/**
+ * @brief Продвигает все игры набора на один тик.
+ *
+ * Результат для каждой игры совпадает с вызовом stepGame() с тем же
+ * действием. Тик выполняется так:
+ * 1. игры с действиями, меняющими состояние игры, отмечаются в `slow`,
+ *    игры, фигура которых по таймеру шагает вниз, - в `due`; первые
+ *    проверяют положение на строку ниже, остальные - положение из
+ *    действия игрока (сдвиг или поворот); все положения проверяются
+ *    одним вызовом collideBatch();
+ * 2. отмеченные в `due` игры опускают или фиксируют фигуру и проверяют
+ *    положение из действия (fallBatch());
+ * 3. игры, не отмеченные в `slow`, принимают сдвиг или поворот, если
+ *    положение свободно;
+ * 4. отмеченные в `slow` игры выполняют тик функцией stepGame().
+ *
+ * @param batch Указатель на набор.
+ * @param actions Действия игроков, по одному на игру.
+ */
+void stepBatch(GameBatch *batch, const UserAction *actions) {
+  int lanes = batch->lanes;
+  int32_t *restrict x = batch->x;
+  int32_t *restrict y = batch->y;
+  int32_t *restrict rotation = batch->rotation;
+  int32_t *restrict state = batch->state;
+  const int32_t *restrict pause = batch->pause;
+  int32_t *restrict action = batch->action;
+  int32_t *restrict ticksLeft = batch->ticksLeft;
+  int32_t *restrict cx = batch->cx;
+  int32_t *restrict cy = batch->cy;
+  int32_t *restrict crotation = batch->crotation;
+  const int32_t *restrict hit = batch->hit;
+  int32_t *restrict slow = batch->slow;
+  int32_t *restrict due = batch->due;
+
+  for (int b = 0; b < batch->count; b++) action[b] = (int32_t)actions[b];
+  int32_t falls = 0;
+  for (int from = 0; from < lanes; from += BATCH_BLOCK)
+    BATCH_IVDEP
+    for (int b = from; b < from + BATCH_BLOCK; b++) {
+      int32_t act = action[b];
+      int32_t now = state[b];
+      int32_t live = (now != GameOver) & (now != Quit);
+      int32_t simple = (act == ACTION) | ((act >= LEFT) & (act <= ROTATE));
+      int32_t idle = (now == GameOver) & (act != START);
+      int32_t timer = (ticksLeft[b] <= 0) & (now != Pause) & (now != Start);
+      int32_t step = live & simple & timer;
+
+      slow[b] = (idle ^ 1) & ((live & simple) ^ 1);
+      due[b] = step;
+      falls += step;
+      cx[b] = x[b] + pickLane(step, 0, (act == RIGHT) - (act == LEFT));
+      cy[b] = y[b] + pickLane(step, 1, act == DOWN);
+      crotation[b] = (int32_t)((uint32_t)(rotation[b] +
+                                          pickLane(step, 0, act == ROTATE)) %
+                               ROTATIONS_COUNT);
+    }
+  collideBatch(batch);
+  if (falls) fallBatch(batch);
+
+  for (int from = 0; from < lanes; from += BATCH_BLOCK)
+    BATCH_IVDEP
+    for (int b = from; b < from + BATCH_BLOCK; b++) {
+      int32_t now = state[b];
+      int32_t fast = (slow[b] ^ 1) & (now != GameOver);
+      int32_t move = fast & (pause[b] == 0) & (action[b] != ACTION);
+      int32_t blocked = (now == Collision) | hit[b];
+      int32_t commit = move & (blocked ^ 1);
+
+      state[b] = pickLane(move & blocked, Collision, now);
+      x[b] = pickLane(commit, cx[b], x[b]);
+      y[b] = pickLane(commit, cy[b], y[b]);
+      rotation[b] = pickLane(commit, crotation[b], rotation[b]);
+      ticksLeft[b] -= fast;
+    }
+
+  for (int b = 0; b < batch->count; b++)
+    if (slow[b]) stepBatchGame(batch, b, actions[b]);
+}
+
+/**
+ * @brief Сохраняет состояние одной игры набора в снимок.
+ *
+ * Высоты столбцов и хеш поля вычисляются по маскам строк, маска `dirty`
+ * пуста, как у игры между вызовами stepGame().
+ *
+ * @param batch Указатель на набор.
+ * @param index Номер игры.
+ * @param snapshot Указатель на снимок.
+ */
+void snapshotBatchGame(const GameBatch *batch, int index,
+                       GameSnapshot *snapshot) {
+  GameInfo *info = &snapshot->gameInfo;
+  info->nextID = batch->nextID[index];
+  info->score = batch->score[index];
+  info->high_score = batch->highScore[index];
+  info->level = batch->level[index];
+  info->speed = batch->level[index];
+  info->pause = batch->pause[index];
+  info->ticks_left = batch->ticksLeft[index];
+  info->ticks = batch->ticks[index];
+  info->pieces = batch->pieces[index];
+  info->state = (GameState)batch->state[index];
+  info->random.state = batch->random[index];
+  info->random.inc = batch->inc;
+  info->seed = batch->seed[index];
+  info->useBag = batch->useBag[index];
+  info->bagLeft = batch->bagLeft[index];
+  memcpy(info->bag, batch->bag[index], sizeof(info->bag));
+
+  memcpy(snapshot->field.rows, &batch->rows[index][BATCH_TOP],
+         sizeof(snapshot->field.rows));
+  snapshot->field.dirty = 0;
+  updateHeights(&snapshot->field);
+  snapshot->field.hash = hashField(&snapshot->field);
+
+  snapshot->figure.x = batch->x[index];
+  snapshot->figure.y = batch->y[index];
+  snapshot->figure.id = batch->id[index];
+  snapshot->figure.rotation = batch->rotation[index];
+  snapshot->player.action = (UserAction)batch->action[index];
+}
+
+/**
+ * @brief Восстанавливает состояние одной игры набора из снимка.
+ *
+ * Снимок может быть получен и из обычной игры (snapshotGame()). Скорость
+ * игры не хранится: в логике игры она всегда равна уровню.
+ *
+ * @param batch Указатель на набор.
+ * @param index Номер игры.
+ * @param snapshot Указатель на снимок.
+ */
+void restoreBatchGame(GameBatch *batch, int index,
+                      const GameSnapshot *snapshot) {
+  const GameInfo *info = &snapshot->gameInfo;
+  batch->nextID[index] = (int8_t)info->nextID;
+  batch->score[index] = info->score;
+  batch->highScore[index] = info->high_score;
+  batch->level[index] = info->level;
+  batch->pause[index] = info->pause;
+  batch->ticksLeft[index] = info->ticks_left;
+  batch->ticks[index] = info->ticks;
+  batch->pieces[index] = info->pieces;
+  batch->state[index] = (int32_t)info->state;
+  batch->random[index] = info->random.state;
+  batch->inc = info->random.inc;
+  batch->seed[index] = info->seed;
+  batch->useBag[index] = info->useBag;
+  batch->bagLeft[index] = (int8_t)info->bagLeft;
+  memcpy(batch->bag[index], info->bag, sizeof(info->bag));
+
+  for (int i = 0; i < BATCH_ROWS; i++) {
+    int fy = i - BATCH_TOP;
+    batch->rows[index][i] = fy >= 0 && fy < FIELD_HEIGHT
+                                ? snapshot->field.rows[fy]
+                                : FIELD_FULL_ROW;
+  }
+
+  batch->x[index] = snapshot->figure.x;
+  batch->y[index] = snapshot->figure.y;
+  batch->id[index] = snapshot->figure.id;
+  batch->rotation[index] = snapshot->figure.rotation;
+  batch->action[index] = (int32_t)snapshot->player.action;
+}
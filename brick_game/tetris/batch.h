@@ -0,0 +1,98 @@
+#ifndef BATCH_H_
+#define BATCH_H_
+
+#include "tetris.h"
+
+#define BATCH_ROWS 32 /*!< Строк поля игры набора вместе с рамкой */
+#define BATCH_TOP 4   /*!< Строк рамки над полем */
+#define BATCH_BLOCK 64 /*!< Игр в блоке, которым идут проходы stepBatch() */
+
+/**
+ * @enum BatchIsa
+ * @brief Набор команд, которым выполняются ядра набора игр (simd.c).
+ */
+typedef enum BatchIsa {
+  IsaScalar,  ///< Скалярный код
+  IsaSse41,   ///< SSE4.1
+  IsaAvx2     ///< AVX2
+} BatchIsa;
+
+/**
+ * @struct BatchShape
+ * @brief Состояние поворота фигуры в виде для пакетной проверки
+ * столкновений.
+ */
+typedef struct BatchShape {
+  uint64_t rows;  ///< Строки 0-3 формы по 16 бит, строка 0 в младших битах
+  uint16_t last;  ///< Строка 4 формы
+  int8_t left;    ///< Первый занятый столбец
+  int8_t right;   ///< Последний занятый столбец
+} BatchShape;
+
+/**
+ * @struct GameBatch
+ * @brief Набор игр, хранящийся по столбцам (struct of arrays).
+ *
+ * Каждое поле игры - отдельный непрерывный массив, а маски строк всех
+ * полей лежат подряд по BATCH_ROWS (64 байта) на игру: строка `i` поля
+ * хранится в `rows[игра][BATCH_TOP + i]`, строки рамки над и под полем
+ * заполнены, поэтому проверка столкновения читает строки без проверок
+ * границ. Поля, которые читает и пишет каждый тик stepBatch(), имеют
+ * одинаковую ширину 32 бита. Массивы рассчитаны на `lanes` игр (`count`,
+ * округлённое вверх до BATCH_BLOCK); лишние игры стоят в GameOver и в
+ * тиках не участвуют. Все массивы размещены в одном блоке памяти и
+ * выровнены на 64 байта. Состояние одной игры переносится в GameSnapshot и
+ * обратно функциями snapshotBatchGame() и restoreBatchGame().
+ */
+typedef struct GameBatch {
+  int count;                     ///< Количество игр
+  int lanes;                     ///< Размер массивов, кратный BATCH_BLOCK
+  uint16_t (*rows)[BATCH_ROWS];  ///< Маски строк полей с рамкой
+  int32_t *x;                      ///< Координаты фигур по горизонтали
+  int32_t *y;                      ///< Координаты фигур по вертикали
+  int32_t *id;                     ///< Идентификаторы фигур
+  int32_t *rotation;               ///< Состояния поворота фигур
+  int8_t *nextID;                  ///< Идентификаторы следующих фигур
+  int32_t *state;                  ///< Состояния игр (GameState)
+  int32_t *pause;                  ///< Флаги паузы
+  int32_t *action;                 ///< Последние действия игроков
+  int32_t *score;                  ///< Счёт
+  int32_t *highScore;              ///< Рекордный счёт
+  int32_t *level;                  ///< Уровни (совпадают со скоростью)
+  int32_t *ticks;                  ///< Тиков между шагами фигуры вниз
+  int32_t *ticksLeft;              ///< Остаток тиков до шага вниз
+  int32_t *pieces;                 ///< Количество появившихся фигур
+  uint64_t *random;                ///< Состояния генераторов PCG32
+  uint64_t inc;                    ///< Приращение генераторов (общее)
+  uint64_t *seed;                  ///< Начальные значения генераторов
+  bool *useBag;                    ///< Генераторы "мешок из 7 фигур"
+  int8_t *bagLeft;                 ///< Фигур, оставшихся в мешке
+  uint8_t (*bag)[FIGURES_COUNT];   ///< Оставшиеся фигуры мешков
+  int32_t *cx;                     ///< Проверяемые координаты по горизонтали
+  int32_t *cy;                     ///< Проверяемые координаты по вертикали
+  int32_t *crotation;              ///< Проверяемые состояния поворота
+  int32_t *hit;                    ///< Результаты проверки столкновений
+  int32_t *slow;                   ///< Игры, шаг которых выполняет stepGame()
+  int32_t *due;                    ///< Игры, фигура которых шагает вниз
+  uint32_t *full;                  ///< Маски заполненных строк полей
+  BatchShape shapes[FIGURES_COUNT][ROTATIONS_COUNT];  ///< Формы фигур
+} GameBatch;
+
+GameBatch *createBatch(int count, const GameConfig *config);
+void freeBatch(GameBatch *batch);
+void stepBatch(GameBatch *batch, const UserAction *actions);
+void collideBatch(GameBatch *batch);
+void collideBatchRange(GameBatch *batch, int from, int to);
+void fullRowsBatch(const GameBatch *batch, uint32_t *full);
+void fullRowsBatchRange(const GameBatch *batch, uint32_t *full, int from,
+                        int to);
+BatchIsa supportedBatchIsa(void);
+BatchIsa batchIsa(void);
+BatchIsa setBatchIsa(BatchIsa isa);
+const char *batchIsaName(BatchIsa isa);
+void snapshotBatchGame(const GameBatch *batch, int index,
+                       GameSnapshot *snapshot);
+void restoreBatchGame(GameBatch *batch, int index,
+                      const GameSnapshot *snapshot);
+
+#endif
@@ -0,0 +1,145 @@
+/**
+ * @file brickgame.c
+ * @brief Реализация встраиваемого C API (brickgame.h).
+ *
+ * Игра API хранит своё состояние одним снимком GameSnapshot; для каждого
+ * вызова над снимком строится Game, указатели которой ссылаются на части
+ * снимка (логика игры не обращается к шаблонам фигур). Поэтому игра - один
+ * блок памяти, копируется присваиванием и не ссылается на глобальные
+ * данные, кроме неизменяемых таблиц форм фигур.
+ */
+
+#include "brickgame.h"
+
+#include "tetris.h"
+
+_Static_assert(BRICKGAME_WIDTH == FIELD_WIDTH &&
+                   BRICKGAME_HEIGHT == FIELD_HEIGHT &&
+                   BRICKGAME_FIGURE == FIGURE_HEIGHT,
+               "brickgame.h field size must match tetris.h");
+_Static_assert((int)BRICK_START == START && (int)BRICK_PAUSE == PAUSE &&
+                   (int)BRICK_TERMINATE == TERMINATE &&
+                   (int)BRICK_LEFT == LEFT && (int)BRICK_RIGHT == RIGHT &&
+                   (int)BRICK_DOWN == DOWN && (int)BRICK_ROTATE == ROTATE &&
+                   (int)BRICK_NONE == ACTION &&
+                   (int)BRICK_HARD_DROP == HARD_DROP,
+               "BrickAction must match UserAction");
+_Static_assert((int)BRICK_STATE_START == Start &&
+                   (int)BRICK_STATE_PAUSE == Pause &&
+                   (int)BRICK_STATE_SPAWN == Spawn &&
+                   (int)BRICK_STATE_MOVING == Moving &&
+                   (int)BRICK_STATE_COLLISION == Collision &&
+                   (int)BRICK_STATE_GAME_OVER == GameOver &&
+                   (int)BRICK_STATE_QUIT == Quit,
+               "BrickState must match GameState");
+
+/**
+ * @struct BrickGame
+ * @brief Игра API.
+ */
+struct BrickGame {
+  GameSnapshot state;  ///< Состояние игры
+};
+
+/**
+ * @brief Возвращает версию API библиотеки.
+ * @return BRICKGAME_API_VERSION, с которой собрана библиотека.
+ */
+int brickGameVersion(void) { return BRICKGAME_API_VERSION; }
+
+/**
+ * @brief Создаёт игру в состоянии ожидания начала (BRICK_STATE_START).
+ * @param config Параметры игры, NULL - начальное значение генератора по
+ * текущему времени, равновероятный генератор и нулевой рекорд.
+ * @return Указатель на игру или NULL, если не удалось выделить память.
+ */
+BrickGame *brickGameCreate(const BrickGameConfig *config) {
+  BrickGameConfig defaults = {(uint64_t)time(NULL), 0, 0};
+  if (!config) config = &defaults;
+
+  BrickGame *game = (BrickGame *)calloc(1, sizeof(BrickGame));
+  if (game) {
+    GameInfo *info = &game->state.gameInfo;
+    seedRandom(&info->random, config->seed);
+    info->seed = config->seed;
+    info->useBag = config->useBag != 0;
+    info->high_score = config->highScore;
+    brickGameReset(game);
+  }
+  return game;
+}
+
+/**
+ * @brief Создаёт независимую копию игры.
+ *
+ * При одинаковых действиях копия и исходная игра развиваются одинаково.
+ *
+ * @param game Указатель на игру.
+ * @return Указатель на копию или NULL, если не удалось выделить память.
+ */
+BrickGame *brickGameClone(const BrickGame *game) {
+  BrickGame *clone = (BrickGame *)malloc(sizeof(BrickGame));
+  if (clone) *clone = *game;
+  return clone;
+}
+
+/**
+ * @brief Возвращает игру в состояние ожидания начала.
+ *
+ * Рекорд сохраняется, генератор фигур продолжает свою последовательность.
+ *
+ * @param game Указатель на игру.
+ */
+void brickGameReset(BrickGame *game) {
+  Game view = snapshotView(&game->state, NULL);
+  resetGame(&view);
+}
+
+/**
+ * @brief Выполняет один тик игры.
+ *
+ * Тик совпадает с тиком игры в терминале (stepGame()). Рекорд
+ * обновляется в памяти; сохранять его между запусками должен вызывающий.
+ *
+ * @param game Указатель на игру.
+ * @param action Действие игрока на этом тике.
+ * @return Состояние игры после тика.
+ */
+BrickState brickGameStep(BrickGame *game, BrickAction action) {
+  Game view = snapshotView(&game->state, NULL);
+  stepGame(&view, (UserAction)action);
+  return (BrickState)game->state.gameInfo.state;
+}
+
+/**
+ * @brief Заполняет наблюдаемое состояние игры.
+ * @param game Указатель на игру.
+ * @param observation Указатель на заполняемое состояние.
+ */
+void brickGameObserve(const BrickGame *game, BrickObservation *observation) {
+  const GameInfo *info = &game->state.gameInfo;
+  const Figure *figure = &game->state.figure;
+  const FigureShape *shape = getFigureShape(figure);
+
+  for (int i = 0; i < FIELD_HEIGHT; i++)
+    observation->rows[i] = game->state.field.rows[i];
+  for (int i = 0; i < FIGURE_HEIGHT; i++)
+    observation->figureRows[i] = shape->rows[i];
+  observation->figureX = figure->x;
+  observation->figureY = figure->y;
+  observation->figureId = figure->id;
+  observation->figureRotation = figure->rotation;
+  observation->nextId = info->nextID;
+  observation->score = info->score;
+  observation->highScore = info->high_score;
+  observation->level = info->level;
+  observation->pieces = info->pieces;
+  observation->paused = info->pause;
+  observation->state = (BrickState)info->state;
+}
+
+/**
+ * @brief Освобождает игру.
+ * @param game Указатель на игру или NULL.
+ */
+void brickGameDestroy(BrickGame *game) { free(game); }
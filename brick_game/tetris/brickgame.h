@@ -0,0 +1,120 @@
+#ifndef BRICKGAME_H_
+#define BRICKGAME_H_
+
+/**
+ * @file brickgame.h
+ * @brief Встраиваемый C API игры (библиотека libbrickgame).
+ *
+ * Заголовок не зависит от внутренних заголовков игры и от ncurses. Игра
+ * доступна только через непрозрачный указатель BrickGame: её создают
+ * brickGameCreate(), продвигают на тик brickGameStep(), читают
+ * brickGameObserve() и освобождают brickGameDestroy(). Библиотека не
+ * использует глобального состояния: разные игры можно вести в разных
+ * потоках, а одну игру - в одном потоке за раз.
+ *
+ * Сборка: `make lib` создаёт build/libbrickgame.a и build/libbrickgame.so.
+ * Разделяемая библиотека экспортирует только функции этого заголовка.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__GNUC__)
+#define BRICKGAME_API \
+  __attribute__((visibility("default"))) /*!< Экспортируемая функция */
+#else
+#define BRICKGAME_API /*!< Экспортируемая функция */
+#endif
+
+#define BRICKGAME_API_VERSION 1 /*!< Версия API этого заголовка */
+#define BRICKGAME_WIDTH 10      /*!< Ширина игрового поля */
+#define BRICKGAME_HEIGHT 20     /*!< Высота игрового поля */
+#define BRICKGAME_FIGURE 5      /*!< Размер матрицы фигуры */
+
+/**
+ * @brief Игра, доступная только через функции API.
+ */
+typedef struct BrickGame BrickGame;
+
+/**
+ * @enum BrickAction
+ * @brief Действие игрока на тике. Значения не меняются между версиями API.
+ */
+typedef enum BrickAction {
+  BRICK_START = 0,      ///< Начало игры или новая игра после её окончания
+  BRICK_PAUSE = 1,      ///< Пауза и продолжение
+  BRICK_TERMINATE = 2,  ///< Выход из игры
+  BRICK_LEFT = 3,       ///< Сдвиг фигуры влево
+  BRICK_RIGHT = 4,      ///< Сдвиг фигуры вправо
+  BRICK_DOWN = 5,       ///< Сдвиг фигуры вниз
+  BRICK_ROTATE = 6,     ///< Поворот фигуры
+  BRICK_NONE = 7,       ///< Нет действия
+  BRICK_HARD_DROP = 8   ///< Мгновенное падение и фиксация фигуры
+} BrickAction;
+
+/**
+ * @enum BrickState
+ * @brief Состояние игры. Значения не меняются между версиями API.
+ */
+typedef enum BrickState {
+  BRICK_STATE_START = 0,      ///< Игра ждёт начала
+  BRICK_STATE_PAUSE = 1,      ///< Игра приостановлена
+  BRICK_STATE_SPAWN = 2,      ///< Появляется следующая фигура
+  BRICK_STATE_MOVING = 3,     ///< Фигура движется
+  BRICK_STATE_COLLISION = 4,  ///< Фигура упёрлась и будет зафиксирована
+  BRICK_STATE_GAME_OVER = 5,  ///< Игра окончена
+  BRICK_STATE_QUIT = 6        ///< Игрок вышел из игры
+} BrickState;
+
+/**
+ * @struct BrickGameConfig
+ * @brief Параметры создания игры.
+ */
+typedef struct BrickGameConfig {
+  uint64_t seed;  ///< Начальное значение генератора фигур
+  int useBag;     ///< Не 0 - генератор "мешок из 7 фигур"
+  int highScore;  ///< Начальный рекорд (библиотека не читает файлов)
+} BrickGameConfig;
+
+/**
+ * @struct BrickObservation
+ * @brief Наблюдаемое состояние игры.
+ *
+ * Бит `j` строки `rows[i]` - клетка поля в строке `i` (сверху вниз) и
+ * столбце `j`; текущая фигура в `rows` не входит. Бит `j` строки
+ * `figureRows[i]` - клетка матрицы фигуры, которая на поле находится в
+ * строке `figureY + i` и столбце `figureX + j`.
+ */
+typedef struct BrickObservation {
+  uint16_t rows[BRICKGAME_HEIGHT];         ///< Зафиксированные блоки поля
+  uint8_t figureRows[BRICKGAME_FIGURE];    ///< Матрица текущей фигуры
+  int figureX;                             ///< Столбец матрицы фигуры
+  int figureY;                             ///< Строка матрицы фигуры
+  int figureId;                            ///< Идентификатор фигуры (0-6)
+  int figureRotation;                      ///< Состояние поворота (0-3)
+  int nextId;                              ///< Идентификатор следующей фигуры
+  int score;                               ///< Счёт
+  int highScore;                           ///< Рекорд
+  int level;                               ///< Уровень
+  int pieces;                              ///< Количество появившихся фигур
+  int paused;                              ///< Не 0 - игра на паузе
+  BrickState state;                        ///< Состояние игры
+} BrickObservation;
+
+BRICKGAME_API int brickGameVersion(void);
+BRICKGAME_API BrickGame *brickGameCreate(const BrickGameConfig *config);
+BRICKGAME_API BrickGame *brickGameClone(const BrickGame *game);
+BRICKGAME_API void brickGameReset(BrickGame *game);
+BRICKGAME_API BrickState brickGameStep(BrickGame *game, BrickAction action);
+BRICKGAME_API void brickGameObserve(const BrickGame *game,
+                                    BrickObservation *observation);
+BRICKGAME_API void brickGameDestroy(BrickGame *game);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,174 @@
+/**
+ * @file eval.c
+ * @brief Признаки поля для эвристической оценки позиции.
+ *
+ * fieldFeatures() считает все признаки за один проход по 20 маскам строк:
+ * каждый признак строки - несколько сдвигов, логических операций и
+ * __builtin_popcount() над 10-битной маской вместо перебора клеток.
+ * fieldFeaturesScalar() считает те же признаки по клеткам через getBlock()
+ * и служит эталоном для тестов.
+ *
+ * Колодец - пустая клетка, открытая сверху, оба соседа которой по строке
+ * заняты (или являются стеной). Клетка на глубине d колодца добавляет к
+ * признаку wells величину d, так что колодец глубины d даёт d(d+1)/2.
+ */
+
+#include "eval.h"
+
+#define EVAL_DEPTH_BITS \
+  5 /*!< Разрядов счётчика глубины колодца (2^5 > FIELD_HEIGHT) */
+#define EVAL_LANE(mask, lane) \
+  ((uint64_t)(mask) << (16 * (lane))) /*!< Маска в 16-битной дорожке */
+
+/**
+ * @brief Считает единичные биты в каждом байте слова (SWAR).
+ *
+ * Байт содержит не больше 8 единиц, поэтому суммы байтов по всем строкам
+ * поля (не больше 8 * FIELD_HEIGHT) тоже умещаются в байт.
+ *
+ * @param x Слово из четырёх 16-битных масок.
+ * @return Количества единиц по байтам.
+ */
+static uint64_t byteCounts(uint64_t x) {
+  x -= (x >> 1) & 0x5555555555555555ULL;
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  return (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+}
+
+/**
+ * @brief Возвращает сумму одной 16-битной дорожки из сумм по байтам.
+ * @param counts Суммы по байтам (см. byteCounts()).
+ * @param lane Номер дорожки от 0 до 3.
+ * @return Сумма дорожки.
+ */
+static int laneSum(uint64_t counts, int lane) {
+  counts = (counts + (counts >> 8)) & 0x00FF00FF00FF00FFULL;
+  return (int)((counts >> (16 * lane)) & 0xFFFF);
+}
+
+/**
+ * @brief Считает признаки поля по маскам строк.
+ *
+ * Строки просматриваются сверху вниз. Для каждой строки строятся маски
+ * клеток, дающих вклад в признаки: дыр, смен занятости по строке и столбцу,
+ * перепадов высот. Маска `covered` - столбцы, в которых выше или в текущей
+ * строке уже есть блок, поэтому сумма её битов по всем строкам даёт сумму
+ * высот, а различия соседних битов - сумму перепадов. Глубины колодцев всех
+ * столбцов хранятся в разрядных срезах `depth`: k-й срез содержит k-й
+ * разряд глубины каждого столбца.
+ *
+ * Маски складываются по четыре в 16-битные дорожки 64-битного слова, и
+ * единицы всех четырёх считаются одним SWAR-подсчётом, поэтому строка
+ * обходится без перебора клеток и без вызовов popcount на каждую маску.
+ *
+ * @param field Указатель на игровое поле.
+ * @return Признаки поля.
+ */
+FieldFeatures fieldFeatures(const Field *field) {
+  FieldFeatures features = {0, 0, 0, 0, 0, 0, 0};
+  uint16_t depth[EVAL_DEPTH_BITS] = {0};
+  uint16_t covered = 0;
+  uint16_t above = 0;
+  uint64_t shape = 0;
+  uint64_t slices = 0;
+  uint64_t deep = 0;
+
+  for (int i = 0; i < FIELD_HEIGHT; i++) {
+    uint16_t row = field->rows[i];
+    uint16_t empty = (uint16_t)~row & FIELD_FULL_ROW;
+    uint32_t walled = (uint32_t)row << 1 | 1u | 1u << (FIELD_WIDTH + 1);
+    uint16_t well = empty & (uint16_t)~covered & (uint16_t)(row << 1 | 1) &
+                    (uint16_t)(row >> 1 | 1u << (FIELD_WIDTH - 1));
+    uint16_t carry = well;
+    for (int k = 0; k < EVAL_DEPTH_BITS; k++) {
+      uint16_t bit = depth[k] & well;
+      depth[k] = bit ^ carry;
+      carry &= bit;
+    }
+    uint16_t holes = covered & empty;
+
+    covered |= row;
+    if (!features.maxHeight && covered) features.maxHeight = FIELD_HEIGHT - i;
+    shape += byteCounts(
+        EVAL_LANE(holes, 0) |
+        EVAL_LANE((walled ^ (walled >> 1)) & ((1u << (FIELD_WIDTH + 1)) - 1),
+                  1) |
+        EVAL_LANE(above ^ row, 2) |
+        EVAL_LANE((covered ^ (covered >> 1)) & (FIELD_FULL_ROW >> 1), 3));
+    slices += byteCounts(EVAL_LANE(covered, 0) | EVAL_LANE(depth[0], 1) |
+                         EVAL_LANE(depth[1], 2) | EVAL_LANE(depth[2], 3));
+    if (depth[3] | depth[4])
+      deep += byteCounts(EVAL_LANE(depth[3], 0) | EVAL_LANE(depth[4], 1));
+    above = row;
+  }
+
+  features.holes = laneSum(shape, 0);
+  features.rowTransitions = laneSum(shape, 1);
+  features.columnTransitions =
+      laneSum(shape, 2) + __builtin_popcount(above ^ FIELD_FULL_ROW);
+  features.bumpiness = laneSum(shape, 3);
+  features.height = laneSum(slices, 0);
+  features.wells = laneSum(slices, 1) + 2 * laneSum(slices, 2) +
+                   4 * laneSum(slices, 3) + 8 * laneSum(deep, 0) +
+                   16 * laneSum(deep, 1);
+  return features;
+}
+
+/**
+ * @brief Возвращает состояние клетки с учётом границ поля.
+ * @param field Указатель на игровое поле.
+ * @param y Номер строки.
+ * @param x Номер столбца.
+ * @return 1 для занятой клетки, стены и дна, 0 для пустой клетки и клеток
+ * над полем.
+ */
+static int cellAt(const Field *field, int y, int x) {
+  int cell = 1;
+  if (y < 0)
+    cell = 0;
+  else if (x >= 0 && x < FIELD_WIDTH && y < FIELD_HEIGHT)
+    cell = getBlock(field, y, x);
+  return cell;
+}
+
+/**
+ * @brief Считает признаки поля по клеткам.
+ *
+ * Эталонная реализация fieldFeatures() без битовых приёмов.
+ *
+ * @param field Указатель на игровое поле.
+ * @return Признаки поля.
+ */
+FieldFeatures fieldFeaturesScalar(const Field *field) {
+  FieldFeatures features = {0, 0, 0, 0, 0, 0, 0};
+  int heights[FIELD_WIDTH] = {0};
+
+  for (int x = 0; x < FIELD_WIDTH; x++) {
+    bool covered = false;
+    int depth = 0;
+    for (int y = 0; y < FIELD_HEIGHT; y++) {
+      int cell = cellAt(field, y, x);
+      if (cellAt(field, y - 1, x) != cell) features.columnTransitions++;
+      if (cell && !covered) heights[x] = FIELD_HEIGHT - y;
+      if (!cell && covered) features.holes++;
+      if (!cell && !covered && cellAt(field, y, x - 1) &&
+          cellAt(field, y, x + 1)) {
+        depth++;
+        features.wells += depth;
+      } else {
+        depth = 0;
+      }
+      if (cell) covered = true;
+    }
+    if (!cellAt(field, FIELD_HEIGHT - 1, x)) features.columnTransitions++;
+    features.height += heights[x];
+    if (heights[x] > features.maxHeight) features.maxHeight = heights[x];
+    if (x > 0) features.bumpiness += abs(heights[x] - heights[x - 1]);
+  }
+
+  for (int y = 0; y < FIELD_HEIGHT; y++)
+    for (int x = -1; x < FIELD_WIDTH; x++)
+      if (cellAt(field, y, x) != cellAt(field, y, x + 1))
+        features.rowTransitions++;
+  return features;
+}
@@ -0,0 +1,25 @@
+#ifndef EVAL_H_
+#define EVAL_H_
+
+#include "tetris.h"
+
+/**
+ * @struct FieldFeatures
+ * @brief Признаки поля для эвристической оценки позиции.
+ *
+ * Стены и дно поля считаются заполненными клетками, верхний край - пустым.
+ */
+typedef struct FieldFeatures {
+  int height;             ///< Сумма высот столбцов
+  int maxHeight;          ///< Высота самого высокого столбца
+  int holes;              ///< Пустые клетки, над которыми в столбце есть блок
+  int rowTransitions;     ///< Смены занятости соседних клеток строк
+  int columnTransitions;  ///< Смены занятости соседних клеток столбцов
+  int wells;              ///< Сумма глубин колодцев, накопленная по клеткам
+  int bumpiness;          ///< Сумма перепадов высот соседних столбцов
+} FieldFeatures;
+
+FieldFeatures fieldFeatures(const Field *field);
+FieldFeatures fieldFeaturesScalar(const Field *field);
+
+#endif
@@ -0,0 +1,593 @@
+/**
+ * @file field.c
+ * @brief Поблочный доступ к битовому представлению игрового поля.
+ *
+ * Игровое поле хранится в виде масок строк (см. Field). Функции этого файла
+ * сохраняют привычный интерфейс "строка - столбец - блок" для интерфейса
+ * пользователя и тестов.
+ */
+
+#include "tetris.h"
+
+#define ZOBRIST_HALF (FIELD_WIDTH / 2) /*!< Столбцов в половине строки */
+
+/**
+ * @brief Вклады строк поля в хеш Зобриста `[строка][половина][маска]`.
+ *
+ * Строка делится на две половины по ZOBRIST_HALF столбцов; элемент
+ * `[y][h][m]` - XOR ключей клеток строки `y` половины `h`, занятых в маске
+ * `m`. Ключ отдельной клетки - элемент с одним установленным битом маски.
+ * Ключи клеток получены генератором SplitMix64 с начальным значением
+ * 0x5A0B1157.
+ */
+static const uint64_t zobristRows[FIELD_HEIGHT][2][1 << ZOBRIST_HALF] = {
+    {{0x0000000000000000ULL, 0x23DF402F19B1F492ULL, 0x03266266D439B9EEULL,
+      0x20F92249CD884D7CULL, 0xDDF5FA93FA0F2F53ULL, 0xFE2ABABCE3BEDBC1ULL,
+      0xDED398F52E3696BDULL, 0xFD0CD8DA3787622FULL, 0x72F28319F65D3F00ULL,
+      0x512DC336EFECCB92ULL, 0x71D4E17F226486EEULL, 0x520BA1503BD5727CULL,
+      0xAF07798A0C521053ULL, 0x8CD839A515E3E4C1ULL, 0xAC211BECD86BA9BDULL,
+      0x8FFE5BC3C1DA5D2FULL, 0x24E7FD13334B93EEULL, 0x0738BD3C2AFA677CULL,
+      0x27C19F75E7722A00ULL, 0x041EDF5AFEC3DE92ULL, 0xF9120780C944BCBDULL,
+      0xDACD47AFD0F5482FULL, 0xFA3465E61D7D0553ULL, 0xD9EB25C904CCF1C1ULL,
+      0x56157E0AC516ACEEULL, 0x75CA3E25DCA7587CULL, 0x55331C6C112F1500ULL,
+      0x76EC5C43089EE192ULL, 0x8BE084993F1983BDULL, 0xA83FC4B626A8772FULL,
+      0x88C6E6FFEB203A53ULL, 0xAB19A6D0F291CEC1ULL},
+     {0x0000000000000000ULL, 0x071E0576E72B7887ULL, 0xF77F97BDAB0D4C13ULL,
+      0xF06192CB4C263494ULL, 0x163A077D77FDD8F4ULL, 0x1124020B90D6A073ULL,
+      0xE14590C0DCF094E7ULL, 0xE65B95B63BDBEC60ULL, 0x48DF8415C62BA0BBULL,
+      0x4FC181632100D83CULL, 0xBFA013A86D26ECA8ULL, 0xB8BE16DE8A0D942FULL,
+      0x5EE58368B1D6784FULL, 0x59FB861E56FD00C8ULL, 0xA99A14D51ADB345CULL,
+      0xAE8411A3FDF04CDBULL, 0x594FBF2697F764A3ULL, 0x5E51BA5070DC1C24ULL,
+      0xAE30289B3CFA28B0ULL, 0xA92E2DEDDBD15037ULL, 0x4F75B85BE00ABC57ULL,
+      0x486BBD2D0721C4D0ULL, 0xB80A2FE64B07F044ULL, 0xBF142A90AC2C88C3ULL,
+      0x11903B3351DCC418ULL, 0x168E3E45B6F7BC9FULL, 0xE6EFAC8EFAD1880BULL,
+      0xE1F1A9F81DFAF08CULL, 0x07AA3C4E26211CECULL, 0x00B43938C10A646BULL,
+      0xF0D5ABF38D2C50FFULL, 0xF7CBAE856A072878ULL}},
+    {{0x0000000000000000ULL, 0xA0E1D87E4303870DULL, 0x7E3AC6C50AFE2BBDULL,
+      0xDEDB1EBB49FDACB0ULL, 0xD5464D9C3B04079FULL, 0x75A795E278078092ULL,
+      0xAB7C8B5931FA2C22ULL, 0x0B9D532772F9AB2FULL, 0x0162E81D27E8345FULL,
+      0xA183306364EBB352ULL, 0x7F582ED82D161FE2ULL, 0xDFB9F6A66E1598EFULL,
+      0xD424A5811CEC33C0ULL, 0x74C57DFF5FEFB4CDULL, 0xAA1E63441612187DULL,
+      0x0AFFBB3A55119F70ULL, 0xD14DFABA1ECA2317ULL, 0x71AC22C45DC9A41AULL,
+      0xAF773C7F143408AAULL, 0x0F96E40157378FA7ULL, 0x040BB72625CE2488ULL,
+      0xA4EA6F5866CDA385ULL, 0x7A3171E32F300F35ULL, 0xDAD0A99D6C338838ULL,
+      0xD02F12A739221748ULL, 0x70CECAD97A219045ULL, 0xAE15D46233DC3CF5ULL,
+      0x0EF40C1C70DFBBF8ULL, 0x05695F3B022610D7ULL, 0xA5888745412597DAULL,
+      0x7B5399FE08D83B6AULL, 0xDBB241804BDBBC67ULL},
+     {0x0000000000000000ULL, 0xCA6A27C547543C83ULL, 0xD41B096F9307F4B8ULL,
+      0x1E712EAAD453C83BULL, 0xC9171D2B703BF358ULL, 0x037D3AEE376FCFDBULL,
+      0x1D0C1444E33C07E0ULL, 0xD7663381A4683B63ULL, 0x834E049CCBE29E24ULL,
+      0x492423598CB6A2A7ULL, 0x57550DF358E56A9CULL, 0x9D3F2A361FB1561FULL,
+      0x4A5919B7BBD96D7CULL, 0x80333E72FC8D51FFULL, 0x9E4210D828DE99C4ULL,
+      0x5428371D6F8AA547ULL, 0xCD44289C51589EC4ULL, 0x072E0F59160CA247ULL,
+      0x195F21F3C25F6A7CULL, 0xD3350636850B56FFULL, 0x045335B721636D9CULL,
+      0xCE3912726637511FULL, 0xD0483CD8B2649924ULL, 0x1A221B1DF530A5A7ULL,
+      0x4E0A2C009ABA00E0ULL, 0x84600BC5DDEE3C63ULL, 0x9A11256F09BDF458ULL,
+      0x507B02AA4EE9C8DBULL, 0x871D312BEA81F3B8ULL, 0x4D7716EEADD5CF3BULL,
+      0x5306384479860700ULL, 0x996C1F813ED23B83ULL}},
+    {{0x0000000000000000ULL, 0x8B65575E43FA0A4EULL, 0x8C5B753927D52041ULL,
+      0x073E2267642F2A0FULL, 0x4A58900DA7A631ACULL, 0xC13DC753E45C3BE2ULL,
+      0xC603E534807311EDULL, 0x4D66B26AC3891BA3ULL, 0x0BB91748F0AE3396ULL,
+      0x80DC4016B35439D8ULL, 0x87E26271D77B13D7ULL, 0x0C87352F94811999ULL,
+      0x41E187455708023AULL, 0xCA84D01B14F20874ULL, 0xCDBAF27C70DD227BULL,
+      0x46DFA52233272835ULL, 0xDC26E3127DF5EA8CULL, 0x5743B44C3E0FE0C2ULL,
+      0x507D962B5A20CACDULL, 0xDB18C17519DAC083ULL, 0x967E731FDA53DB20ULL,
+      0x1D1B244199A9D16EULL, 0x1A250626FD86FB61ULL, 0x91405178BE7CF12FULL,
+      0xD79FF45A8D5BD91AULL, 0x5CFAA304CEA1D354ULL, 0x5BC48163AA8EF95BULL,
+      0xD0A1D63DE974F315ULL, 0x9DC764572AFDE8B6ULL, 0x16A233096907E2F8ULL,
+      0x119C116E0D28C8F7ULL, 0x9AF946304ED2C2B9ULL},
+     {0x0000000000000000ULL, 0x7233A75F8D74C97CULL, 0x6B352777CBC70E4CULL,
+      0x1906802846B3C730ULL, 0x7429AEC1DE0D62E6ULL, 0x061A099E5379AB9AULL,
+      0x1F1C89B615CA6CAAULL, 0x6D2F2EE998BEA5D6ULL, 0x2B543F1708695CF7ULL,
+      0x59679848851D958BULL, 0x40611860C3AE52BBULL, 0x3252BF3F4EDA9BC7ULL,
+      0x5F7D91D6D6643E11ULL, 0x2D4E36895B10F76DULL, 0x3448B6A11DA3305DULL,
+      0x467B11FE90D7F921ULL, 0xBD95AD51EF6EBB36ULL, 0xCFA60A0E621A724AULL,
+      0xD6A08A2624A9B57AULL, 0xA4932D79A9DD7C06ULL, 0xC9BC03903163D9D0ULL,
+      0xBB8FA4CFBC1710ACULL, 0xA28924E7FAA4D79CULL, 0xD0BA83B877D01EE0ULL,
+      0x96C19246E707E7C1ULL, 0xE4F235196A732EBDULL, 0xFDF4B5312CC0E98DULL,
+      0x8FC7126EA1B420F1ULL, 0xE2E83C87390A8527ULL, 0x90DB9BD8B47E4C5BULL,
+      0x89DD1BF0F2CD8B6BULL, 0xFBEEBCAF7FB94217ULL}},
+    {{0x0000000000000000ULL, 0x2E23EA3C0ED18629ULL, 0x63974ED066A451F1ULL,
+      0x4DB4A4EC6875D7D8ULL, 0xC92F9AE804B228DEULL, 0xE70C70D40A63AEF7ULL,
+      0xAAB8D4386216792FULL, 0x849B3E046CC7FF06ULL, 0xF64F4FAD8E9ED66AULL,
+      0xD86CA591804F5043ULL, 0x95D8017DE83A879BULL, 0xBBFBEB41E6EB01B2ULL,
+      0x3F60D5458A2CFEB4ULL, 0x11433F7984FD789DULL, 0x5CF79B95EC88AF45ULL,
+      0x72D471A9E259296CULL, 0xF459883ADDCBEF9BULL, 0xDA7A6206D31A69B2ULL,
+      0x97CEC6EABB6FBE6AULL, 0xB9ED2CD6B5BE3843ULL, 0x3D7612D2D979C745ULL,
+      0x1355F8EED7A8416CULL, 0x5EE15C02BFDD96B4ULL, 0x70C2B63EB10C109DULL,
+      0x0216C797535539F1ULL, 0x2C352DAB5D84BFD8ULL, 0x6181894735F16800ULL,
+      0x4FA2637B3B20EE29ULL, 0xCB395D7F57E7112FULL, 0xE51AB74359369706ULL,
+      0xA8AE13AF314340DEULL, 0x868DF9933F92C6F7ULL},
+     {0x0000000000000000ULL, 0xD885DC984ACDF1ABULL, 0x39508F3E83F344D4ULL,
+      0xE1D553A6C93EB57FULL, 0xB82DCD64A92DB31FULL, 0x60A811FCE3E042B4ULL,
+      0x817D425A2ADEF7CBULL, 0x59F89EC260130660ULL, 0x69184F41017A4EB3ULL,
+      0xB19D93D94BB7BF18ULL, 0x5048C07F82890A67ULL, 0x88CD1CE7C844FBCCULL,
+      0xD1358225A857FDACULL, 0x09B05EBDE29A0C07ULL, 0xE8650D1B2BA4B978ULL,
+      0x30E0D183616948D3ULL, 0x471BED2D2ED04C0CULL, 0x9F9E31B5641DBDA7ULL,
+      0x7E4B6213AD2308D8ULL, 0xA6CEBE8BE7EEF973ULL, 0xFF36204987FDFF13ULL,
+      0x27B3FCD1CD300EB8ULL, 0xC666AF77040EBBC7ULL, 0x1EE373EF4EC34A6CULL,
+      0x2E03A26C2FAA02BFULL, 0xF6867EF46567F314ULL, 0x17532D52AC59466BULL,
+      0xCFD6F1CAE694B7C0ULL, 0x962E6F088687B1A0ULL, 0x4EABB390CC4A400BULL,
+      0xAF7EE0360574F574ULL, 0x77FB3CAE4FB904DFULL}},
+    {{0x0000000000000000ULL, 0xD338D5BBDD6E4C5CULL, 0xA846F42A96551779ULL,
+      0x7B7E21914B3B5B25ULL, 0x78AD850EA9FC4411ULL, 0xAB9550B57492084DULL,
+      0xD0EB71243FA95368ULL, 0x03D3A49FE2C71F34ULL, 0xA3445BCF3590B5C0ULL,
+      0x707C8E74E8FEF99CULL, 0x0B02AFE5A3C5A2B9ULL, 0xD83A7A5E7EABEEE5ULL,
+      0xDBE9DEC19C6CF1D1ULL, 0x08D10B7A4102BD8DULL, 0x73AF2AEB0A39E6A8ULL,
+      0xA097FF50D757AAF4ULL, 0xC8F589126E437D0EULL, 0x1BCD5CA9B32D3152ULL,
+      0x60B37D38F8166A77ULL, 0xB38BA8832578262BULL, 0xB0580C1CC7BF391FULL,
+      0x6360D9A71AD17543ULL, 0x181EF83651EA2E66ULL, 0xCB262D8D8C84623AULL,
+      0x6BB1D2DD5BD3C8CEULL, 0xB889076686BD8492ULL, 0xC3F726F7CD86DFB7ULL,
+      0x10CFF34C10E893EBULL, 0x131C57D3F22F8CDFULL, 0xC02482682F41C083ULL,
+      0xBB5AA3F9647A9BA6ULL, 0x68627642B914D7FAULL},
+     {0x0000000000000000ULL, 0xD5619B5947B70B5CULL, 0xF659F8D3E934CDC0ULL,
+      0x2338638AAE83C69CULL, 0xBF71CC9B3BCF1161ULL, 0x6A1057C27C781A3DULL,
+      0x49283448D2FBDCA1ULL, 0x9C49AF11954CD7FDULL, 0x40C24E51652762A8ULL,
+      0x95A3D508229069F4ULL, 0xB69BB6828C13AF68ULL, 0x63FA2DDBCBA4A434ULL,
+      0xFFB382CA5EE873C9ULL, 0x2AD21993195F7895ULL, 0x09EA7A19B7DCBE09ULL,
+      0xDC8BE140F06BB555ULL, 0x7E54270A76F72989ULL, 0xAB35BC53314022D5ULL,
+      0x880DDFD99FC3E449ULL, 0x5D6C4480D874EF15ULL, 0xC125EB914D3838E8ULL,
+      0x144470C80A8F33B4ULL, 0x377C1342A40CF528ULL, 0xE21D881BE3BBFE74ULL,
+      0x3E96695B13D04B21ULL, 0xEBF7F2025467407DULL, 0xC8CF9188FAE486E1ULL,
+      0x1DAE0AD1BD538DBDULL, 0x81E7A5C0281F5A40ULL, 0x54863E996FA8511CULL,
+      0x77BE5D13C12B9780ULL, 0xA2DFC64A869C9CDCULL}},
+    {{0x0000000000000000ULL, 0xECE67E20333C7212ULL, 0x82F2D0DE2B13A088ULL,
+      0x6E14AEFE182FD29AULL, 0x0979BF465EE7A378ULL, 0xE59FC1666DDBD16AULL,
+      0x8B8B6F9875F403F0ULL, 0x676D11B846C871E2ULL, 0x4A718FDA31369179ULL,
+      0xA697F1FA020AE36BULL, 0xC8835F041A2531F1ULL, 0x24652124291943E3ULL,
+      0x4308309C6FD13201ULL, 0xAFEE4EBC5CED4013ULL, 0xC1FAE04244C29289ULL,
+      0x2D1C9E6277FEE09BULL, 0x92617547D8829BA5ULL, 0x7E870B67EBBEE9B7ULL,
+      0x1093A599F3913B2DULL, 0xFC75DBB9C0AD493FULL, 0x9B18CA01866538DDULL,
+      0x77FEB421B5594ACFULL, 0x19EA1ADFAD769855ULL, 0xF50C64FF9E4AEA47ULL,
+      0xD810FA9DE9B40ADCULL, 0x34F684BDDA8878CEULL, 0x5AE22A43C2A7AA54ULL,
+      0xB6045463F19BD846ULL, 0xD16945DBB753A9A4ULL, 0x3D8F3BFB846FDBB6ULL,
+      0x539B95059C40092CULL, 0xBF7DEB25AF7C7B3EULL},
+     {0x0000000000000000ULL, 0x0EF935C3AB938E3DULL, 0xC4B29489BFC79ED6ULL,
+      0xCA4BA14A145410EBULL, 0x99F36A4FF953D5F3ULL, 0x970A5F8C52C05BCEULL,
+      0x5D41FEC646944B25ULL, 0x53B8CB05ED07C518ULL, 0x509C0BB7D4329255ULL,
+      0x5E653E747FA11C68ULL, 0x942E9F3E6BF50C83ULL, 0x9AD7AAFDC06682BEULL,
+      0xC96F61F82D6147A6ULL, 0xC796543B86F2C99BULL, 0x0DDDF57192A6D970ULL,
+      0x0324C0B23935574DULL, 0x4B9D3FDDCB2CB85AULL, 0x45640A1E60BF3667ULL,
+      0x8F2FAB5474EB268CULL, 0x81D69E97DF78A8B1ULL, 0xD26E5592327F6DA9ULL,
+      0xDC97605199ECE394ULL, 0x16DCC11B8DB8F37FULL, 0x1825F4D8262B7D42ULL,
+      0x1B01346A1F1E2A0FULL, 0x15F801A9B48DA432ULL, 0xDFB3A0E3A0D9B4D9ULL,
+      0xD14A95200B4A3AE4ULL, 0x82F25E25E64DFFFCULL, 0x8C0B6BE64DDE71C1ULL,
+      0x4640CAAC598A612AULL, 0x48B9FF6FF219EF17ULL}},
+    {{0x0000000000000000ULL, 0x27CE9546112DD073ULL, 0x156341F6EB0A569AULL,
+      0x32ADD4B0FA2786E9ULL, 0x43231E99937EA728ULL, 0x64ED8BDF8253775BULL,
+      0x56405F6F7874F1B2ULL, 0x718ECA29695921C1ULL, 0x74A2729CCAFED24EULL,
+      0x536CE7DADBD3023DULL, 0x61C1336A21F484D4ULL, 0x460FA62C30D954A7ULL,
+      0x37816C0559807566ULL, 0x104FF94348ADA515ULL, 0x22E22DF3B28A23FCULL,
+      0x052CB8B5A3A7F38FULL, 0x2FF8039D672E944BULL, 0x083696DB76034438ULL,
+      0x3A9B426B8C24C2D1ULL, 0x1D55D72D9D0912A2ULL, 0x6CDB1D04F4503363ULL,
+      0x4B158842E57DE310ULL, 0x79B85CF21F5A65F9ULL, 0x5E76C9B40E77B58AULL,
+      0x5B5A7101ADD04605ULL, 0x7C94E447BCFD9676ULL, 0x4E3930F746DA109FULL,
+      0x69F7A5B157F7C0ECULL, 0x18796F983EAEE12DULL, 0x3FB7FADE2F83315EULL,
+      0x0D1A2E6ED5A4B7B7ULL, 0x2AD4BB28C48967C4ULL},
+     {0x0000000000000000ULL, 0x3B70995EEDCCEE48ULL, 0xF0F6B75E9997038CULL,
+      0xCB862E00745BEDC4ULL, 0x4B0A6733D1F91969ULL, 0x707AFE6D3C35F721ULL,
+      0xBBFCD06D486E1AE5ULL, 0x808C4933A5A2F4ADULL, 0xA0CB4C312130309EULL,
+      0x9BBBD56FCCFCDED6ULL, 0x503DFB6FB8A73312ULL, 0x6B4D6231556BDD5AULL,
+      0xEBC12B02F0C929F7ULL, 0xD0B1B25C1D05C7BFULL, 0x1B379C5C695E2A7BULL,
+      0x204705028492C433ULL, 0x4DEAB40B77594AA9ULL, 0x769A2D559A95A4E1ULL,
+      0xBD1C0355EECE4925ULL, 0x866C9A0B0302A76DULL, 0x06E0D338A6A053C0ULL,
+      0x3D904A664B6CBD88ULL, 0xF61664663F37504CULL, 0xCD66FD38D2FBBE04ULL,
+      0xED21F83A56697A37ULL, 0xD6516164BBA5947FULL, 0x1DD74F64CFFE79BBULL,
+      0x26A7D63A223297F3ULL, 0xA62B9F098790635EULL, 0x9D5B06576A5C8D16ULL,
+      0x56DD28571E0760D2ULL, 0x6DADB109F3CB8E9AULL}},
+    {{0x0000000000000000ULL, 0x1B4339DC3F20D413ULL, 0xF1D2F0D034AFC5F8ULL,
+      0xEA91C90C0B8F11EBULL, 0xDC9F0161A6E45F52ULL, 0xC7DC38BD99C48B41ULL,
+      0x2D4DF1B1924B9AAAULL, 0x360EC86DAD6B4EB9ULL, 0xD05EF02E1091F59BULL,
+      0xCB1DC9F22FB12188ULL, 0x218C00FE243E3063ULL, 0x3ACF39221B1EE470ULL,
+      0x0CC1F14FB675AAC9ULL, 0x1782C89389557EDAULL, 0xFD13019F82DA6F31ULL,
+      0xE6503843BDFABB22ULL, 0xD0C0A9F97AC5D034ULL, 0xCB83902545E50427ULL,
+      0x211259294E6A15CCULL, 0x3A5160F5714AC1DFULL, 0x0C5FA898DC218F66ULL,
+      0x171C9144E3015B75ULL, 0xFD8D5848E88E4A9EULL, 0xE6CE6194D7AE9E8DULL,
+      0x009E59D76A5425AFULL, 0x1BDD600B5574F1BCULL, 0xF14CA9075EFBE057ULL,
+      0xEA0F90DB61DB3444ULL, 0xDC0158B6CCB07AFDULL, 0xC742616AF390AEEEULL,
+      0x2DD3A866F81FBF05ULL, 0x369091BAC73F6B16ULL},
+     {0x0000000000000000ULL, 0xF53C639A5BEC6F74ULL, 0x367E221EAF2D9CB4ULL,
+      0xC3424184F4C1F3C0ULL, 0x18553EE1FB8333DDULL, 0xED695D7BA06F5CA9ULL,
+      0x2E2B1CFF54AEAF69ULL, 0xDB177F650F42C01DULL, 0xFB1D0ACF7F72009BULL,
+      0x0E216955249E6FEFULL, 0xCD6328D1D05F9C2FULL, 0x385F4B4B8BB3F35BULL,
+      0xE348342E84F13346ULL, 0x167457B4DF1D5C32ULL, 0xD53616302BDCAFF2ULL,
+      0x200A75AA7030C086ULL, 0x5E851ED1E976C3FAULL, 0xABB97D4BB29AAC8EULL,
+      0x68FB3CCF465B5F4EULL, 0x9DC75F551DB7303AULL, 0x46D0203012F5F027ULL,
+      0xB3EC43AA49199F53ULL, 0x70AE022EBDD86C93ULL, 0x859261B4E63403E7ULL,
+      0xA598141E9604C361ULL, 0x50A47784CDE8AC15ULL, 0x93E6360039295FD5ULL,
+      0x66DA559A62C530A1ULL, 0xBDCD2AFF6D87F0BCULL, 0x48F14965366B9FC8ULL,
+      0x8BB308E1C2AA6C08ULL, 0x7E8F6B7B9946037CULL}},
+    {{0x0000000000000000ULL, 0xED3B5AE20A73D96AULL, 0x7757C886C6E8D76CULL,
+      0x9A6C9264CC9B0E06ULL, 0xA37369E62B3D7939ULL, 0x4E483304214EA053ULL,
+      0xD424A160EDD5AE55ULL, 0x391FFB82E7A6773FULL, 0xE6638EC369D568B2ULL,
+      0x0B58D42163A6B1D8ULL, 0x91344645AF3DBFDEULL, 0x7C0F1CA7A54E66B4ULL,
+      0x4510E72542E8118BULL, 0xA82BBDC7489BC8E1ULL, 0x32472FA38400C6E7ULL,
+      0xDF7C75418E731F8DULL, 0x29E34157F6BC6F3DULL, 0xC4D81BB5FCCFB657ULL,
+      0x5EB489D13054B851ULL, 0xB38FD3333A27613BULL, 0x8A9028B1DD811604ULL,
+      0x67AB7253D7F2CF6EULL, 0xFDC7E0371B69C168ULL, 0x10FCBAD5111A1802ULL,
+      0xCF80CF949F69078FULL, 0x22BB9576951ADEE5ULL, 0xB8D707125981D0E3ULL,
+      0x55EC5DF053F20989ULL, 0x6CF3A672B4547EB6ULL, 0x81C8FC90BE27A7DCULL,
+      0x1BA46EF472BCA9DAULL, 0xF69F341678CF70B0ULL},
+     {0x0000000000000000ULL, 0x5FC317A15824D4E3ULL, 0x4EB1B290B65019BBULL,
+      0x1172A531EE74CD58ULL, 0xEC11D6C9781112BFULL, 0xB3D2C1682035C65CULL,
+      0xA2A06459CE410B04ULL, 0xFD6373F89665DFE7ULL, 0x795349D604CEABF5ULL,
+      0x26905E775CEA7F16ULL, 0x37E2FB46B29EB24EULL, 0x6821ECE7EABA66ADULL,
+      0x95429F1F7CDFB94AULL, 0xCA8188BE24FB6DA9ULL, 0xDBF32D8FCA8FA0F1ULL,
+      0x84303A2E92AB7412ULL, 0xD54D5110280F49DFULL, 0x8A8E46B1702B9D3CULL,
+      0x9BFCE3809E5F5064ULL, 0xC43FF421C67B8487ULL, 0x395C87D9501E5B60ULL,
+      0x669F9078083A8F83ULL, 0x77ED3549E64E42DBULL, 0x282E22E8BE6A9638ULL,
+      0xAC1E18C62CC1E22AULL, 0xF3DD0F6774E536C9ULL, 0xE2AFAA569A91FB91ULL,
+      0xBD6CBDF7C2B52F72ULL, 0x400FCE0F54D0F095ULL, 0x1FCCD9AE0CF42476ULL,
+      0x0EBE7C9FE280E92EULL, 0x517D6B3EBAA43DCDULL}},
+    {{0x0000000000000000ULL, 0xABD740DA74A9119EULL, 0xFEB4BD167850313DULL,
+      0x5563FDCC0CF920A3ULL, 0x97DA999F34E07ABAULL, 0x3C0DD94540496B24ULL,
+      0x696E24894CB04B87ULL, 0xC2B9645338195A19ULL, 0x12F99CD9CB19A7B1ULL,
+      0xB92EDC03BFB0B62FULL, 0xEC4D21CFB349968CULL, 0x479A6115C7E08712ULL,
+      0x85230546FFF9DD0BULL, 0x2EF4459C8B50CC95ULL, 0x7B97B85087A9EC36ULL,
+      0xD040F88AF300FDA8ULL, 0x71A183CE60A3142DULL, 0xDA76C314140A05B3ULL,
+      0x8F153ED818F32510ULL, 0x24C27E026C5A348EULL, 0xE67B1A5154436E97ULL,
+      0x4DAC5A8B20EA7F09ULL, 0x18CFA7472C135FAAULL, 0xB318E79D58BA4E34ULL,
+      0x63581F17ABBAB39CULL, 0xC88F5FCDDF13A202ULL, 0x9DECA201D3EA82A1ULL,
+      0x363BE2DBA743933FULL, 0xF48286889F5AC926ULL, 0x5F55C652EBF3D8B8ULL,
+      0x0A363B9EE70AF81BULL, 0xA1E17B4493A3E985ULL},
+     {0x0000000000000000ULL, 0xD47DC2C6A6279390ULL, 0x06C5CD3EC02B1374ULL,
+      0xD2B80FF8660C80E4ULL, 0x0993661A1518DA2DULL, 0xDDEEA4DCB33F49BDULL,
+      0x0F56AB24D533C959ULL, 0xDB2B69E273145AC9ULL, 0x0A9D6E49B454EA55ULL,
+      0xDEE0AC8F127379C5ULL, 0x0C58A377747FF921ULL, 0xD82561B1D2586AB1ULL,
+      0x030E0853A14C3078ULL, 0xD773CA95076BA3E8ULL, 0x05CBC56D6167230CULL,
+      0xD1B607ABC740B09CULL, 0x21BEA8F5A9A259FEULL, 0xF5C36A330F85CA6EULL,
+      0x277B65CB69894A8AULL, 0xF306A70DCFAED91AULL, 0x282DCEEFBCBA83D3ULL,
+      0xFC500C291A9D1043ULL, 0x2EE803D17C9190A7ULL, 0xFA95C117DAB60337ULL,
+      0x2B23C6BC1DF6B3ABULL, 0xFF5E047ABBD1203BULL, 0x2DE60B82DDDDA0DFULL,
+      0xF99BC9447BFA334FULL, 0x22B0A0A608EE6986ULL, 0xF6CD6260AEC9FA16ULL,
+      0x24756D98C8C57AF2ULL, 0xF008AF5E6EE2E962ULL}},
+    {{0x0000000000000000ULL, 0x7E40364C6A1B7CC1ULL, 0x39738F63B023D986ULL,
+      0x4733B92FDA38A547ULL, 0x07723E331AE95733ULL, 0x7932087F70F22BF2ULL,
+      0x3E01B150AACA8EB5ULL, 0x4041871CC0D1F274ULL, 0xD5C81714E5F3DD9AULL,
+      0xAB8821588FE8A15BULL, 0xECBB987755D0041CULL, 0x92FBAE3B3FCB78DDULL,
+      0xD2BA2927FF1A8AA9ULL, 0xACFA1F6B9501F668ULL, 0xEBC9A6444F39532FULL,
+      0x9589900825222FEEULL, 0x7D6CC816A3D65DB8ULL, 0x032CFE5AC9CD2179ULL,
+      0x441F477513F5843EULL, 0x3A5F713979EEF8FFULL, 0x7A1EF625B93F0A8BULL,
+      0x045EC069D324764AULL, 0x436D7946091CD30DULL, 0x3D2D4F0A6307AFCCULL,
+      0xA8A4DF0246258022ULL, 0xD6E4E94E2C3EFCE3ULL, 0x91D75061F60659A4ULL,
+      0xEF97662D9C1D2565ULL, 0xAFD6E1315CCCD711ULL, 0xD196D77D36D7ABD0ULL,
+      0x96A56E52ECEF0E97ULL, 0xE8E5581E86F47256ULL},
+     {0x0000000000000000ULL, 0xCCCB12BF44CB2D97ULL, 0xC4E87F163227AD9EULL,
+      0x08236DA976EC8009ULL, 0xE1787DFF87723DF5ULL, 0x2DB36F40C3B91062ULL,
+      0x259002E9B555906BULL, 0xE95B1056F19EBDFCULL, 0xF398ABC87D7CE8DAULL,
+      0x3F53B97739B7C54DULL, 0x3770D4DE4F5B4544ULL, 0xFBBBC6610B9068D3ULL,
+      0x12E0D637FA0ED52FULL, 0xDE2BC488BEC5F8B8ULL, 0xD608A921C82978B1ULL,
+      0x1AC3BB9E8CE25526ULL, 0xFA10F46030EA9C5CULL, 0x36DBE6DF7421B1CBULL,
+      0x3EF88B7602CD31C2ULL, 0xF23399C946061C55ULL, 0x1B68899FB798A1A9ULL,
+      0xD7A39B20F3538C3EULL, 0xDF80F68985BF0C37ULL, 0x134BE436C17421A0ULL,
+      0x09885FA84D967486ULL, 0xC5434D17095D5911ULL, 0xCD6020BE7FB1D918ULL,
+      0x01AB32013B7AF48FULL, 0xE8F02257CAE44973ULL, 0x243B30E88E2F64E4ULL,
+      0x2C185D41F8C3E4EDULL, 0xE0D34FFEBC08C97AULL}},
+    {{0x0000000000000000ULL, 0xF77557CD81AB7760ULL, 0x7100307FD0ED904CULL,
+      0x867567B25146E72CULL, 0x9EA1A2800DAD5B6DULL, 0x69D4F54D8C062C0DULL,
+      0xEFA192FFDD40CB21ULL, 0x18D4C5325CEBBC41ULL, 0x70085331C8F8C29EULL,
+      0x877D04FC4953B5FEULL, 0x0108634E181552D2ULL, 0xF67D348399BE25B2ULL,
+      0xEEA9F1B1C55599F3ULL, 0x19DCA67C44FEEE93ULL, 0x9FA9C1CE15B809BFULL,
+      0x68DC960394137EDFULL, 0x3EE4FC416C44D43DULL, 0xC991AB8CEDEFA35DULL,
+      0x4FE4CC3EBCA94471ULL, 0xB8919BF33D023311ULL, 0xA0455EC161E98F50ULL,
+      0x5730090CE042F830ULL, 0xD1456EBEB1041F1CULL, 0x2630397330AF687CULL,
+      0x4EECAF70A4BC16A3ULL, 0xB999F8BD251761C3ULL, 0x3FEC9F0F745186EFULL,
+      0xC899C8C2F5FAF18FULL, 0xD04D0DF0A9114DCEULL, 0x27385A3D28BA3AAEULL,
+      0xA14D3D8F79FCDD82ULL, 0x56386A42F857AAE2ULL},
+     {0x0000000000000000ULL, 0x41A55C9ACB2FFFB8ULL, 0xB6788738A70B23B4ULL,
+      0xF7DDDBA26C24DC0CULL, 0xF23A228A9D8A1D6AULL, 0xB39F7E1056A5E2D2ULL,
+      0x4442A5B23A813EDEULL, 0x05E7F928F1AEC166ULL, 0x58ECAA07712D8F8DULL,
+      0x1949F69DBA027035ULL, 0xEE942D3FD626AC39ULL, 0xAF3171A51D095381ULL,
+      0xAAD6888DECA792E7ULL, 0xEB73D41727886D5FULL, 0x1CAE0FB54BACB153ULL,
+      0x5D0B532F80834EEBULL, 0xFAD6ABD891E38C1DULL, 0xBB73F7425ACC73A5ULL,
+      0x4CAE2CE036E8AFA9ULL, 0x0D0B707AFDC75011ULL, 0x08EC89520C699177ULL,
+      0x4949D5C8C7466ECFULL, 0xBE940E6AAB62B2C3ULL, 0xFF3152F0604D4D7BULL,
+      0xA23A01DFE0CE0390ULL, 0xE39F5D452BE1FC28ULL, 0x144286E747C52024ULL,
+      0x55E7DA7D8CEADF9CULL, 0x500023557D441EFAULL, 0x11A57FCFB66BE142ULL,
+      0xE678A46DDA4F3D4EULL, 0xA7DDF8F71160C2F6ULL}},
+    {{0x0000000000000000ULL, 0xB77822CC92940A18ULL, 0xD73F3400D12510EEULL,
+      0x604716CC43B11AF6ULL, 0x62B3B93422498ED1ULL, 0xD5CB9BF8B0DD84C9ULL,
+      0xB58C8D34F36C9E3FULL, 0x02F4AFF861F89427ULL, 0x906B31584574C919ULL,
+      0x27131394D7E0C301ULL, 0x475405589451D9F7ULL, 0xF02C279406C5D3EFULL,
+      0xF2D8886C673D47C8ULL, 0x45A0AAA0F5A94DD0ULL, 0x25E7BC6CB6185726ULL,
+      0x929F9EA0248C5D3EULL, 0xFEF8E717DB6978FCULL, 0x4980C5DB49FD72E4ULL,
+      0x29C7D3170A4C6812ULL, 0x9EBFF1DB98D8620AULL, 0x9C4B5E23F920F62DULL,
+      0x2B337CEF6BB4FC35ULL, 0x4B746A232805E6C3ULL, 0xFC0C48EFBA91ECDBULL,
+      0x6E93D64F9E1DB1E5ULL, 0xD9EBF4830C89BBFDULL, 0xB9ACE24F4F38A10BULL,
+      0x0ED4C083DDACAB13ULL, 0x0C206F7BBC543F34ULL, 0xBB584DB72EC0352CULL,
+      0xDB1F5B7B6D712FDAULL, 0x6C6779B7FFE525C2ULL},
+     {0x0000000000000000ULL, 0x0064707D4C3BEDBFULL, 0xB5938F8ADA681E8CULL,
+      0xB5F7FFF79653F333ULL, 0xE243494B0CD1B29BULL, 0xE227393640EA5F24ULL,
+      0x57D0C6C1D6B9AC17ULL, 0x57B4B6BC9A8241A8ULL, 0xC12730B52B2C45C3ULL,
+      0xC14340C86717A87CULL, 0x74B4BF3FF1445B4FULL, 0x74D0CF42BD7FB6F0ULL,
+      0x236479FE27FDF758ULL, 0x230009836BC61AE7ULL, 0x96F7F674FD95E9D4ULL,
+      0x96938609B1AE046BULL, 0xBAC3291B8C745883ULL, 0xBAA75966C04FB53CULL,
+      0x0F50A691561C460FULL, 0x0F34D6EC1A27ABB0ULL, 0x5880605080A5EA18ULL,
+      0x58E4102DCC9E07A7ULL, 0xED13EFDA5ACDF494ULL, 0xED779FA716F6192BULL,
+      0x7BE419AEA7581D40ULL, 0x7B8069D3EB63F0FFULL, 0xCE7796247D3003CCULL,
+      0xCE13E659310BEE73ULL, 0x99A750E5AB89AFDBULL, 0x99C32098E7B24264ULL,
+      0x2C34DF6F71E1B157ULL, 0x2C50AF123DDA5CE8ULL}},
+    {{0x0000000000000000ULL, 0x909D6577F605FE77ULL, 0xA1F6E2BBA6412352ULL,
+      0x316B87CC5044DD25ULL, 0x3E6931974C4AE20FULL, 0xAEF454E0BA4F1C78ULL,
+      0x9F9FD32CEA0BC15DULL, 0x0F02B65B1C0E3F2AULL, 0xA5D0F76FF7FA4280ULL,
+      0x354D921801FFBCF7ULL, 0x042615D451BB61D2ULL, 0x94BB70A3A7BE9FA5ULL,
+      0x9BB9C6F8BBB0A08FULL, 0x0B24A38F4DB55EF8ULL, 0x3A4F24431DF183DDULL,
+      0xAAD24134EBF47DAAULL, 0xCBA6B2713965ECDAULL, 0x5B3BD706CF6012ADULL,
+      0x6A5050CA9F24CF88ULL, 0xFACD35BD692131FFULL, 0xF5CF83E6752F0ED5ULL,
+      0x6552E691832AF0A2ULL, 0x5439615DD36E2D87ULL, 0xC4A4042A256BD3F0ULL,
+      0x6E76451ECE9FAE5AULL, 0xFEEB2069389A502DULL, 0xCF80A7A568DE8D08ULL,
+      0x5F1DC2D29EDB737FULL, 0x501F748982D54C55ULL, 0xC08211FE74D0B222ULL,
+      0xF1E9963224946F07ULL, 0x6174F345D2919170ULL},
+     {0x0000000000000000ULL, 0x3D2A42376AF24151ULL, 0x69572DD2AFC6BB5CULL,
+      0x547D6FE5C534FA0DULL, 0xC885BA4CDC261EEAULL, 0xF5AFF87BB6D45FBBULL,
+      0xA1D2979E73E0A5B6ULL, 0x9CF8D5A91912E4E7ULL, 0x2D8F3C8F2E49D0FEULL,
+      0x10A57EB844BB91AFULL, 0x44D8115D818F6BA2ULL, 0x79F2536AEB7D2AF3ULL,
+      0xE50A86C3F26FCE14ULL, 0xD820C4F4989D8F45ULL, 0x8C5DAB115DA97548ULL,
+      0xB177E926375B3419ULL, 0x09B318B8B3499523ULL, 0x34995A8FD9BBD472ULL,
+      0x60E4356A1C8F2E7FULL, 0x5DCE775D767D6F2EULL, 0xC136A2F46F6F8BC9ULL,
+      0xFC1CE0C3059DCA98ULL, 0xA8618F26C0A93095ULL, 0x954BCD11AA5B71C4ULL,
+      0x243C24379D0045DDULL, 0x19166600F7F2048CULL, 0x4D6B09E532C6FE81ULL,
+      0x70414BD25834BFD0ULL, 0xECB99E7B41265B37ULL, 0xD193DC4C2BD41A66ULL,
+      0x85EEB3A9EEE0E06BULL, 0xB8C4F19E8412A13AULL}},
+    {{0x0000000000000000ULL, 0x98C741D23F5AB5D5ULL, 0x3A0EEB505A330041ULL,
+      0xA2C9AA826569B594ULL, 0x20288D521C5C74BBULL, 0xB8EFCC802306C16EULL,
+      0x1A266602466F74FAULL, 0x82E127D07935C12FULL, 0x3470F34B250411B2ULL,
+      0xACB7B2991A5EA467ULL, 0x0E7E181B7F3711F3ULL, 0x96B959C9406DA426ULL,
+      0x14587E1939586509ULL, 0x8C9F3FCB0602D0DCULL, 0x2E569549636B6548ULL,
+      0xB691D49B5C31D09DULL, 0xFE0E4B25FC92559DULL, 0x66C90AF7C3C8E048ULL,
+      0xC400A075A6A155DCULL, 0x5CC7E1A799FBE009ULL, 0xDE26C677E0CE2126ULL,
+      0x46E187A5DF9494F3ULL, 0xE4282D27BAFD2167ULL, 0x7CEF6CF585A794B2ULL,
+      0xCA7EB86ED996442FULL, 0x52B9F9BCE6CCF1FAULL, 0xF070533E83A5446EULL,
+      0x68B712ECBCFFF1BBULL, 0xEA56353CC5CA3094ULL, 0x729174EEFA908541ULL,
+      0xD058DE6C9FF930D5ULL, 0x489F9FBEA0A38500ULL},
+     {0x0000000000000000ULL, 0x23D37AA1E2830835ULL, 0x6077D83F81E48DE1ULL,
+      0x43A4A29E636785D4ULL, 0x813FA9FAC314F2C5ULL, 0xA2ECD35B2197FAF0ULL,
+      0xE14871C542F07F24ULL, 0xC29B0B64A0737711ULL, 0xF6A5E57B1E762117ULL,
+      0xD5769FDAFCF52922ULL, 0x96D23D449F92ACF6ULL, 0xB50147E57D11A4C3ULL,
+      0x779A4C81DD62D3D2ULL, 0x544936203FE1DBE7ULL, 0x17ED94BE5C865E33ULL,
+      0x343EEE1FBE055606ULL, 0x0C9F101101C4F510ULL, 0x2F4C6AB0E347FD25ULL,
+      0x6CE8C82E802078F1ULL, 0x4F3BB28F62A370C4ULL, 0x8DA0B9EBC2D007D5ULL,
+      0xAE73C34A20530FE0ULL, 0xEDD761D443348A34ULL, 0xCE041B75A1B78201ULL,
+      0xFA3AF56A1FB2D407ULL, 0xD9E98FCBFD31DC32ULL, 0x9A4D2D559E5659E6ULL,
+      0xB99E57F47CD551D3ULL, 0x7B055C90DCA626C2ULL, 0x58D626313E252EF7ULL,
+      0x1B7284AF5D42AB23ULL, 0x38A1FE0EBFC1A316ULL}},
+    {{0x0000000000000000ULL, 0x73587E59B150BE56ULL, 0x6F2B102919D59C82ULL,
+      0x1C736E70A88522D4ULL, 0xCF46BC871847DD08ULL, 0xBC1EC2DEA917635EULL,
+      0xA06DACAE0192418AULL, 0xD335D2F7B0C2FFDCULL, 0x22D8BEE487219C73ULL,
+      0x5180C0BD36712225ULL, 0x4DF3AECD9EF400F1ULL, 0x3EABD0942FA4BEA7ULL,
+      0xED9E02639F66417BULL, 0x9EC67C3A2E36FF2DULL, 0x82B5124A86B3DDF9ULL,
+      0xF1ED6C1337E363AFULL, 0x6D54E4416021E4B5ULL, 0x1E0C9A18D1715AE3ULL,
+      0x027FF46879F47837ULL, 0x71278A31C8A4C661ULL, 0xA21258C6786639BDULL,
+      0xD14A269FC93687EBULL, 0xCD3948EF61B3A53FULL, 0xBE6136B6D0E31B69ULL,
+      0x4F8C5AA5E70078C6ULL, 0x3CD424FC5650C690ULL, 0x20A74A8CFED5E444ULL,
+      0x53FF34D54F855A12ULL, 0x80CAE622FF47A5CEULL, 0xF392987B4E171B98ULL,
+      0xEFE1F60BE692394CULL, 0x9CB9885257C2871AULL},
+     {0x0000000000000000ULL, 0x45191EF0496CB0FEULL, 0xB37BF83C561B29FDULL,
+      0xF662E6CC1F779903ULL, 0xA92E1C7D7EC19BEFULL, 0xEC37028D37AD2B11ULL,
+      0x1A55E44128DAB212ULL, 0x5F4CFAB161B602ECULL, 0x5C1B47E8D1FC1824ULL,
+      0x190259189890A8DAULL, 0xEF60BFD487E731D9ULL, 0xAA79A124CE8B8127ULL,
+      0xF5355B95AF3D83CBULL, 0xB02C4565E6513335ULL, 0x464EA3A9F926AA36ULL,
+      0x0357BD59B04A1AC8ULL, 0x22CA02D8F419411EULL, 0x67D31C28BD75F1E0ULL,
+      0x91B1FAE4A20268E3ULL, 0xD4A8E414EB6ED81DULL, 0x8BE41EA58AD8DAF1ULL,
+      0xCEFD0055C3B46A0FULL, 0x389FE699DCC3F30CULL, 0x7D86F86995AF43F2ULL,
+      0x7ED1453025E5593AULL, 0x3BC85BC06C89E9C4ULL, 0xCDAABD0C73FE70C7ULL,
+      0x88B3A3FC3A92C039ULL, 0xD7FF594D5B24C2D5ULL, 0x92E647BD1248722BULL,
+      0x6484A1710D3FEB28ULL, 0x219DBF8144535BD6ULL}},
+    {{0x0000000000000000ULL, 0xFD961A5C7A29DC9BULL, 0xC196CA0092230219ULL,
+      0x3C00D05CE80ADE82ULL, 0xC63AF8D001B4245BULL, 0x3BACE28C7B9DF8C0ULL,
+      0x07AC32D093972642ULL, 0xFA3A288CE9BEFAD9ULL, 0x54019DC204B46848ULL,
+      0xA997879E7E9DB4D3ULL, 0x959757C296976A51ULL, 0x68014D9EECBEB6CAULL,
+      0x923B651205004C13ULL, 0x6FAD7F4E7F299088ULL, 0x53ADAF1297234E0AULL,
+      0xAE3BB54EED0A9291ULL, 0x91BFBDE4D643245AULL, 0x6C29A7B8AC6AF8C1ULL,
+      0x502977E444602643ULL, 0xADBF6DB83E49FAD8ULL, 0x57854534D7F70001ULL,
+      0xAA135F68ADDEDC9AULL, 0x96138F3445D40218ULL, 0x6B8595683FFDDE83ULL,
+      0xC5BE2026D2F74C12ULL, 0x38283A7AA8DE9089ULL, 0x0428EA2640D44E0BULL,
+      0xF9BEF07A3AFD9290ULL, 0x0384D8F6D3436849ULL, 0xFE12C2AAA96AB4D2ULL,
+      0xC21212F641606A50ULL, 0x3F8408AA3B49B6CBULL},
+     {0x0000000000000000ULL, 0xC91B6EE029AF16F5ULL, 0xC39BA7CEEF36BED0ULL,
+      0x0A80C92EC699A825ULL, 0xFFA4CFD11AAE5B69ULL, 0x36BFA13133014D9CULL,
+      0x3C3F681FF598E5B9ULL, 0xF52406FFDC37F34CULL, 0x5409E8F6888B7386ULL,
+      0x9D128616A1246573ULL, 0x97924F3867BDCD56ULL, 0x5E8921D84E12DBA3ULL,
+      0xABAD2727922528EFULL, 0x62B649C7BB8A3E1AULL, 0x683680E97D13963FULL,
+      0xA12DEE0954BC80CAULL, 0x481BF7A29F592D1DULL, 0x81009942B6F63BE8ULL,
+      0x8B80506C706F93CDULL, 0x429B3E8C59C08538ULL, 0xB7BF387385F77674ULL,
+      0x7EA45693AC586081ULL, 0x74249FBD6AC1C8A4ULL, 0xBD3FF15D436EDE51ULL,
+      0x1C121F5417D25E9BULL, 0xD50971B43E7D486EULL, 0xDF89B89AF8E4E04BULL,
+      0x1692D67AD14BF6BEULL, 0xE3B6D0850D7C05F2ULL, 0x2AADBE6524D31307ULL,
+      0x202D774BE24ABB22ULL, 0xE93619ABCBE5ADD7ULL}},
+    {{0x0000000000000000ULL, 0xCE0A49D4AE99039FULL, 0x4A2D2E5BA17D7FF0ULL,
+      0x8427678F0FE47C6FULL, 0xFBC346E060D1A9ACULL, 0x35C90F34CE48AA33ULL,
+      0xB1EE68BBC1ACD65CULL, 0x7FE4216F6F35D5C3ULL, 0x68CCB236158E1959ULL,
+      0xA6C6FBE2BB171AC6ULL, 0x22E19C6DB4F366A9ULL, 0xECEBD5B91A6A6536ULL,
+      0x930FF4D6755FB0F5ULL, 0x5D05BD02DBC6B36AULL, 0xD922DA8DD422CF05ULL,
+      0x172893597ABBCC9AULL, 0x5C7A4B54B2289876ULL, 0x927002801CB19BE9ULL,
+      0x1657650F1355E786ULL, 0xD85D2CDBBDCCE419ULL, 0xA7B90DB4D2F931DAULL,
+      0x69B344607C603245ULL, 0xED9423EF73844E2AULL, 0x239E6A3BDD1D4DB5ULL,
+      0x34B6F962A7A6812FULL, 0xFABCB0B6093F82B0ULL, 0x7E9BD73906DBFEDFULL,
+      0xB0919EEDA842FD40ULL, 0xCF75BF82C7772883ULL, 0x017FF65669EE2B1CULL,
+      0x855891D9660A5773ULL, 0x4B52D80DC89354ECULL},
+     {0x0000000000000000ULL, 0x646F60F9404FDB93ULL, 0xA207FCFCB12B4BF6ULL,
+      0xC6689C05F1649065ULL, 0x9D7DA2B5075CFF03ULL, 0xF912C24C47132490ULL,
+      0x3F7A5E49B677B4F5ULL, 0x5B153EB0F6386F66ULL, 0x3FD42D2BE20504FEULL,
+      0x5BBB4DD2A24ADF6DULL, 0x9DD3D1D7532E4F08ULL, 0xF9BCB12E1361949BULL,
+      0xA2A98F9EE559FBFDULL, 0xC6C6EF67A516206EULL, 0x00AE73625472B00BULL,
+      0x64C1139B143D6B98ULL, 0x3CA9FAFF5DF2A0CCULL, 0x58C69A061DBD7B5FULL,
+      0x9EAE0603ECD9EB3AULL, 0xFAC166FAAC9630A9ULL, 0xA1D4584A5AAE5FCFULL,
+      0xC5BB38B31AE1845CULL, 0x03D3A4B6EB851439ULL, 0x67BCC44FABCACFAAULL,
+      0x037DD7D4BFF7A432ULL, 0x6712B72DFFB87FA1ULL, 0xA17A2B280EDCEFC4ULL,
+      0xC5154BD14E933457ULL, 0x9E007561B8AB5B31ULL, 0xFA6F1598F8E480A2ULL,
+      0x3C07899D098010C7ULL, 0x5868E96449CFCB54ULL}},
+    {{0x0000000000000000ULL, 0xE2F14BC66F8284B8ULL, 0x9DA6F30F1A70370AULL,
+      0x7F57B8C975F2B3B2ULL, 0xB72866540B08BFFBULL, 0x55D92D92648A3B43ULL,
+      0x2A8E955B117888F1ULL, 0xC87FDE9D7EFA0C49ULL, 0x6DF0B7A9EE67DAFCULL,
+      0x8F01FC6F81E55E44ULL, 0xF05644A6F417EDF6ULL, 0x12A70F609B95694EULL,
+      0xDAD8D1FDE56F6507ULL, 0x38299A3B8AEDE1BFULL, 0x477E22F2FF1F520DULL,
+      0xA58F6934909DD6B5ULL, 0xB3C1045674B0AAE5ULL, 0x51304F901B322E5DULL,
+      0x2E67F7596EC09DEFULL, 0xCC96BC9F01421957ULL, 0x04E962027FB8151EULL,
+      0xE61829C4103A91A6ULL, 0x994F910D65C82214ULL, 0x7BBEDACB0A4AA6ACULL,
+      0xDE31B3FF9AD77019ULL, 0x3CC0F839F555F4A1ULL, 0x439740F080A74713ULL,
+      0xA1660B36EF25C3ABULL, 0x6919D5AB91DFCFE2ULL, 0x8BE89E6DFE5D4B5AULL,
+      0xF4BF26A48BAFF8E8ULL, 0x164E6D62E42D7C50ULL},
+     {0x0000000000000000ULL, 0xF41D6F8B45255A63ULL, 0xE1136E16286949E4ULL,
+      0x150E019D6D4C1387ULL, 0xA5CA8B94A520F491ULL, 0x51D7E41FE005AEF2ULL,
+      0x44D9E5828D49BD75ULL, 0xB0C48A09C86CE716ULL, 0xCD61EE1222331977ULL,
+      0x397C819967164314ULL, 0x2C7280040A5A5093ULL, 0xD86FEF8F4F7F0AF0ULL,
+      0x68AB65868713EDE6ULL, 0x9CB60A0DC236B785ULL, 0x89B80B90AF7AA402ULL,
+      0x7DA5641BEA5FFE61ULL, 0x5377CB6217628C52ULL, 0xA76AA4E95247D631ULL,
+      0xB264A5743F0BC5B6ULL, 0x4679CAFF7A2E9FD5ULL, 0xF6BD40F6B24278C3ULL,
+      0x02A02F7DF76722A0ULL, 0x17AE2EE09A2B3127ULL, 0xE3B3416BDF0E6B44ULL,
+      0x9E16257035519525ULL, 0x6A0B4AFB7074CF46ULL, 0x7F054B661D38DCC1ULL,
+      0x8B1824ED581D86A2ULL, 0x3BDCAEE4907161B4ULL, 0xCFC1C16FD5543BD7ULL,
+      0xDACFC0F2B8182850ULL, 0x2ED2AF79FD3D7233ULL}},
+    {{0x0000000000000000ULL, 0x2BDD07698E7909F4ULL, 0xB832D0CFCD255FF7ULL,
+      0x93EFD7A6435C5603ULL, 0xAE8F67D317981DD3ULL, 0x855260BA99E11427ULL,
+      0x16BDB71CDABD4224ULL, 0x3D60B07554C44BD0ULL, 0x5110BFC11C5CE1F1ULL,
+      0x7ACDB8A89225E805ULL, 0xE9226F0ED179BE06ULL, 0xC2FF68675F00B7F2ULL,
+      0xFF9FD8120BC4FC22ULL, 0xD442DF7B85BDF5D6ULL, 0x47AD08DDC6E1A3D5ULL,
+      0x6C700FB44898AA21ULL, 0xA71AC4F3B190E38EULL, 0x8CC7C39A3FE9EA7AULL,
+      0x1F28143C7CB5BC79ULL, 0x34F51355F2CCB58DULL, 0x0995A320A608FE5DULL,
+      0x2248A4492871F7A9ULL, 0xB1A773EF6B2DA1AAULL, 0x9A7A7486E554A85EULL,
+      0xF60A7B32ADCC027FULL, 0xDDD77C5B23B50B8BULL, 0x4E38ABFD60E95D88ULL,
+      0x65E5AC94EE90547CULL, 0x58851CE1BA541FACULL, 0x73581B88342D1658ULL,
+      0xE0B7CC2E7771405BULL, 0xCB6ACB47F90849AFULL},
+     {0x0000000000000000ULL, 0x40A48E9B99B68A6BULL, 0x0118EA7916DAFEE0ULL,
+      0x41BC64E28F6C748BULL, 0x56B73EB8097776D6ULL, 0x1613B02390C1FCBDULL,
+      0x57AFD4C11FAD8836ULL, 0x170B5A5A861B025DULL, 0x79DCEF8B4EE0D26FULL,
+      0x39786110D7565804ULL, 0x78C405F2583A2C8FULL, 0x38608B69C18CA6E4ULL,
+      0x2F6BD1334797A4B9ULL, 0x6FCF5FA8DE212ED2ULL, 0x2E733B4A514D5A59ULL,
+      0x6ED7B5D1C8FBD032ULL, 0xB5DB9B835A5D67CBULL, 0xF57F1518C3EBEDA0ULL,
+      0xB4C371FA4C87992BULL, 0xF467FF61D5311340ULL, 0xE36CA53B532A111DULL,
+      0xA3C82BA0CA9C9B76ULL, 0xE2744F4245F0EFFDULL, 0xA2D0C1D9DC466596ULL,
+      0xCC07740814BDB5A4ULL, 0x8CA3FA938D0B3FCFULL, 0xCD1F9E7102674B44ULL,
+      0x8DBB10EA9BD1C12FULL, 0x9AB04AB01DCAC372ULL, 0xDA14C42B847C4919ULL,
+      0x9BA8A0C90B103D92ULL, 0xDB0C2E5292A6B7F9ULL}}};
+
+/**
+ * @brief Возвращает состояние блока игрового поля.
+ * @param field Указатель на игровое поле.
+ * @param y Номер строки.
+ * @param x Номер столбца.
+ * @return 1, если блок занят, 0 - если свободен или находится вне поля.
+ */
+int getBlock(const Field *field, int y, int x) {
+  int block = 0;
+  if (inField(x, y)) block = (field->rows[y] >> x) & 1;
+  return block;
+}
+
+/**
+ * @brief Устанавливает состояние блока игрового поля.
+ *
+ * Координаты вне поля игнорируются. Занятая строка отмечается в маске
+ * `dirty`, чтобы eraseLines() проверила её; высоты столбцов и хеш поля
+ * обновляются.
+ *
+ * @param field Указатель на игровое поле.
+ * @param y Номер строки.
+ * @param x Номер столбца.
+ * @param value 0 - освободить блок, иначе - занять.
+ */
+void setBlock(Field *field, int y, int x, int value) {
+  if (inField(x, y)) {
+    bool filled = (field->rows[y] >> x) & 1;
+    if (value) field->dirty |= 1u << y;
+    if (value && !filled) {
+      field->rows[y] |= (uint16_t)(1u << x);
+      field->hash ^= zobristKey(y, x);
+      if (field->heights[x] < FIELD_HEIGHT - y)
+        field->heights[x] = (uint8_t)(FIELD_HEIGHT - y);
+    } else if (!value && filled) {
+      field->rows[y] &= (uint16_t)~(1u << x);
+      field->hash ^= zobristKey(y, x);
+      if (field->heights[x] == FIELD_HEIGHT - y) updateHeights(field);
+    }
+  }
+}
+
+/**
+ * @brief Пересчитывает высоты всех столбцов поля по маскам строк.
+ *
+ * Строки просматриваются сверху вниз; высота столбца определяется первой
+ * строкой, в которой он занят.
+ *
+ * @param field Указатель на игровое поле.
+ */
+void updateHeights(Field *field) {
+  uint16_t seen = 0;
+  for (int j = 0; j < FIELD_WIDTH; j++) field->heights[j] = 0;
+  for (int i = 0; i < FIELD_HEIGHT && seen != FIELD_FULL_ROW; i++) {
+    uint16_t fresh = field->rows[i] & (uint16_t)~seen;
+    for (uint16_t bits = fresh; bits; bits &= bits - 1)
+      field->heights[__builtin_ctz(bits)] = (uint8_t)(FIELD_HEIGHT - i);
+    seen |= fresh;
+  }
+}
+
+/**
+ * @brief Обновляет высоты столбцов после удаления строк.
+ *
+ * Удалённая строка заполнена целиком, поэтому все удалённые строки лежат не
+ * выше верхнего блока любого столбца. Столбец, верхний блок которого уцелел,
+ * опускается на количество удалённых строк. Верхний блок мог оказаться в
+ * удалённой строке только у столбцов, вершина которых совпадает с верхней
+ * удалённой строкой; только для них новая вершина ищется заново по уже
+ * сдвинутым строкам, начиная со строки под прежней вершиной.
+ *
+ * @param field Указатель на игровое поле после удаления строк.
+ * @param cleared Бит `i` - строка `i` (до сдвига) была удалена.
+ */
+void lowerHeights(Field *field, uint32_t cleared) {
+  if (cleared) {
+    int count = __builtin_popcount(cleared);
+    int top = __builtin_ctz(cleared);
+    for (int j = 0; j < FIELD_WIDTH; j++) {
+      if (field->heights[j] != FIELD_HEIGHT - top) {
+        field->heights[j] = (uint8_t)(field->heights[j] - count);
+      } else {
+        int i = top + 1;
+        while (i < FIELD_HEIGHT && !((field->rows[i] >> j) & 1)) i++;
+        field->heights[j] = (uint8_t)(FIELD_HEIGHT - i);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Возвращает ключ Зобриста клетки поля.
+ * @param y Номер строки.
+ * @param x Номер столбца.
+ * @return Ключ клетки.
+ */
+uint64_t zobristKey(int y, int x) {
+  return zobristRows[y][x / ZOBRIST_HALF][1u << x % ZOBRIST_HALF];
+}
+
+/**
+ * @brief Вычисляет вклад строки поля в хеш Зобриста.
+ *
+ * Вклад складывается из двух выборок таблицы по половинам маски.
+ *
+ * @param y Номер строки.
+ * @param mask Маска занятых клеток строки.
+ * @return XOR ключей занятых клеток строки.
+ */
+uint64_t zobristRow(int y, uint16_t mask) {
+  const unsigned low = (1u << ZOBRIST_HALF) - 1;
+  return zobristRows[y][0][mask & low] ^
+         zobristRows[y][1][(mask >> ZOBRIST_HALF) & low];
+}
+
+/**
+ * @brief Вычисляет хеш Зобриста игрового поля заново.
+ *
+ * Результат совпадает с Field::hash, который поддерживается
+ * инкрементально; функция служит эталоном и отпечатком поля для повторов.
+ *
+ * @param field Указатель на игровое поле.
+ * @return Хеш поля.
+ */
+uint64_t hashField(const Field *field) {
+  uint64_t hash = 0;
+  for (int i = 0; i < FIELD_HEIGHT; i++) hash ^= zobristRow(i, field->rows[i]);
+  return hash;
+}
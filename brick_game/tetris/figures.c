@@ -84,3 +84,63 @@ Block lFigure[5][5] = {{{0}, {0}, {0}, {0}, {0}},
                        {{0}, {0}, {1}, {0}, {0}},
                        {{0}, {0}, {1}, {1}, {0}},
                        {{0}, {0}, {0}, {0}, {0}}};
+
+
+/**
+ * @brief Все состояния поворота всех фигур.
+ *
+ * Таблица рассчитана заранее из матриц выше: состояние `r + 1` получается из
+ * состояния `r` поворотом матрицы 5x5 на 90 градусов (блок `[i][j]` берётся
+ * из `[j][FIGURE_WIDTH - 1 - i]`). Порядок фигур совпадает с FiguresT.
+ * Последний элемент - нижний профиль: номер нижней занятой строки каждого
+ * столбца матрицы (-1 для пустого столбца).
+ */
+const FigureShape figureShapes[FIGURES_COUNT][ROTATIONS_COUNT] = {
+    {{{0x04, 0x04, 0x04, 0x04, 0x00}, 0, 3, 2, 2, {-1, -1, 3, -1, -1}},
+     {{0x00, 0x00, 0x0F, 0x00, 0x00}, 2, 2, 0, 3, {2, 2, 2, 2, -1}},
+     {{0x00, 0x04, 0x04, 0x04, 0x04}, 1, 4, 2, 2, {-1, -1, 4, -1, -1}},
+     {{0x00, 0x00, 0x1E, 0x00, 0x00}, 2, 2, 1, 4, {-1, 2, 2, 2, 2}}},
+    {{{0x00, 0x06, 0x06, 0x00, 0x00}, 1, 2, 1, 2, {-1, 2, 2, -1, -1}},
+     {{0x00, 0x00, 0x06, 0x06, 0x00}, 2, 3, 1, 2, {-1, 3, 3, -1, -1}},
+     {{0x00, 0x00, 0x0C, 0x0C, 0x00}, 2, 3, 2, 3, {-1, -1, 3, 3, -1}},
+     {{0x00, 0x0C, 0x0C, 0x00, 0x00}, 1, 2, 2, 3, {-1, -1, 2, 2, -1}}},
+    {{{0x00, 0x04, 0x0E, 0x00, 0x00}, 1, 2, 1, 3, {-1, 2, 2, 2, -1}},
+     {{0x00, 0x04, 0x06, 0x04, 0x00}, 1, 3, 1, 2, {-1, 2, 3, -1, -1}},
+     {{0x00, 0x00, 0x0E, 0x04, 0x00}, 2, 3, 1, 3, {-1, 2, 3, 2, -1}},
+     {{0x00, 0x04, 0x0C, 0x04, 0x00}, 1, 3, 2, 3, {-1, -1, 3, 2, -1}}},
+    {{{0x00, 0x00, 0x0C, 0x06, 0x00}, 2, 3, 1, 3, {-1, 3, 3, 2, -1}},
+     {{0x00, 0x04, 0x0C, 0x08, 0x00}, 1, 3, 2, 3, {-1, -1, 2, 3, -1}},
+     {{0x00, 0x0C, 0x06, 0x00, 0x00}, 1, 2, 1, 3, {-1, 2, 2, 1, -1}},
+     {{0x00, 0x02, 0x06, 0x04, 0x00}, 1, 3, 1, 2, {-1, 2, 3, -1, -1}}},
+    {{{0x00, 0x00, 0x06, 0x0C, 0x00}, 2, 3, 1, 3, {-1, 2, 3, 3, -1}},
+     {{0x00, 0x08, 0x0C, 0x04, 0x00}, 1, 3, 2, 3, {-1, -1, 3, 2, -1}},
+     {{0x00, 0x06, 0x0C, 0x00, 0x00}, 1, 2, 1, 3, {-1, 1, 2, 2, -1}},
+     {{0x00, 0x04, 0x06, 0x02, 0x00}, 1, 3, 1, 2, {-1, 3, 2, -1, -1}}},
+    {{{0x00, 0x04, 0x04, 0x06, 0x00}, 1, 3, 1, 2, {-1, 3, 3, -1, -1}},
+     {{0x00, 0x00, 0x0E, 0x08, 0x00}, 2, 3, 1, 3, {-1, 2, 2, 3, -1}},
+     {{0x00, 0x0C, 0x04, 0x04, 0x00}, 1, 3, 2, 3, {-1, -1, 3, 1, -1}},
+     {{0x00, 0x02, 0x0E, 0x00, 0x00}, 1, 2, 1, 3, {-1, 2, 2, 2, -1}}},
+    {{{0x00, 0x04, 0x04, 0x0C, 0x00}, 1, 3, 2, 3, {-1, -1, 3, 3, -1}},
+     {{0x00, 0x08, 0x0E, 0x00, 0x00}, 1, 2, 1, 3, {-1, 2, 2, 2, -1}},
+     {{0x00, 0x06, 0x04, 0x04, 0x00}, 1, 3, 1, 2, {-1, 1, 3, -1, -1}},
+     {{0x00, 0x00, 0x0E, 0x02, 0x00}, 2, 3, 1, 3, {-1, 3, 2, 2, -1}}}};
+
+/**
+ * @brief Возвращает текущее состояние поворота фигуры.
+ * @param figure Указатель на фигуру.
+ * @return Указатель на форму фигуры в таблице figureShapes.
+ */
+const FigureShape *getFigureShape(const Figure *figure) {
+  return &figureShapes[figure->id][figure->rotation];
+}
+
+/**
+ * @brief Возвращает состояние блока матрицы фигуры.
+ * @param figure Указатель на фигуру.
+ * @param i Номер строки матрицы фигуры.
+ * @param j Номер столбца матрицы фигуры.
+ * @return 1, если блок занят, иначе 0.
+ */
+int getFigureBlock(const Figure *figure, int i, int j) {
+  return (getFigureShape(figure)->rows[i] >> j) & 1;
+}
@@ -10,4 +10,6 @@ extern Block zFigure[5][5];
 extern Block jFigure[5][5];
 extern Block lFigure[5][5];
 
+extern const FigureShape figureShapes[FIGURES_COUNT][ROTATIONS_COUNT];
+
 #endif
@@ -15,17 +15,14 @@
 
 /**
  * @brief Освобождает память, занятую объектом игры.
+ *
+ * Игра, созданная initGame(), занимает один блок памяти вместе со всеми
+ * своими частями, поэтому освобождается одним вызовом free().
+ *
  * @param game Указатель на объект игры, который необходимо освободить.
  */
 void freeGame(Game *game) {
-  if (game) {
-    freeFigure(game->figure);
-    freeGameInfo(game->gameInfo);
-    freeField(game->field);
-    freeFiguresT(game->figurest);
-    free(game->player);
-    free(game);
-  }
+  if (game) free(game);
 }
 
 /**
@@ -41,11 +38,7 @@ void freeGameInfo(GameInfo *gameInfo) {
  * @param field Указатель на объект Field, который необходимо освободить.
  */
 void freeField(Field *field) {
-  if (field) {
-    for (int i = 0; i < FIELD_HEIGHT; i++) free(field->blocks[i]);
-    free(field->blocks);
-    free(field);
-  }
+  if (field) free(field);
 }
 
 /**
@@ -53,17 +46,7 @@ void freeField(Field *field) {
  * @param figure Указатель на объект Figure, который необходимо освободить.
  */
 void freeFigure(Figure *figure) {
-  if (figure) {
-    if (figure->blocks) {
-      for (int i = 0; i < FIGURE_HEIGHT; i++) {
-        if (figure->blocks[i]) {
-          free(figure->blocks[i]);
-        }
-      }
-      free(figure->blocks);
-    }
-    free(figure);
-  }
+  if (figure) free(figure);
 }
 
 /**
@@ -71,10 +54,5 @@ void freeFigure(Figure *figure) {
  * @param figureT Указатель на объект FiguresT, который необходимо освободить.
  */
 void freeFiguresT(FiguresT *figureT) {
-  if (figureT) {
-    if (figureT->blocks) {
-      free(figureT->blocks);
-    }
-    free(figureT);
-  } 
+  if (figureT) free(figureT);
 }
@@ -11,22 +11,152 @@
 #include "figures.h"
 #include "tetris.h"
 
+/**
+ * @struct GameArena
+ * @brief Размещение игры и всех её частей в одном блоке памяти.
+ *
+ * Изменяемые части игры лежат в одном снимке GameSnapshot.
+ */
+typedef struct GameArena {
+  Game game;           ///< Игра, указатели которой ссылаются на поля ниже
+  GameSnapshot state;  ///< Информация об игре, поле, фигура и игрок
+  FiguresT figurest;   ///< Шаблоны фигур
+} GameArena;
+
+/**
+ * @brief Выделяет блок памяти игры и связывает указатели игры с ним.
+ * @return Указатель на игру с незаполненным состоянием.
+ */
+static Game *allocGame() {
+  GameArena *arena = (GameArena *)malloc(sizeof(GameArena));
+  Game *game = &arena->game;
+
+  game->gameInfo = &arena->state.gameInfo;
+  game->field = &arena->state.field;
+  game->figure = &arena->state.figure;
+  game->figurest = &arena->figurest;
+  game->player = &arena->state.player;
+  fillFiguresT(game->figurest);
+
+  return game;
+}
+
 /**
  * @brief Инициализирует объект игры и возвращает указатель на него.
+ *
+ * Рекорд загружается из файла HIGH_SCORE_FILE, генератор фигур
+ * инициализируется текущим временем.
+ *
  * @return Указатель на инициализированный объект игры.
  */
-Game *initGame() {
-  Game *game = (Game *)malloc(sizeof(Game));
+Game *initGame() { return initGameWith(NULL); }
 
-  game->gameInfo = createGameInfo();
-  game->field = createField();
-  game->figure=NULL;
-  game->figurest = createFiguresT();
-  game->player = createPlayer();
-  game->gameInfo->nextID = rand() % FIGURES_COUNT;
+/**
+ * @brief Инициализирует объект игры с заданными параметрами.
+ *
+ * Все части игры выделяются одним вызовом malloc(), поэтому объект
+ * освобождается одним вызовом freeGame(). Игра не использует глобального
+ * состояния, поэтому разные игры можно вести в разных потоках.
+ *
+ * @param config Параметры игры, NULL - параметры по умолчанию (см.
+ * initGame()).
+ * @return Указатель на инициализированный объект игры.
+ */
+Game *initGameWith(const GameConfig *config) {
+  GameConfig defaults = {HIGH_SCORE_FILE, (uint64_t)time(NULL), false};
+  if (!config) config = &defaults;
+
+  Game *game = allocGame();
+  seedRandom(&game->gameInfo->random, config->seed);
+  game->gameInfo->seed = config->seed;
+  game->gameInfo->useBag = config->useBag;
+  game->gameInfo->high_score =
+      config->highScorePath ? loadHighScoreFrom(config->highScorePath) : 0;
+
+  resetGame(game);
+
+  return game;
+}
+
+/**
+ * @brief Возвращает игру в начальное состояние, не выделяя память.
+ *
+ * Рекордный счёт сохраняется, генератор фигур продолжает свою
+ * последовательность, а в режиме "мешка" начинается новый мешок.
+ *
+ * @param game Указатель на объект игры.
+ */
+void resetGame(Game *game) {
+  fillGameInfo(game->gameInfo);
+  clearField(game->field);
+  game->player->action = START;
+  game->gameInfo->bagLeft = 0;
+  game->gameInfo->nextID = randomFigure(game->gameInfo);
 
   dropNewFigure(game);
-  
+}
+
+/**
+ * @brief Создаёт независимую копию игры.
+ *
+ * Копия размещается в памяти одним блоком, как и игра из initGame(), и
+ * освобождается freeGame(). Дальнейшие ходы копии не влияют на исходную
+ * игру, а при одинаковых действиях обе игры развиваются одинаково.
+ *
+ * @param game Указатель на копируемую игру.
+ * @return Указатель на копию игры.
+ */
+Game *cloneGame(const Game *game) {
+  Game *clone = allocGame();
+  GameSnapshot snapshot;
+  snapshotGame(game, &snapshot);
+  restoreGame(clone, &snapshot);
+
+  return clone;
+}
+
+/**
+ * @brief Сохраняет состояние игры в снимок.
+ * @param game Указатель на игру.
+ * @param snapshot Указатель на снимок, в который записывается состояние.
+ */
+void snapshotGame(const Game *game, GameSnapshot *snapshot) {
+  snapshot->gameInfo = *game->gameInfo;
+  snapshot->field = *game->field;
+  snapshot->figure = *game->figure;
+  snapshot->player = *game->player;
+}
+
+/**
+ * @brief Восстанавливает состояние игры из снимка.
+ *
+ * Снимок можно восстанавливать многократно и в любую игру, в том числе не
+ * в ту, из которой он был сделан.
+ *
+ * @param game Указатель на игру.
+ * @param snapshot Указатель на снимок.
+ */
+void restoreGame(Game *game, const GameSnapshot *snapshot) {
+  *game->gameInfo = snapshot->gameInfo;
+  *game->field = snapshot->field;
+  *game->figure = snapshot->figure;
+  *game->player = snapshot->player;
+}
+
+/**
+ * @brief Связывает игру с частями снимка без копирования.
+ *
+ * Логика игры не обращается к шаблонам фигур, поэтому игрой с `figurest`
+ * равным NULL можно выполнять шаги stepGame(); для вывода printGame()
+ * шаблоны нужны.
+ *
+ * @param snapshot Указатель на снимок.
+ * @param figurest Шаблоны фигур или NULL.
+ * @return Игра, указатели которой ссылаются на снимок.
+ */
+Game snapshotView(GameSnapshot *snapshot, FiguresT *figurest) {
+  Game game = {&snapshot->gameInfo, &snapshot->field, &snapshot->figure,
+               figurest, &snapshot->player};
   return game;
 }
 
@@ -36,17 +166,34 @@ Game *initGame() {
  */
 GameInfo *createGameInfo() {
   GameInfo *gameInfo = (GameInfo *)malloc(sizeof(GameInfo));
-  gameInfo->score = 0;
+  gameInfo->seed = (uint64_t)time(NULL);
+  seedRandom(&gameInfo->random, gameInfo->seed);
+  gameInfo->useBag = false;
+  gameInfo->bagLeft = 0;
+  fillGameInfo(gameInfo);
   gameInfo->high_score = loadHighScore();
-  gameInfo->ticks = 30;
-  gameInfo->ticks_left = 30;
+  gameInfo->nextID = randomFigure(gameInfo);
+
+  return gameInfo;
+}
+
+/**
+ * @brief Заполняет поля GameInfo начальными значениями.
+ *
+ * Рекордный счёт, следующая фигура и генератор случайных чисел не
+ * изменяются.
+ *
+ * @param gameInfo Указатель на объект GameInfo.
+ */
+void fillGameInfo(GameInfo *gameInfo) {
+  gameInfo->score = 0;
+  gameInfo->ticks = levelTicks(1);
+  gameInfo->ticks_left = gameInfo->ticks;
   gameInfo->speed = 1;
   gameInfo->level = 1;
+  gameInfo->pieces = 0;
   gameInfo->state = Start;
   gameInfo->pause = 1;
-  gameInfo->nextID = rand() % FIGURES_COUNT;
-
-  return gameInfo;
 }
 
 /**
@@ -55,17 +202,22 @@ GameInfo *createGameInfo() {
  */
 Field *createField() {
   Field *field = (Field *)malloc(sizeof(Field));
-  field->blocks = (Block **)malloc(sizeof(Block *) * FIELD_HEIGHT);
-  for (int i = 0; i < FIELD_HEIGHT; i++) {
-    field->blocks[i] = (Block *)malloc(sizeof(Block) * FIELD_WIDTH);
-    for (int j = 0; j < FIELD_WIDTH; j++) {
-      field->blocks[i][j].block = 0;
-    }
-  }
+  clearField(field);
 
   return field;
 }
 
+/**
+ * @brief Очищает все блоки игрового поля.
+ * @param field Указатель на игровое поле.
+ */
+void clearField(Field *field) {
+  for (int i = 0; i < FIELD_HEIGHT; i++) field->rows[i] = 0;
+  for (int j = 0; j < FIELD_WIDTH; j++) field->heights[j] = 0;
+  field->dirty = 0;
+  field->hash = 0;
+}
+
 /**
  * @brief Создает фигуру и инициализирует её поля.
  * @return Указатель на инициализированную фигуру.
@@ -74,10 +226,8 @@ Figure *createFigure() {
   Figure *figure = (Figure *)malloc(sizeof(Figure));
   figure->x = 0;
   figure->y = 0;
-  figure->blocks = (Block **)malloc(sizeof(Block *) * FIGURE_HEIGHT);
-  for (int i = 0; i < FIGURE_HEIGHT; i++) {
-    figure->blocks[i] = (Block *)malloc(sizeof(Block) * FIGURE_WIDTH);
-  }
+  figure->id = 0;
+  figure->rotation = 0;
   return figure;
 }
 
@@ -87,21 +237,25 @@ Figure *createFigure() {
  */
 FiguresT *createFiguresT() {
   FiguresT *figurest = (FiguresT *)malloc(sizeof(FiguresT));
-
-  Block **templates = malloc(FIGURES_COUNT * sizeof(Block *));
-  templates[0] = &iFigure[0][0];
-  templates[1] = &oFigure[0][0];
-  templates[2] = &tFigure[0][0];
-  templates[3] = &sFigure[0][0];
-  templates[4] = &zFigure[0][0];
-  templates[5] = &jFigure[0][0];
-  templates[6] = &lFigure[0][0];
-
-  figurest->blocks = templates;
+  fillFiguresT(figurest);
 
   return figurest;
 }
 
+/**
+ * @brief Заполняет FiguresT указателями на шаблоны фигур.
+ * @param figurest Указатель на объект FiguresT.
+ */
+void fillFiguresT(FiguresT *figurest) {
+  figurest->blocks[0] = &iFigure[0][0];
+  figurest->blocks[1] = &oFigure[0][0];
+  figurest->blocks[2] = &tFigure[0][0];
+  figurest->blocks[3] = &sFigure[0][0];
+  figurest->blocks[4] = &zFigure[0][0];
+  figurest->blocks[5] = &jFigure[0][0];
+  figurest->blocks[6] = &lFigure[0][0];
+}
+
 /**
  * @brief Создает объект Player и инициализирует его поля.
  * @return Указатель на инициализированный объект Player.
@@ -113,11 +267,26 @@ Player *createPlayer() {
 }
 
 /**
- * @brief Сохраняет высокий счёт в файл.
+ * @brief Сохраняет высокий счёт в файл HIGH_SCORE_FILE.
  * @param high_score Высокий счёт для сохранения.
  */
 void saveHighScore(int high_score) {
-  FILE *file = fopen("high_score.dat", "w");
+  saveHighScoreTo(HIGH_SCORE_FILE, high_score);
+}
+
+/**
+ * @brief Загружает высокий счёт из файла HIGH_SCORE_FILE.
+ * @return Загруженный высокий счёт.
+ */
+int loadHighScore() { return loadHighScoreFrom(HIGH_SCORE_FILE); }
+
+/**
+ * @brief Сохраняет высокий счёт в заданный файл.
+ * @param path Путь к файлу рекорда.
+ * @param high_score Высокий счёт для сохранения.
+ */
+void saveHighScoreTo(const char *path, int high_score) {
+  FILE *file = fopen(path, "w");
   if (file) {
     fprintf(file, "%d", high_score);
     fclose(file);
@@ -125,14 +294,15 @@ void saveHighScore(int high_score) {
 }
 
 /**
- * @brief Загружает высокий счёт из файла.
- * @return Загруженный высокий счёт.
+ * @brief Загружает высокий счёт из заданного файла.
+ * @param path Путь к файлу рекорда.
+ * @return Загруженный высокий счёт, 0 - если файл не удалось прочитать.
  */
-int loadHighScore() {
+int loadHighScoreFrom(const char *path) {
   int high_score = 0;
-  FILE *file = fopen("high_score.dat", "r");
+  FILE *file = fopen(path, "r");
   if (file) {
-    fscanf(file, "%d", &high_score);
+    if (fscanf(file, "%d", &high_score) != 1) high_score = 0;
     fclose(file);
   }
   return high_score;
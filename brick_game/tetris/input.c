@@ -0,0 +1,146 @@
+/**
+ * @file input.c
+ * @brief Очередь действий игрока и автоповтор сдвигов (DAS/ARR).
+ *
+ * Интерфейс (gui/cli) переводит все клавиши, накопившиеся за кадр, в
+ * действия и передаёт их pushKey() с временем нажатия; игровой цикл перед
+ * каждым тиком вызывает updateInput() и забирает одно действие
+ * popInput(). Модуль не зависит от ncurses, поэтому тайминги автоповтора
+ * проверяются тестами.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "input.h"
+
+#define INPUT_MS 1000000ULL /*!< Наносекунд в миллисекунде */
+
+/**
+ * @brief Возвращает текущее время монотонных часов в наносекундах.
+ * @return Время в наносекундах.
+ */
+uint64_t monotonicNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Инициализирует пустую очередь действий.
+ * @param queue Указатель на очередь.
+ * @param config Параметры автоповтора, NULL - INPUT_DAS_MS, INPUT_ARR_MS и
+ * INPUT_RELEASE_MS.
+ */
+void initInput(InputQueue *queue, const InputConfig *config) {
+  InputConfig defaults = {INPUT_DAS_MS, INPUT_ARR_MS, INPUT_RELEASE_MS};
+  queue->config = config ? *config : defaults;
+  queue->head = 0;
+  queue->tail = 0;
+  queue->dropped = 0;
+  queue->repeat = ACTION;
+  queue->held = false;
+  queue->startNs = 0;
+  queue->pressNs = 0;
+  queue->lastNs = 0;
+  queue->nextNs = 0;
+}
+
+/**
+ * @brief Добавляет действие в конец очереди.
+ *
+ * Если очередь заполнена, действие отбрасывается и учитывается в
+ * `dropped`.
+ *
+ * @param queue Указатель на очередь.
+ * @param action Действие.
+ */
+static void enqueue(InputQueue *queue, UserAction action) {
+  if (queue->tail - queue->head < INPUT_QUEUE_SIZE)
+    queue->actions[queue->tail++ % INPUT_QUEUE_SIZE] = action;
+  else
+    queue->dropped++;
+}
+
+/**
+ * @brief Проверяет, повторяется ли действие при удержании клавиши.
+ * @param action Действие.
+ * @return true для сдвигов влево, вправо и вниз.
+ */
+static bool repeatable(UserAction action) {
+  return action == LEFT || action == RIGHT || action == DOWN;
+}
+
+/**
+ * @brief Принимает нажатие клавиши.
+ *
+ * Нажатие сдвига, пришедшее позже `releaseMs` после предыдущего нажатия
+ * или повтора того же сдвига, ставится в очередь. Более частые нажатия -
+ * автоповтор терминала: клавиша отмечается удерживаемой, а в очередь
+ * ничего не добавляется (повторы создаёт updateInput()). Остальные
+ * действия ставятся в очередь без изменений.
+ *
+ * @param queue Указатель на очередь.
+ * @param action Действие нажатой клавиши.
+ * @param nowNs Время нажатия (monotonicNs()).
+ */
+void pushKey(InputQueue *queue, UserAction action, uint64_t nowNs) {
+  uint64_t release = (uint64_t)queue->config.releaseMs * INPUT_MS;
+  if (!repeatable(action)) {
+    enqueue(queue, action);
+  } else if (action == queue->repeat && nowNs - queue->lastNs <= release) {
+    uint64_t delay = (uint64_t)queue->config.dasMs * INPUT_MS;
+    if (!queue->held) queue->nextNs = queue->startNs + delay;
+    queue->held = true;
+    queue->lastNs = nowNs;
+  } else {
+    enqueue(queue, action);
+    queue->startNs = action == queue->repeat ? queue->pressNs : nowNs;
+    queue->repeat = action;
+    queue->held = false;
+    queue->pressNs = nowNs;
+    queue->lastNs = nowNs;
+  }
+}
+
+/**
+ * @brief Продвигает автоповтор удерживаемого сдвига.
+ *
+ * Если повторы терминала прекратились дольше `releaseMs` назад, клавиша
+ * считается отпущенной. Пока клавиша удерживается, после задержки `dasMs`
+ * в очередь добавляется не больше одного повтора за вызов с периодом
+ * `arrMs`; пропущенные из-за редких вызовов повторы не накапливаются.
+ *
+ * @param queue Указатель на очередь.
+ * @param nowNs Текущее время (monotonicNs()).
+ */
+void updateInput(InputQueue *queue, uint64_t nowNs) {
+  uint64_t period = (uint64_t)queue->config.arrMs * INPUT_MS;
+  if (queue->held &&
+      nowNs - queue->lastNs > (uint64_t)queue->config.releaseMs * INPUT_MS)
+    queue->held = false;
+  if (queue->held && nowNs >= queue->nextNs) {
+    enqueue(queue, queue->repeat);
+    queue->nextNs = nowNs - queue->nextNs >= period ? nowNs + period
+                                                    : queue->nextNs + period;
+  }
+}
+
+/**
+ * @brief Извлекает первое действие из очереди.
+ * @param queue Указатель на очередь.
+ * @return Действие или ACTION, если очередь пуста.
+ */
+UserAction popInput(InputQueue *queue) {
+  UserAction action = ACTION;
+  if (queue->head != queue->tail)
+    action = queue->actions[queue->head++ % INPUT_QUEUE_SIZE];
+  return action;
+}
+
+/**
+ * @brief Возвращает количество действий в очереди.
+ * @param queue Указатель на очередь.
+ * @return Количество действий.
+ */
+int pendingInput(const InputQueue *queue) {
+  return (int)(queue->tail - queue->head);
+}
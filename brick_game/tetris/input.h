@@ -0,0 +1,58 @@
+#ifndef INPUT_H_
+#define INPUT_H_
+
+#include "tetris.h"
+
+#define INPUT_QUEUE_SIZE 64 /*!< Ёмкость очереди действий (степень двойки) */
+#define INPUT_DAS_MS 167    /*!< Задержка автоповтора по умолчанию */
+#define INPUT_ARR_MS 33     /*!< Период автоповтора по умолчанию */
+#define INPUT_RELEASE_MS \
+  100 /*!< Пауза в повторах терминала, после которой клавиша отпущена */
+
+/**
+ * @struct InputConfig
+ * @brief Параметры автоповтора сдвигов (DAS/ARR).
+ */
+typedef struct InputConfig {
+  int dasMs;      ///< Задержка от нажатия до первого повтора
+  int arrMs;      ///< Период повторов, 0 - повтор на каждом кадре
+  int releaseMs;  ///< Без повторов дольше этого клавиша считается отпущенной
+} InputConfig;
+
+/**
+ * @struct InputQueue
+ * @brief Очередь действий игрока с автоповтором удерживаемых сдвигов.
+ *
+ * Кольцевой буфер действий, накопленных между тиками: каждое нажатие
+ * становится отдельным действием, и игровой цикл забирает по одному
+ * действию за тик. Терминал не сообщает об отпускании клавиш, поэтому
+ * удержание определяется по автоповтору самого терминала: нажатие того же
+ * сдвига раньше, чем через `releaseMs` после предыдущего, означает, что
+ * клавиша удерживается, и такие нажатия заменяются собственным
+ * автоповтором с периодом `arrMs`. Первый повтор терминала приходит после
+ * его собственной задержки и неотличим от нового нажатия, поэтому
+ * задержка `dasMs` отсчитывается от предыдущего нажатия того же сдвига, а
+ * фактическая задержка не меньше задержки автоповтора терминала.
+ */
+typedef struct InputQueue {
+  UserAction actions[INPUT_QUEUE_SIZE];  ///< Кольцевой буфер действий
+  unsigned head;         ///< Номер следующего извлекаемого действия
+  unsigned tail;         ///< Номер следующего добавляемого действия
+  long long dropped;     ///< Действия, не поместившиеся в очередь
+  InputConfig config;    ///< Параметры автоповтора
+  UserAction repeat;     ///< Последний нажатый сдвиг, ACTION - не было
+  bool held;             ///< Сдвиг удерживается (идут повторы терминала)
+  uint64_t startNs;      ///< Начало удержания сдвига
+  uint64_t pressNs;      ///< Последнее нажатие сдвига, ставшее действием
+  uint64_t lastNs;       ///< Последнее нажатие или повтор сдвига
+  uint64_t nextNs;       ///< Время следующего собственного повтора
+} InputQueue;
+
+void initInput(InputQueue *queue, const InputConfig *config);
+void pushKey(InputQueue *queue, UserAction action, uint64_t nowNs);
+void updateInput(InputQueue *queue, uint64_t nowNs);
+UserAction popInput(InputQueue *queue);
+int pendingInput(const InputQueue *queue);
+uint64_t monotonicNs();
+
+#endif
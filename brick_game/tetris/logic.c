@@ -5,6 +5,8 @@
  * Этот файл содержит функции, отвечающие за перемещение фигур,
  * обработку столкновений, подсчет очков и другие аспекты игрового процесса
  */
+#include "figures.h"
+#include "profile.h"
 #include "tetris.h"
 
 /**
@@ -38,28 +40,55 @@ void leftFigure(Figure *figure) { figure->x--; }
 void rightFigure(Figure *figure) { figure->x++; }
 
 /**
- * @brief Создает новую фигуру и устанавливает ее начальные координаты.
- * @param game Указатель на объект игры.
+ * @brief Помещает фигуру с заданным идентификатором на начальную позицию.
+ * @param figure Указатель на фигуру.
+ * @param id Идентификатор фигуры.
  */
-void dropNewFigure(Game *game) {
-  Figure *figure = createFigure();
+void spawnFigure(Figure *figure, int id) {
   figure->x = FIELD_WIDTH / 2 - FIGURE_WIDTH / 2;
   figure->y = 0;
+  figure->id = id;
+  figure->rotation = 0;
+}
 
-  for (int i = 0; i < FIGURE_HEIGHT; ++i) {
-    for (int j = 0; j < FIGURE_WIDTH; ++j)
-      figure->blocks[i][j].block =
-          game->figurest->blocks[game->gameInfo->nextID][i * FIGURE_WIDTH + j]
-              .block;
-  }
-  
-  game->figure = figure;
-  game->gameInfo->nextID = rand() % FIGURES_COUNT;
+/**
+ * @brief Помещает следующую фигуру на начальную позицию.
+ *
+ * Текущая фигура переиспользуется, память не выделяется.
+ *
+ * @param game Указатель на объект игры.
+ */
+void dropNewFigure(Game *game) {
+  spawnFigure(game->figure, game->gameInfo->nextID);
+  game->gameInfo->nextID = randomFigure(game->gameInfo);
+  game->gameInfo->pieces++;
+  PROFILE_COUNT(CounterSpawns, 1);
+}
+
+/**
+ * @brief Возвращает интервал падения фигуры для уровня.
+ *
+ * Интервал задаётся в тиках длительностью TICK_MS: от 900 мс на первом
+ * уровне до 100 мс на последнем.
+ *
+ * @param level Уровень от 1 до LEVELS_COUNT.
+ * @return Количество тиков между шагами фигуры вниз.
+ */
+int levelTicks(int level) {
+  static const int ticks[LEVELS_COUNT] = {90, 78, 66, 55, 45,
+                                          36, 28, 21, 15, 10};
+  if (level < 1) level = 1;
+  if (level > LEVELS_COUNT) level = LEVELS_COUNT;
+  return ticks[level - 1];
 }
 
 /**
  * @brief Обрабатывает игровую логику, включая управление фигурой и состояния
  * игры.
+ *
+ * Один вызов соответствует одному тику длительностью TICK_MS: применяется
+ * действие игрока, а раз в gameInfo->ticks тиков фигура опускается вниз.
+ *
  * @param game Указатель на объект игры.
  */
 void calculate(Game *game) {
@@ -83,6 +112,9 @@ void calculate(Game *game) {
       case RIGHT:
         right(game);
         break;
+      case HARD_DROP:
+        hardDrop(game);
+        break;
       case TERMINATE:
         game->gameInfo->state = Quit;
         break;
@@ -97,6 +129,24 @@ void calculate(Game *game) {
   }
 }
 
+/**
+ * @brief Выполняет одну итерацию игрового цикла для заданного действия.
+ *
+ * Повторяет логику основного цикла программы: пока игра не окончена,
+ * вызывается calculate(), а после окончания игры действие START начинает
+ * новую игру.
+ *
+ * @param game Указатель на объект игры.
+ * @param action Действие игрока.
+ */
+void stepGame(Game *game, UserAction action) {
+  game->player->action = action;
+  if (game->gameInfo->state != GameOver)
+    calculate(game);
+  else if (action == START)
+    resetGame(game);
+}
+
 /**
  * @brief Выполняет один такт игры, перемещая фигуру вниз и обрабатывая
  * столкновения.
@@ -108,71 +158,203 @@ void calcOne(Game *game) {
   downFigure(game->figure);
   if (collision(game)) {
     upFigure(game->figure);
-    plantFigure(game);
-    countScore(game);
-    freeFigure(game->figure);
-    dropNewFigure(game);
-    game->gameInfo->state = Spawn;
-    if (collision(game)) {
-      game->gameInfo->state = GameOver;
-    }
+    lockFigure(game);
+  }
+}
+
+/**
+ * @brief Фиксирует текущую фигуру, удаляет линии и выдаёт следующую фигуру.
+ *
+ * Если новая фигура сразу сталкивается с полем, игра заканчивается.
+ *
+ * @param game Указатель на объект игры.
+ */
+void lockFigure(Game *game) {
+  PROFILE_COUNT(CounterLocks, 1);
+  plantFigure(game);
+  countScore(game);
+  dropNewFigure(game);
+  game->gameInfo->state = Spawn;
+  if (collision(game)) {
+    game->gameInfo->state = GameOver;
   }
 }
 
 /**
  * @brief Проверяет наличие столкновений фигуры с другими объектами или
  * границами поля.
+ *
+ * Если игра уже находится в состоянии Collision, столкновение считается
+ * зафиксированным до следующего такта.
+ *
  * @param game Указатель на объект игры.
  * @return true, если произошло столкновение, иначе false.
  */
 bool collision(Game *game) {
-  Field *field = game->field;
-  Figure *figure = game->figure;
+  if (game->gameInfo->state != Collision &&
+      figureCollides(game->field, game->figure))
+    game->gameInfo->state = Collision;
+  return game->gameInfo->state == Collision;
+}
 
-  for (int i = 0; i < FIGURE_HEIGHT && game->gameInfo->state != Collision; ++i)
-    for (int j = 0; j < FIGURE_WIDTH && game->gameInfo->state != Collision;
-         ++j) {
-      if (figure->blocks[i][j].block) {
-        int fx = figure->x + j;
-        int fy = figure->y + i;
-        if (!inField(fx, fy))
-          game->gameInfo->state = Collision;
-        else if (field->blocks[fy][fx].block)
-          game->gameInfo->state = Collision;
+/**
+ * @brief Проверяет, пересекается ли фигура с блоками или границами поля.
+ *
+ * Строка поля помещается в 32-битное слово со сдвигом на FIGURE_WIDTH, а
+ * биты слева и справа от неё заполняются "стенами". Тогда столкновение
+ * строки фигуры с полем и его боковыми границами - это одна операция AND.
+ *
+ * @param field Указатель на игровое поле.
+ * @param figure Указатель на фигуру.
+ * @return true, если фигура пересекается с полем, иначе false.
+ */
+bool figureCollides(const Field *field, const Figure *figure) {
+  const FigureShape *shape = getFigureShape(figure);
+  bool result = figure->x <= -FIGURE_WIDTH || figure->x >= FIELD_WIDTH;
+  int shift = figure->x + FIGURE_WIDTH;
+  for (int i = 0; i < FIGURE_HEIGHT && !result; ++i) {
+    uint32_t mask = shape->rows[i];
+    if (mask) {
+      int fy = figure->y + i;
+      if (fy < 0 || fy >= FIELD_HEIGHT)
+        result = true;
+      else {
+        uint32_t walled = ~((uint32_t)FIELD_FULL_ROW << FIGURE_WIDTH) |
+                          (uint32_t)field->rows[fy] << FIGURE_WIDTH;
+        result = (mask << shift) & walled;
       }
     }
-  return game->gameInfo->state == Collision;
+  }
+  return result;
+}
+
+/**
+ * @brief Находит строку, на которой остановится падающая фигура.
+ *
+ * Если фигура целиком выше профиля поля, место падения вычисляется сразу:
+ * для каждого столбца фигуры нижний занятый блок должен оказаться над
+ * верхним блоком столбца поля. Иначе (фигура под нависающим блоком)
+ * фигура опускается построчно до столкновения.
+ *
+ * @param field Указатель на игровое поле.
+ * @param figure Указатель на фигуру.
+ * @return Координата `y` фигуры в месте падения.
+ */
+int landingRow(const Field *field, const Figure *figure) {
+  const FigureShape *shape = getFigureShape(figure);
+  int landing = FIELD_HEIGHT;
+  for (int j = shape->left; j <= shape->right; j++) {
+    int column = figure->x + j;
+    if (shape->bottoms[j] >= 0 && column >= 0 && column < FIELD_WIDTH) {
+      int y = FIELD_HEIGHT - 1 - field->heights[column] - shape->bottoms[j];
+      if (y < landing) landing = y;
+    }
+  }
+  if (landing < figure->y) {
+    Figure probe = *figure;
+    while (!figureCollides(field, &probe)) probe.y++;
+    landing = probe.y - 1;
+  }
+  return landing;
+}
+
+/**
+ * @brief Мгновенно опускает фигуру на место падения и фиксирует её.
+ * @param game Указатель на объект игры.
+ */
+void hardDrop(Game *game) {
+  if (!game->gameInfo->pause &&
+      !figureCollides(game->field, game->figure)) {
+    game->figure->y = landingRow(game->field, game->figure);
+    game->gameInfo->ticks_left = game->gameInfo->ticks;
+    lockFigure(game);
+  }
 }
 
 /**
  * @brief Фиксирует фигуру на игровом поле.
  * @param game Указатель на объект игры.
  */
-void plantFigure(Game *game) {
-  for (int i = 0; i < FIGURE_HEIGHT; i++)
-    for (int j = 0; j < FIGURE_WIDTH; j++)
-      if (game->figure->blocks[i][j].block) {
-        int fx = game->figure->x + j;
-        int fy = game->figure->y + i;
-        if (inField(fx, fy)) {
-          game->field->blocks[fy][fx].block = 1;
+void plantFigure(Game *game) { plantShape(game->field, game->figure); }
+
+/**
+ * @brief Добавляет блоки фигуры на поле.
+ *
+ * Строки, занятые фигурой (не более FIGURE_HEIGHT), отмечаются в маске
+ * `dirty` поля, и eraseLines() проверяет только их. Высоты столбцов под
+ * фигурой и хеш поля обновляются по добавленным клеткам.
+ *
+ * @param field Указатель на игровое поле.
+ * @param figure Указатель на фигуру.
+ */
+void plantShape(Field *field, const Figure *figure) {
+  const FigureShape *shape = getFigureShape(figure);
+  int shift = figure->x + FIGURE_WIDTH;
+  if (shift > 0 && figure->x < FIELD_WIDTH) {
+    for (int i = 0; i < FIGURE_HEIGHT; i++) {
+      int fy = figure->y + i;
+      uint16_t mask =
+          (uint16_t)((((uint32_t)shape->rows[i] << shift) >> FIGURE_WIDTH) &
+                     FIELD_FULL_ROW);
+      if (mask && fy >= 0 && fy < FIELD_HEIGHT) {
+        uint16_t added = mask & (uint16_t)~field->rows[fy];
+        field->rows[fy] |= mask;
+        field->dirty |= 1u << fy;
+        for (uint16_t bits = added; bits; bits &= bits - 1) {
+          int column = __builtin_ctz(bits);
+          field->hash ^= zobristKey(fy, column);
+          if (field->heights[column] < FIELD_HEIGHT - fy)
+            field->heights[column] = (uint8_t)(FIELD_HEIGHT - fy);
         }
       }
+    }
+  }
 }
 
 /**
  * @brief Удаляет заполненные линии из игрового поля и возвращает количество
  * удаленных линий.
+ *
+ * Заполненными могут оказаться только строки из маски `dirty`, поэтому
+ * проверяются лишь они. Удаление выполняется одним проходом снизу вверх от
+ * нижней заполненной строки до верхней занятой (строки выше пусты и не
+ * меняются): каждая оставшаяся строка переносится на своё место не более
+ * одного раза, а освободившиеся верхние строки очищаются. После удаления
+ * высоты столбцов обновляются по маске удалённых строк (см.
+ * lowerHeights()), а хеш поля - по вкладам сдвинутых строк, каждый из
+ * которых берётся из таблицы (см. zobristRow()).
+ *
  * @param field Указатель на игровое поле.
  * @return Количество удаленных линий.
  */
 int eraseLines(Field *field) {
+  uint32_t full = 0;
+  for (uint32_t dirty = field->dirty; dirty; dirty &= dirty - 1) {
+    int i = __builtin_ctz(dirty);
+    if (lineFilled(i, field)) full |= 1u << i;
+  }
+  field->dirty = 0;
+
   int count = 0;
-  for (int i = FIELD_HEIGHT - 1; i >= 0; i--) {
-    while (lineFilled(i, field)) {
-      dropLine(i, field);
-      count++;
+  if (full) {
+    int bottom = 31 - __builtin_clz(full);
+    int top = FIELD_HEIGHT;
+    for (int j = 0; j < FIELD_WIDTH; j++)
+      if (FIELD_HEIGHT - field->heights[j] < top)
+        top = FIELD_HEIGHT - field->heights[j];
+    for (int i = top; i <= bottom; i++)
+      field->hash ^= zobristRow(i, field->rows[i]);
+    int to = bottom;
+    for (int from = to; from >= top; from--) {
+      if ((full >> from) & 1)
+        count++;
+      else
+        field->rows[to--] = field->rows[from];
     }
+    while (to >= top) field->rows[to--] = 0;
+    for (int i = top; i <= bottom; i++)
+      field->hash ^= zobristRow(i, field->rows[i]);
+    lowerHeights(field, full);
   }
   return count;
 }
@@ -184,25 +366,24 @@ int eraseLines(Field *field) {
  * @return true, если линия заполнена, иначе false.
  */
 bool lineFilled(int i, Field *field) {
-  bool flag = true;
-  for (int j = 0; j < FIELD_WIDTH && flag; ++j)
-    if (!field->blocks[i][j].block) flag = false;
-  return flag;
+  return field->rows[i] == FIELD_FULL_ROW;
 }
 
 /**
  * @brief Смещает линии вниз после удаления заполненной линии.
+ *
+ * Верхняя строка поля после сдвига становится пустой.
+ *
  * @param i Индекс линии.
  * @param field Указатель на игровое поле.
  */
 void dropLine(int i, Field *field) {
-  if (i == 0)
-    for (int j = 0; j < FIELD_WIDTH; j++) field->blocks[i][j].block = 0;
-  else {
-    for (int k = i; k > 0; k--)
-      for (int j = 0; j < FIELD_WIDTH; j++)
-        field->blocks[k][j].block = field->blocks[k - 1][j].block;
-  }
+  for (int k = i; k > 0; k--) field->rows[k] = field->rows[k - 1];
+  field->rows[0] = 0;
+  uint32_t moved = (2u << i) - 1;
+  field->dirty = (field->dirty & ~moved) | ((field->dirty << 1) & moved);
+  field->hash = hashField(field);
+  updateHeights(field);
 }
 
 /**
@@ -258,33 +439,22 @@ void right(Game *game) {
  */
 void rotate(Game *game) {
   if (!game->gameInfo->pause) {
-    Figure *pastFigure = game->figure;
-    game->figure = rotationFigure(game);
-    if (collision(game)) {
-      freeFigure(game->figure);
-      game->figure = pastFigure;
-    } else {
-      freeFigure(pastFigure);
-    }
+    int pastRotation = game->figure->rotation;
+    rotationFigure(game->figure);
+    if (collision(game)) game->figure->rotation = pastRotation;
   }
 }
 
 /**
- * @brief Создает новую фигуру, повернутую на 90 градусов.
- * @param game Указатель на объект игры.
- * @return Указатель на новую повернутую фигуру.
+ * @brief Поворачивает фигуру на 90 градусов.
+ *
+ * Все состояния поворота рассчитаны заранее, поэтому поворот сводится к
+ * смене номера состояния.
+ *
+ * @param figure Указатель на фигуру.
  */
-Figure *rotationFigure(Game *game) {
-  Figure *figure = createFigure(game);
-  figure->x = game->figure->x;
-  figure->y = game->figure->y;
-
-  for (int i = 0; i < FIGURE_HEIGHT; ++i)
-    for (int j = 0; j < FIGURE_WIDTH; ++j)
-      figure->blocks[i][j].block =
-          game->figure->blocks[j][FIGURE_WIDTH - 1 - i].block;
-
-  return figure;
+void rotationFigure(Figure *figure) {
+  figure->rotation = (figure->rotation + 1) % ROTATIONS_COUNT;
 }
 
 /**
@@ -293,6 +463,7 @@ Figure *rotationFigure(Game *game) {
  */
 void countScore(Game *game) {
   int erased_lines = eraseLines(game->field);
+  PROFILE_COUNT(CounterLines, erased_lines);
   switch (erased_lines) {
     case 0:
       break;
@@ -309,14 +480,13 @@ void countScore(Game *game) {
       game->gameInfo->score += 1500;
       break;
   }
-  if (game->gameInfo->score > game->gameInfo->high_score) {
+  if (game->gameInfo->score > game->gameInfo->high_score)
     game->gameInfo->high_score = game->gameInfo->score;
-    saveHighScore(game->gameInfo->high_score);
-  }
 
   int new_level = game->gameInfo->score / 600 + 1;
-  if (new_level > game->gameInfo->level && new_level <= 10) {
+  if (new_level > game->gameInfo->level && new_level <= LEVELS_COUNT) {
     game->gameInfo->level = new_level;
     game->gameInfo->speed = new_level;
+    game->gameInfo->ticks = levelTicks(new_level);
   }
 }
@@ -0,0 +1,198 @@
+/**
+ * @file profile.c
+ * @brief Гистограммы длительностей и профиль кадра (см. profile.h).
+ *
+ * Состояние профиля локально для потока: игра в терминале пишет его из
+ * одного потока, а пакетный запуск (sim), собранный с TETRIS_PROFILE, не
+ * делит счётчики между потоками.
+ */
+
+#include "profile.h"
+
+/**
+ * @brief Возвращает номер интервала гистограммы для значения.
+ *
+ * Значения меньше PROFILE_SUB_BUCKETS получают собственный интервал, а
+ * остальные - интервал по старшему биту и следующим за ним
+ * PROFILE_SUB_BITS битам.
+ *
+ * @param value Значение.
+ * @return Номер интервала от 0 до PROFILE_BUCKETS - 1.
+ */
+int histogramBucket(uint64_t value) {
+  int bucket = (int)value;
+  if (value >= PROFILE_SUB_BUCKETS) {
+    int exponent = 63 - __builtin_clzll(value);
+    int shift = exponent - PROFILE_SUB_BITS;
+    bucket = (shift + 1) * PROFILE_SUB_BUCKETS +
+             (int)((value >> shift) & (PROFILE_SUB_BUCKETS - 1));
+  }
+  return bucket;
+}
+
+/**
+ * @brief Возвращает наименьшее значение интервала гистограммы.
+ * @param bucket Номер интервала.
+ * @return Нижняя граница интервала.
+ */
+uint64_t histogramBucketLow(int bucket) {
+  uint64_t low = (uint64_t)bucket;
+  if (bucket >= PROFILE_SUB_BUCKETS) {
+    int shift = bucket / PROFILE_SUB_BUCKETS - 1;
+    uint64_t sub = (uint64_t)(bucket % PROFILE_SUB_BUCKETS);
+    low = (PROFILE_SUB_BUCKETS + sub) << shift;
+  }
+  return low;
+}
+
+/**
+ * @brief Добавляет значение в гистограмму.
+ * @param histogram Указатель на гистограмму.
+ * @param value Значение.
+ */
+void histogramRecord(Histogram *histogram, uint64_t value) {
+  histogram->buckets[histogramBucket(value)]++;
+  histogram->count++;
+  histogram->total += value;
+  if (value > histogram->max) histogram->max = value;
+}
+
+/**
+ * @brief Возвращает процентиль значений гистограммы.
+ *
+ * Результат - верхняя граница интервала, в который попадает процентиль,
+ * но не больше наибольшего записанного значения.
+ *
+ * @param histogram Указатель на гистограмму.
+ * @param percent Процентиль от 0 до 100.
+ * @return Значение процентиля, 0 для пустой гистограммы.
+ */
+uint64_t histogramPercentile(const Histogram *histogram, double percent) {
+  uint64_t result = 0;
+  if (histogram->count) {
+    uint64_t rank = (uint64_t)(percent / 100.0 * (double)histogram->count);
+    if (rank < 1) rank = 1;
+    if (rank > histogram->count) rank = histogram->count;
+    uint64_t seen = 0;
+    int bucket = 0;
+    while (seen + histogram->buckets[bucket] < rank)
+      seen += histogram->buckets[bucket++];
+    result = bucket + 1 < PROFILE_BUCKETS
+                 ? histogramBucketLow(bucket + 1) - 1
+                 : UINT64_MAX;
+    if (result > histogram->max) result = histogram->max;
+  }
+  return result;
+}
+
+#ifdef TETRIS_PROFILE
+
+/**
+ * @struct Profile
+ * @brief Профиль кадра: гистограммы фаз и счётчики событий.
+ */
+typedef struct Profile {
+  Histogram phases[PHASE_COUNT];     ///< Длительности фаз в наносекундах
+  uint64_t counters[COUNTER_COUNT];  ///< Счётчики событий
+} Profile;
+
+static _Thread_local Profile profile; /*!< Профиль потока */
+
+/**
+ * @brief Записывает длительность фазы кадра.
+ * @param phase Фаза.
+ * @param ns Длительность в наносекундах.
+ */
+void profileRecord(ProfilePhase phase, uint64_t ns) {
+  histogramRecord(&profile.phases[phase], ns);
+}
+
+/**
+ * @brief Увеличивает счётчик событий.
+ * @param counter Счётчик.
+ * @param n Количество событий.
+ */
+void profileCount(ProfileCounter counter, uint64_t n) {
+  profile.counters[counter] += n;
+}
+
+/**
+ * @brief Возвращает гистограмму длительностей фазы.
+ * @param phase Фаза.
+ * @return Указатель на гистограмму.
+ */
+const Histogram *profileHistogram(ProfilePhase phase) {
+  return &profile.phases[phase];
+}
+
+/**
+ * @brief Возвращает значение счётчика событий.
+ * @param counter Счётчик.
+ * @return Количество событий.
+ */
+uint64_t profileCounter(ProfileCounter counter) {
+  return profile.counters[counter];
+}
+
+/**
+ * @brief Возвращает название фазы кадра.
+ * @param phase Фаза.
+ * @return Название.
+ */
+const char *profilePhaseName(ProfilePhase phase) {
+  static const char *const names[PHASE_COUNT] = {"input", "logic", "render"};
+  return names[phase];
+}
+
+/**
+ * @brief Возвращает название счётчика событий.
+ * @param counter Счётчик.
+ * @return Название.
+ */
+const char *profileCounterName(ProfileCounter counter) {
+  static const char *const names[COUNTER_COUNT] = {"spawns", "locks",
+                                                   "lines", "allocations"};
+  return names[counter];
+}
+
+/**
+ * @brief Записывает профиль в файл в формате TSV.
+ *
+ * Для каждой фазы выводятся количество измерений, среднее, процентили 50,
+ * 90, 99, 99.9 и наибольшее значение в наносекундах, затем счётчики и
+ * непустые интервалы гистограмм (фаза, нижняя граница, количество).
+ *
+ * @param path Путь к файлу.
+ * @return true, если файл записан.
+ */
+bool profileDump(const char *path) {
+  FILE *file = fopen(path, "w");
+  if (file) {
+    fprintf(file, "phase\tcount\tmean\tp50\tp90\tp99\tp999\tmax\n");
+    for (int i = 0; i < PHASE_COUNT; i++) {
+      const Histogram *h = &profile.phases[i];
+      fprintf(file, "%s\t%llu\t%llu\t%llu\t%llu\t%llu\t%llu\t%llu\n",
+              profilePhaseName((ProfilePhase)i), (unsigned long long)h->count,
+              (unsigned long long)(h->count ? h->total / h->count : 0),
+              (unsigned long long)histogramPercentile(h, 50),
+              (unsigned long long)histogramPercentile(h, 90),
+              (unsigned long long)histogramPercentile(h, 99),
+              (unsigned long long)histogramPercentile(h, 99.9),
+              (unsigned long long)h->max);
+    }
+    fprintf(file, "\ncounter\tvalue\n");
+    for (int i = 0; i < COUNTER_COUNT; i++)
+      fprintf(file, "%s\t%llu\n", profileCounterName((ProfileCounter)i),
+              (unsigned long long)profile.counters[i]);
+    fprintf(file, "\nphase\tlow_ns\tcount\n");
+    for (int i = 0; i < PHASE_COUNT; i++)
+      for (int b = 0; b < PROFILE_BUCKETS; b++)
+        if (profile.phases[i].buckets[b])
+          fprintf(file, "%s\t%llu\t%llu\n", profilePhaseName((ProfilePhase)i),
+                  (unsigned long long)histogramBucketLow(b),
+                  (unsigned long long)profile.phases[i].buckets[b]);
+  }
+  return file && fclose(file) == 0;
+}
+
+#endif
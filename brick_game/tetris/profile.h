@@ -0,0 +1,90 @@
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+/**
+ * @file profile.h
+ * @brief Измерение длительности фаз кадра и счётчики событий игры.
+ *
+ * Включается при сборке определением TETRIS_PROFILE (`make PROFILE=1`).
+ * Без него макросы PROFILE_BEGIN(), PROFILE_END() и PROFILE_COUNT() ничего
+ * не делают, а состояние профиля не создаётся, так что выключенное
+ * измерение ничего не стоит. Гистограммы (Histogram) доступны всегда.
+ *
+ * Длительности записываются в гистограммы с фиксированными
+ * логарифмически-линейными интервалами (как в HdrHistogram): каждая
+ * степень двойки делится на PROFILE_SUB_BUCKETS равных интервалов, поэтому
+ * относительная погрешность значения не больше 1 / PROFILE_SUB_BUCKETS,
+ * а запись - несколько операций без выделения памяти.
+ */
+
+#include "input.h"
+
+#define PROFILE_SUB_BITS 4 /*!< log2 интервалов на степень двойки */
+#define PROFILE_SUB_BUCKETS \
+  (1 << PROFILE_SUB_BITS) /*!< Интервалов на степень двойки */
+#define PROFILE_BUCKETS                  \
+  ((64 - PROFILE_SUB_BITS + 1) *         \
+   PROFILE_SUB_BUCKETS) /*!< Интервалов гистограммы на все uint64_t */
+#define PROFILE_FILE "profile.tsv" /*!< Файл профиля, записываемый при выходе */
+
+/**
+ * @enum ProfilePhase
+ * @brief Измеряемые фазы кадра.
+ */
+typedef enum ProfilePhase {
+  PhaseInput,   ///< Ввод (getActions())
+  PhaseLogic,   ///< Логика игры (stepGame())
+  PhaseRender,  ///< Вывод кадра (printGame())
+  PHASE_COUNT   ///< Количество фаз
+} ProfilePhase;
+
+/**
+ * @enum ProfileCounter
+ * @brief Счётчики событий игры.
+ */
+typedef enum ProfileCounter {
+  CounterSpawns,       ///< Появления фигур
+  CounterLocks,        ///< Фиксации фигур
+  CounterLines,        ///< Удалённые линии
+  CounterAllocations,  ///< Выделения памяти
+  COUNTER_COUNT        ///< Количество счётчиков
+} ProfileCounter;
+
+/**
+ * @struct Histogram
+ * @brief Гистограмма значений с фиксированными интервалами.
+ */
+typedef struct Histogram {
+  uint64_t buckets[PROFILE_BUCKETS];  ///< Количество значений в интервалах
+  uint64_t count;                     ///< Количество значений
+  uint64_t total;                     ///< Сумма значений
+  uint64_t max;                       ///< Наибольшее значение
+} Histogram;
+
+int histogramBucket(uint64_t value);
+uint64_t histogramBucketLow(int bucket);
+void histogramRecord(Histogram *histogram, uint64_t value);
+uint64_t histogramPercentile(const Histogram *histogram, double percent);
+
+#ifdef TETRIS_PROFILE
+#define PROFILE_BEGIN(start) \
+  uint64_t start = monotonicNs() /*!< Начало измерения фазы */
+#define PROFILE_END(phase, start) \
+  profileRecord(phase, monotonicNs() - (start)) /*!< Конец измерения фазы */
+#define PROFILE_COUNT(counter, n) \
+  profileCount(counter, (uint64_t)(n)) /*!< Увеличение счётчика */
+
+void profileRecord(ProfilePhase phase, uint64_t ns);
+void profileCount(ProfileCounter counter, uint64_t n);
+const Histogram *profileHistogram(ProfilePhase phase);
+uint64_t profileCounter(ProfileCounter counter);
+const char *profilePhaseName(ProfilePhase phase);
+const char *profileCounterName(ProfileCounter counter);
+bool profileDump(const char *path);
+#else
+#define PROFILE_BEGIN(start) ((void)0)     /*!< Измерение выключено */
+#define PROFILE_END(phase, start) ((void)0) /*!< Измерение выключено */
+#define PROFILE_COUNT(counter, n) ((void)0) /*!< Измерение выключено */
+#endif
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ * @file random.c
+ * @brief Генератор псевдослучайных чисел PCG32.
+ *
+ * Заменяет глобальный rand(): состояние генератора хранится в каждой игре,
+ * поэтому игры можно запускать в нескольких потоках без блокировок, а
+ * одинаковое начальное значение даёт одинаковую последовательность фигур.
+ * Игру можно воспроизвести по начальному значению и действиям игрока.
+ */
+
+#include "tetris.h"
+
+#define RANDOM_MULTIPLIER 6364136223846793005ULL /*!< Множитель PCG32 */
+#define RANDOM_STREAM 0xda3e39cb94b95bdbULL /*!< Номер последовательности */
+
+/**
+ * @brief Инициализирует генератор начальным значением.
+ * @param random Указатель на генератор.
+ * @param seed Начальное значение.
+ */
+void seedRandom(Random *random, uint64_t seed) {
+  random->state = 0;
+  random->inc = (RANDOM_STREAM << 1) | 1;
+  nextRandom(random);
+  random->state += seed;
+  nextRandom(random);
+}
+
+/**
+ * @brief Возвращает следующее 32-битное псевдослучайное число.
+ * @param random Указатель на генератор.
+ * @return Псевдослучайное число.
+ */
+uint32_t nextRandom(Random *random) {
+  uint64_t old = random->state;
+  random->state = old * RANDOM_MULTIPLIER + random->inc;
+  uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+  uint32_t rot = (uint32_t)(old >> 59);
+  return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+}
+
+/**
+ * @brief Возвращает псевдослучайное число в диапазоне [0, n).
+ * @param random Указатель на генератор.
+ * @param n Размер диапазона.
+ * @return Псевдослучайное число от 0 до n - 1.
+ */
+int randomRange(Random *random, int n) {
+  return (int)(((uint64_t)nextRandom(random) * (uint32_t)n) >> 32);
+}
+
+/**
+ * @brief Выбирает следующую фигуру.
+ *
+ * В обычном режиме все фигуры равновероятны. В режиме "мешка" фигуры
+ * выдаются наборами, в которых каждая из FIGURES_COUNT фигур встречается
+ * ровно один раз в случайном порядке.
+ *
+ * @param gameInfo Указатель на информацию об игре.
+ * @return Идентификатор фигуры.
+ */
+int randomFigure(GameInfo *gameInfo) {
+  int id;
+  if (gameInfo->useBag) {
+    if (gameInfo->bagLeft == 0) {
+      for (int i = 0; i < FIGURES_COUNT; i++) {
+        int j = randomRange(&gameInfo->random, i + 1);
+        gameInfo->bag[i] = gameInfo->bag[j];
+        gameInfo->bag[j] = (uint8_t)i;
+      }
+      gameInfo->bagLeft = FIGURES_COUNT;
+    }
+    id = gameInfo->bag[--gameInfo->bagLeft];
+  } else {
+    id = randomRange(&gameInfo->random, FIGURES_COUNT);
+  }
+  return id;
+}
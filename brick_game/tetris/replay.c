@@ -0,0 +1,271 @@
+/**
+ * @file replay.c
+ * @brief Запись и воспроизведение игр.
+ *
+ * Повтор содержит начальное значение генератора фигур и действие игрока на
+ * каждой итерации игрового цикла (см. stepGame()). Этого достаточно, чтобы
+ * без интерфейса и с максимальной скоростью повторить игру и сравнить
+ * итоговый счёт и хеш поля с записанными.
+ *
+ * Формат файла (целые числа в little-endian):
+ * - "TRPL", версия (1 байт), флаги (1 байт, бит 0 - мешок из 7 фигур),
+ *   2 резервных байта;
+ * - seed (8 байт), количество итераций (8 байт), счёт (4 байта),
+ *   хеш поля (8 байт), размер потока (4 байта);
+ * - поток серий действий (см. Replay).
+ */
+
+#include "replay.h"
+
+#include <string.h>
+
+#define REPLAY_MAGIC "TRPL"   /*!< Сигнатура файла повтора */
+#define REPLAY_HEADER_SIZE 40 /*!< Размер заголовка файла */
+#define REPLAY_RUN_LIMIT 15   /*!< Наибольшая длина серии в байте серии */
+
+/**
+ * @brief Создаёт пустую запись для игры.
+ * @param gameInfo Информация об игре, из которой берутся параметры
+ * генератора фигур. Запись должна начинаться сразу после initGameWith().
+ * @return Указатель на запись.
+ */
+Replay *createReplay(const GameInfo *gameInfo) {
+  Replay *replay = (Replay *)calloc(1, sizeof(Replay));
+  if (replay) {
+    replay->seed = gameInfo->seed;
+    replay->useBag = gameInfo->useBag;
+  }
+  return replay;
+}
+
+/**
+ * @brief Освобождает память, занятую записью.
+ * @param replay Указатель на запись.
+ */
+void freeReplay(Replay *replay) {
+  if (replay) {
+    free(replay->data);
+    free(replay);
+  }
+}
+
+/**
+ * @brief Добавляет байт в поток записи, при необходимости расширяя буфер.
+ *
+ * Если буфер расширить не удалось, байт отбрасывается, а запись отмечается
+ * как неполная: saveReplay() такую запись не сохраняет.
+ *
+ * @param replay Указатель на запись.
+ * @param byte Добавляемый байт.
+ */
+static void putByte(Replay *replay, uint8_t byte) {
+  if (replay->size == replay->capacity) {
+    size_t capacity = replay->capacity ? replay->capacity * 2 : 256;
+    uint8_t *data = (uint8_t *)realloc(replay->data, capacity);
+    if (data) {
+      replay->data = data;
+      replay->capacity = capacity;
+    } else {
+      replay->failed = true;
+    }
+  }
+  if (replay->size < replay->capacity) replay->data[replay->size++] = byte;
+}
+
+/**
+ * @brief Записывает незаконченную серию действий в поток.
+ * @param replay Указатель на запись.
+ */
+static void flushRun(Replay *replay) {
+  if (replay->run) {
+    uint64_t length = replay->run - 1;
+    uint64_t head = length < REPLAY_RUN_LIMIT ? length : REPLAY_RUN_LIMIT;
+    putByte(replay, (uint8_t)(replay->action | head << 4));
+    if (head == REPLAY_RUN_LIMIT) {
+      length -= REPLAY_RUN_LIMIT;
+      while (length >= 0x80) {
+        putByte(replay, (uint8_t)(length | 0x80));
+        length >>= 7;
+      }
+      putByte(replay, (uint8_t)length);
+    }
+    replay->run = 0;
+  }
+}
+
+/**
+ * @brief Записывает действие игрока на очередной итерации игрового цикла.
+ * @param replay Указатель на запись.
+ * @param action Действие, переданное в stepGame().
+ */
+void recordAction(Replay *replay, UserAction action) {
+  if (replay->run && replay->action != action) flushRun(replay);
+  replay->action = action;
+  replay->run++;
+  replay->ticks++;
+}
+
+/**
+ * @brief Завершает запись и запоминает итоговое состояние игры.
+ * @param replay Указатель на запись.
+ * @param game Игра, для которой велась запись.
+ */
+void finishReplay(Replay *replay, const Game *game) {
+  flushRun(replay);
+  replay->score = game->gameInfo->score;
+  replay->hash = game->field->hash;
+}
+
+/**
+ * @brief Записывает целое число в буфер в порядке little-endian.
+ */
+static void putInt(uint8_t *buffer, uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; i++) buffer[i] = (uint8_t)(value >> (8 * i));
+}
+
+/**
+ * @brief Читает целое число из буфера в порядке little-endian.
+ */
+static uint64_t getInt(const uint8_t *buffer, int bytes) {
+  uint64_t value = 0;
+  for (int i = 0; i < bytes; i++) value |= (uint64_t)buffer[i] << (8 * i);
+  return value;
+}
+
+/**
+ * @brief Сохраняет запись в файл.
+ *
+ * Запись должна быть завершена вызовом finishReplay().
+ *
+ * @param replay Указатель на запись.
+ * @param path Путь к файлу.
+ * @return true при успешной записи, иначе false (в том числе если поток
+ * записан не полностью из-за нехватки памяти; файл тогда не создаётся).
+ */
+bool saveReplay(Replay *replay, const char *path) {
+  uint8_t header[REPLAY_HEADER_SIZE] = {0};
+  memcpy(header, REPLAY_MAGIC, 4);
+  header[4] = REPLAY_VERSION;
+  header[5] = replay->useBag ? 1 : 0;
+  putInt(header + 8, replay->seed, 8);
+  putInt(header + 16, replay->ticks, 8);
+  putInt(header + 24, (uint32_t)replay->score, 4);
+  putInt(header + 28, replay->hash, 8);
+  putInt(header + 36, replay->size, 4);
+
+  bool result = false;
+  FILE *file = replay->failed ? NULL : fopen(path, "wb");
+  if (file) {
+    result = fwrite(header, 1, sizeof(header), file) == sizeof(header) &&
+             fwrite(replay->data, 1, replay->size, file) == replay->size;
+    result = fclose(file) == 0 && result;
+  }
+  return result;
+}
+
+/**
+ * @brief Возвращает количество байт файла после текущей позиции.
+ * @param file Файл, открытый на чтение.
+ * @return Количество байт или -1, если размер файла определить не удалось.
+ */
+static long remainingBytes(FILE *file) {
+  long result = -1;
+  long pos = ftell(file);
+  if (pos >= 0 && fseek(file, 0, SEEK_END) == 0) {
+    long end = ftell(file);
+    if (fseek(file, pos, SEEK_SET) == 0 && end >= pos) result = end - pos;
+  }
+  return result;
+}
+
+/**
+ * @brief Загружает запись из файла.
+ *
+ * Размер потока из заголовка должен совпадать с остатком файла, поэтому
+ * повреждённый заголовок не приводит к выделению лишней памяти.
+ *
+ * @param path Путь к файлу.
+ * @return Указатель на запись или NULL, если файл не удалось прочитать.
+ */
+Replay *loadReplay(const char *path) {
+  Replay *replay = NULL;
+  uint8_t header[REPLAY_HEADER_SIZE];
+  FILE *file = fopen(path, "rb");
+  if (file) {
+    if (fread(header, 1, sizeof(header), file) == sizeof(header) &&
+        memcmp(header, REPLAY_MAGIC, 4) == 0 &&
+        header[4] == REPLAY_VERSION &&
+        getInt(header + 36, 4) == (uint64_t)remainingBytes(file))
+      replay = (Replay *)calloc(1, sizeof(Replay));
+    if (replay) {
+      replay->useBag = header[5] & 1;
+      replay->seed = getInt(header + 8, 8);
+      replay->ticks = getInt(header + 16, 8);
+      replay->score = (int)(uint32_t)getInt(header + 24, 4);
+      replay->hash = getInt(header + 28, 8);
+      replay->size = getInt(header + 36, 4);
+      replay->capacity = replay->size;
+      replay->data = (uint8_t *)malloc(replay->size ? replay->size : 1);
+      if (!replay->data ||
+          fread(replay->data, 1, replay->size, file) != replay->size) {
+        freeReplay(replay);
+        replay = NULL;
+      }
+    }
+    fclose(file);
+  }
+  return replay;
+}
+
+/**
+ * @brief Воспроизводит запись без интерфейса.
+ *
+ * Игра должна быть создана с параметрами записи (seed, useBag) и не должна
+ * изменяться до воспроизведения. Воспроизведение прерывается на серии с
+ * несуществующим действием и на серии, после которой итераций стало бы
+ * больше, чем записано в заголовке, поэтому повреждённый поток не может
+ * выполняться неограниченно долго.
+ *
+ * @param replay Указатель на запись.
+ * @param game Указатель на игру.
+ * @return Количество выполненных итераций игрового цикла или
+ * REPLAY_INVALID, если поток повреждён.
+ */
+uint64_t playReplay(const Replay *replay, Game *game) {
+  uint64_t ticks = 0;
+  size_t pos = 0;
+  while (pos < replay->size && ticks != REPLAY_INVALID) {
+    uint8_t byte = replay->data[pos++];
+    UserAction action = (UserAction)(byte & 0x0F);
+    uint64_t length = byte >> 4;
+    if (length == REPLAY_RUN_LIMIT) {
+      uint64_t extra = 0;
+      int shift = 0;
+      uint8_t next = 0x80;
+      while (pos < replay->size && (next & 0x80) && shift < 64) {
+        next = replay->data[pos++];
+        extra |= (uint64_t)(next & 0x7F) << shift;
+        shift += 7;
+      }
+      length += extra;
+    }
+    if (action > HARD_DROP || length >= replay->ticks - ticks) {
+      ticks = REPLAY_INVALID;
+    } else {
+      for (uint64_t i = 0; i <= length; i++) stepGame(game, action);
+      ticks += length + 1;
+    }
+  }
+  return ticks;
+}
+
+/**
+ * @brief Сравнивает состояние игры с итогом, сохранённым в записи.
+ * @param replay Указатель на запись.
+ * @param game Указатель на игру после playReplay().
+ * @return true, если счёт и хеш поля совпадают.
+ */
+bool checkReplay(const Replay *replay, const Game *game) {
+  return game->gameInfo->score == replay->score &&
+         game->field->hash == replay->hash;
+}
@@ -0,0 +1,41 @@
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include "tetris.h"
+
+#define REPLAY_VERSION 3 /*!< Версия формата файла повтора */
+#define REPLAY_INVALID UINT64_MAX /*!< playReplay(): поток повреждён */
+
+/**
+ * @struct Replay
+ * @brief Запись игры: начальное значение генератора и действия по тикам.
+ *
+ * Действия хранятся сериями (RLE): байт серии содержит действие в младших
+ * четырёх битах и длину серии минус один в старших. Если длина не
+ * помещается (15 и больше), после байта следует остаток длины в формате
+ * varint. Одна секунда игры занимает несколько байт.
+ */
+typedef struct Replay {
+  uint64_t seed;      ///< Начальное значение генератора фигур
+  bool useBag;        ///< Генератор "мешок из 7 фигур"
+  uint64_t ticks;     ///< Количество записанных итераций игрового цикла
+  int score;          ///< Счёт в конце записи
+  uint64_t hash;      ///< Хеш Зобриста поля в конце записи (Field::hash)
+  uint8_t *data;      ///< Поток серий действий
+  size_t size;        ///< Размер потока в байтах
+  size_t capacity;    ///< Выделенный размер потока
+  UserAction action;  ///< Действие незаписанной серии
+  uint64_t run;       ///< Длина незаписанной серии
+  bool failed;        ///< Не хватило памяти, поток записан не полностью
+} Replay;
+
+Replay *createReplay(const GameInfo *gameInfo);
+void freeReplay(Replay *replay);
+void recordAction(Replay *replay, UserAction action);
+void finishReplay(Replay *replay, const Game *game);
+bool saveReplay(Replay *replay, const char *path);
+Replay *loadReplay(const char *path);
+uint64_t playReplay(const Replay *replay, Game *game);
+bool checkReplay(const Replay *replay, const Game *game);
+
+#endif
@@ -0,0 +1,239 @@
+/**
+ * @file search.c
+ * @brief Параллельная оценка мест фигуры на пуле потоков.
+ *
+ * Поиск одного хода раскладывает места текущей фигуры по очередям потоков
+ * по кругу и будит потоки. Каждый поток оценивает места из своей очереди
+ * (scorePlacement(), с учётом следующей фигуры при включённом просмотре
+ * вперёд), а опустев, забирает места из начала чужих очередей. Вызывающий
+ * поток ждёт, пока не будут оценены все места, и выбирает лучшее тем же
+ * правилом, что и последовательный поиск, поэтому результат не зависит от
+ * количества потоков.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "search.h"
+
+/**
+ * @brief Возвращает текущее время монотонных часов в секундах.
+ * @return Время в секундах.
+ */
+static double searchClock() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Кладёт задачу в конец очереди.
+ *
+ * Между поисками все очереди пусты, поэтому пустая очередь начинается
+ * с начала массива и не переполняется.
+ *
+ * @param deque Указатель на очередь.
+ * @param task Номер места.
+ */
+static void pushTask(SearchDeque *deque, int task) {
+  pthread_mutex_lock(&deque->mutex);
+  if (deque->head == deque->tail) deque->head = deque->tail = 0;
+  deque->tasks[deque->tail++] = task;
+  pthread_mutex_unlock(&deque->mutex);
+}
+
+/**
+ * @brief Берёт задачу из конца своей очереди.
+ * @param deque Указатель на очередь.
+ * @return Номер места или -1, если очередь пуста.
+ */
+static int popTask(SearchDeque *deque) {
+  int task = -1;
+  pthread_mutex_lock(&deque->mutex);
+  if (deque->tail > deque->head) task = deque->tasks[--deque->tail];
+  pthread_mutex_unlock(&deque->mutex);
+  return task;
+}
+
+/**
+ * @brief Забирает задачу из начала очереди другого потока.
+ * @param worker Указатель на поток, ищущий работу.
+ * @return Номер места или -1, если все очереди пусты.
+ */
+static int stealTask(SearchWorker *worker) {
+  SearchPool *pool = worker->pool;
+  int task = -1;
+  for (int k = 1; k < pool->threads && task < 0; k++) {
+    SearchDeque *victim =
+        &pool->workers[(worker->id + k) % pool->threads].deque;
+    pthread_mutex_lock(&victim->mutex);
+    if (victim->tail > victim->head) task = victim->tasks[victim->head++];
+    pthread_mutex_unlock(&victim->mutex);
+  }
+  if (task >= 0) worker->steals++;
+  return task;
+}
+
+/**
+ * @brief Оценивает места, пока в очередях есть задачи.
+ * @param worker Указатель на поток.
+ */
+static void runTasks(SearchWorker *worker) {
+  SearchPool *pool = worker->pool;
+  int task;
+  while ((task = popTask(&worker->deque)) >= 0 ||
+         (task = stealTask(worker)) >= 0) {
+    Placement *placement = &pool->placements[task];
+    placement->score = scorePlacement(pool->ai, &pool->field,
+                                      &placement->figure, pool->nextID,
+                                      &worker->counters);
+    worker->tasks++;
+    if (atomic_fetch_sub(&pool->pending, 1) == 1) {
+      pthread_mutex_lock(&pool->mutex);
+      pthread_cond_signal(&pool->done);
+      pthread_mutex_unlock(&pool->mutex);
+    }
+  }
+}
+
+/**
+ * @brief Функция потока пула: ждёт поиска и выполняет его задачи.
+ * @param arg Указатель на SearchWorker.
+ * @return NULL.
+ */
+static void *runSearchWorker(void *arg) {
+  SearchWorker *worker = (SearchWorker *)arg;
+  SearchPool *pool = worker->pool;
+  unsigned seen = 0;
+
+  pthread_mutex_lock(&pool->mutex);
+  while (!pool->stop) {
+    if (pool->generation == seen) {
+      pthread_cond_wait(&pool->start, &pool->mutex);
+    } else {
+      seen = pool->generation;
+      pthread_mutex_unlock(&pool->mutex);
+      runTasks(worker);
+      pthread_mutex_lock(&pool->mutex);
+    }
+  }
+  pthread_mutex_unlock(&pool->mutex);
+  return NULL;
+}
+
+/**
+ * @brief Создаёт пул потоков поиска.
+ * @param threads Количество потоков (не меньше 1).
+ * @return Указатель на пул или NULL, если не удалось выделить память.
+ */
+SearchPool *createSearchPool(int threads) {
+  if (threads < 1) threads = 1;
+  SearchPool *pool = (SearchPool *)calloc(1, sizeof(SearchPool));
+  if (pool)
+    pool->workers = (SearchWorker *)calloc(threads, sizeof(SearchWorker));
+  if (pool && !pool->workers) {
+    free(pool);
+    pool = NULL;
+  }
+
+  if (pool) {
+    pool->threads = threads;
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    atomic_init(&pool->pending, 0);
+    for (int i = 0; i < threads; i++) {
+      pool->workers[i].pool = pool;
+      pool->workers[i].id = i;
+      pthread_mutex_init(&pool->workers[i].deque.mutex, NULL);
+    }
+    for (int i = 0; i < threads; i++)
+      pthread_create(&pool->workers[i].thread, NULL, runSearchWorker,
+                     &pool->workers[i]);
+  }
+  return pool;
+}
+
+/**
+ * @brief Останавливает потоки и освобождает пул.
+ * @param pool Указатель на пул или NULL.
+ */
+void freeSearchPool(SearchPool *pool) {
+  if (pool) {
+    pthread_mutex_lock(&pool->mutex);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int i = 0; i < pool->threads; i++) {
+      pthread_join(pool->workers[i].thread, NULL);
+      pthread_mutex_destroy(&pool->workers[i].deque.mutex);
+    }
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+    free(pool->workers);
+    free(pool);
+  }
+}
+
+/**
+ * @brief Выбирает лучшее место для текущей фигуры, оценивая места
+ * параллельно.
+ *
+ * Результат совпадает с bestPlacement(). Количество оценённых полей
+ * добавляется к счётчику игрока.
+ *
+ * @param pool Указатель на пул.
+ * @param ai Указатель на игрока.
+ * @param game Указатель на игру.
+ * @return Лучшее место.
+ */
+Placement parallelPlacement(SearchPool *pool, Autoplayer *ai,
+                            const Game *game) {
+  double start = searchClock();
+  SearchStats before = searchStats(pool);
+
+  int count = findPlacements(game->field, game->figure, pool->placements);
+  pool->ai = ai;
+  pool->field = *game->field;
+  pool->nextID = game->gameInfo->nextID;
+  atomic_store(&pool->pending, count);
+  for (int i = 0; i < count; i++)
+    pushTask(&pool->workers[i % pool->threads].deque, i);
+
+  pthread_mutex_lock(&pool->mutex);
+  if (count > 0) {
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+  }
+  while (atomic_load(&pool->pending) > 0)
+    pthread_cond_wait(&pool->done, &pool->mutex);
+  pthread_mutex_unlock(&pool->mutex);
+
+  SearchStats after = searchStats(pool);
+  ai->counters.evaluations += after.nodes - before.nodes;
+  ai->counters.probes += after.probes - before.probes;
+  ai->counters.hits += after.hits - before.hits;
+  pool->searches++;
+  pool->seconds += searchClock() - start;
+  return choosePlacement(game->figure, pool->placements, count);
+}
+
+/**
+ * @brief Возвращает счётчики пула.
+ *
+ * Вызывается из потока, выполняющего поиски, между поисками.
+ *
+ * @param pool Указатель на пул.
+ * @return Счётчики всех потоков пула.
+ */
+SearchStats searchStats(const SearchPool *pool) {
+  SearchStats stats = {pool->searches, 0, 0, 0, 0, 0, pool->seconds};
+  for (int i = 0; i < pool->threads; i++) {
+    stats.tasks += pool->workers[i].tasks;
+    stats.nodes += pool->workers[i].counters.evaluations;
+    stats.probes += pool->workers[i].counters.probes;
+    stats.hits += pool->workers[i].counters.hits;
+    stats.steals += pool->workers[i].steals;
+  }
+  return stats;
+}
@@ -0,0 +1,82 @@
+#ifndef SEARCH_H_
+#define SEARCH_H_
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "ai.h"
+
+/**
+ * @struct SearchStats
+ * @brief Счётчики параллельного поиска.
+ */
+typedef struct SearchStats {
+  long long searches;  ///< Выполнено поисков (выборов места)
+  long long tasks;     ///< Оценено мест первого уровня
+  long long nodes;     ///< Оценено полей (см. AiCounters::evaluations)
+  long long probes;    ///< Поисков в таблице транспозиций
+  long long hits;      ///< Найденных в таблице записей
+  long long steals;    ///< Задач, взятых из очередей других потоков
+  double seconds;      ///< Суммарное время поисков в секундах
+} SearchStats;
+
+/**
+ * @struct SearchDeque
+ * @brief Очередь задач одного потока.
+ *
+ * Задача - номер оцениваемого места в SearchPool::placements. Владелец
+ * берёт задачи с конца очереди, другие потоки забирают их с начала.
+ */
+typedef struct SearchDeque {
+  pthread_mutex_t mutex;            ///< Защищает очередь
+  int tasks[AI_MAX_PLACEMENTS];     ///< Номера мест
+  int head;                         ///< Начало очереди (для кражи)
+  int tail;                         ///< Конец очереди (для владельца)
+} SearchDeque;
+
+/**
+ * @struct SearchWorker
+ * @brief Поток пула поиска.
+ */
+typedef struct SearchWorker {
+  pthread_t thread;         ///< Идентификатор потока
+  struct SearchPool *pool;  ///< Пул, которому принадлежит поток
+  int id;                   ///< Номер потока в пуле
+  SearchDeque deque;        ///< Очередь задач потока
+  long long tasks;          ///< Выполнено задач
+  AiCounters counters;      ///< Счётчики оценок потока
+  long long steals;         ///< Украдено задач
+} SearchWorker;
+
+/**
+ * @struct SearchPool
+ * @brief Пул потоков для параллельной оценки мест фигуры.
+ *
+ * Места текущей фигуры раздаются по очередям потоков, а освободившийся
+ * поток забирает задачи из чужих очередей ("work stealing"). Поэтому места,
+ * оценка которых с учётом следующей фигуры дороже, не задерживают поиск.
+ */
+typedef struct SearchPool {
+  int threads;              ///< Количество потоков
+  SearchWorker *workers;    ///< Потоки
+  pthread_mutex_t mutex;    ///< Защищает generation, stop и ожидание
+  pthread_cond_t start;     ///< Сигнал о новом поиске
+  pthread_cond_t done;      ///< Сигнал о завершении поиска
+  unsigned generation;      ///< Номер текущего поиска
+  bool stop;                ///< Потоки должны завершиться
+  atomic_int pending;       ///< Неоценённых мест в текущем поиске
+  const Autoplayer *ai;     ///< Игрок текущего поиска
+  Field field;              ///< Поле текущего поиска
+  int nextID;               ///< Следующая фигура текущего поиска
+  Placement placements[AI_MAX_PLACEMENTS];  ///< Места и их оценки
+  long long searches;       ///< Выполнено поисков
+  double seconds;           ///< Суммарное время поисков
+} SearchPool;
+
+SearchPool *createSearchPool(int threads);
+void freeSearchPool(SearchPool *pool);
+Placement parallelPlacement(SearchPool *pool, Autoplayer *ai,
+                            const Game *game);
+SearchStats searchStats(const SearchPool *pool);
+
+#endif
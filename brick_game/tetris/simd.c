@@ -0,0 +1,486 @@
+/**
+ * @file simd.c
+ * @brief Векторные ядра пакетной проверки столкновений и заполненных строк.
+ *
+ * Для каждой операции над набором игр (collideBatch(), fullRowsBatch())
+ * есть три реализации: скалярная, SSE4.1 и AVX2. Векторные варианты
+ * компилируются атрибутом `target`, поэтому сборка не требует флагов
+ * `-m...`, а выбор реализации делается во время выполнения по
+ * __builtin_cpu_supports() (см. batchIsa(), setBatchIsa()). На платформах
+ * кроме x86 собирается только скалярный вариант.
+ *
+ * Проверка столкновений обрабатывает за одну команду 8 игр (AVX2) или 4
+ * игры (SSE4.1) в 32-битных дорожках: строки 0-1 и 2-3 формы и окна поля
+ * лежат в двух словах, как в 64-битном слове скалярного варианта. AVX2
+ * читает строки полей и форм командами gather и сдвигает формы на
+ * разные расстояния командами sllv/srlv. В SSE4.1 этих команд нет:
+ * слова вставляются в регистр командами pinsrd (gatherSse41()), а сдвиг
+ * заменяется умножением на степень двойки; при отрицательном `x` вместо
+ * формы вправо сдвигается окно поля влево, что даёт тот же результат для
+ * всех положений внутри стен.
+ *
+ * Заполненные строки ищутся сравнением 16-битных масок строк с
+ * FIELD_FULL_ROW: 16 строк за команду (AVX2) или 8 строк (SSE4.1), поле
+ * одной игры - две или три команды.
+ */
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "batch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BATCH_X86 1 /*!< Собирать векторные ядра x86 */
+#include <immintrin.h>
+#else
+#define BATCH_X86 0 /*!< Собирать векторные ядра x86 */
+#endif
+
+#define BATCH_SHAPE_WORDS \
+  (sizeof(BatchShape) / 4) /*!< 32-битных слов в BatchShape */
+#define BATCH_LAST_WORD \
+  (offsetof(BatchShape, last) / 4) /*!< Слово с last, left и right */
+#define BATCH_MAX_Y \
+  (BATCH_ROWS - BATCH_TOP - FIGURE_HEIGHT) /*!< Наибольшая проверяемая y */
+
+_Static_assert(sizeof(BatchShape) % 4 == 0 &&
+                   offsetof(BatchShape, last) % 4 == 0 &&
+                   offsetof(BatchShape, left) ==
+                       offsetof(BatchShape, last) + 2 &&
+                   offsetof(BatchShape, right) ==
+                       offsetof(BatchShape, last) + 3,
+               "BatchShape layout is read by 32-bit gathers");
+_Static_assert(BATCH_TOP + FIELD_HEIGHT <= 24,
+               "SSE4.1 line kernel reads 24 rows");
+
+static atomic_int activeIsa = -1; /*!< Выбранный набор команд, -1 - не
+                                       выбран */
+
+/**
+ * @brief Проверяет столкновения одной игры набора.
+ * @param batch Указатель на набор.
+ * @param b Номер игры.
+ * @return 1, если фигура в проверяемом положении сталкивается.
+ */
+static uint8_t collideOne(const GameBatch *batch, int b) {
+  const BatchShape *shape = &batch->shapes[batch->id[b]][batch->crotation[b]];
+  int x = batch->cx[b] < -FIELD_WIDTH  ? -FIELD_WIDTH
+          : batch->cx[b] > FIELD_WIDTH ? FIELD_WIDTH
+                                       : batch->cx[b];
+  int y = batch->cy[b] < -BATCH_TOP    ? -BATCH_TOP
+          : batch->cy[b] > BATCH_MAX_Y ? BATCH_MAX_Y
+                                       : batch->cy[b];
+  const uint16_t *rows = &batch->rows[b][BATCH_TOP + y];
+  uint64_t window = (uint64_t)rows[0] | (uint64_t)rows[1] << 16 |
+                    (uint64_t)rows[2] << 32 | (uint64_t)rows[3] << 48;
+  uint64_t figure = x >= 0 ? shape->rows << x : shape->rows >> -x;
+  uint32_t last =
+      x >= 0 ? (uint32_t)shape->last << x : (uint32_t)shape->last >> -x;
+  return (x + shape->left < 0) | (x + shape->right >= FIELD_WIDTH) |
+         ((figure & window) != 0) | ((last & rows[FIGURE_HEIGHT - 1]) != 0);
+}
+
+/**
+ * @brief Скалярная проверка столкновений игр с номерами [from, to).
+ *
+ * Четыре строки поля под фигурой читаются одним 64-битным словом и
+ * сравниваются с четырьмя строками формы одной операцией AND.
+ *
+ * @param batch Указатель на набор.
+ * @param from Первая игра.
+ * @param to Игра после последней.
+ */
+static void collideScalar(GameBatch *batch, int from, int to) {
+  for (int b = from; b < to; b++) batch->hit[b] = collideOne(batch, b);
+}
+
+/**
+ * @brief Скалярный поиск заполненных строк полей игр [from, to).
+ * @param batch Указатель на набор.
+ * @param full Маски заполненных строк по играм.
+ * @param from Первая игра.
+ * @param to Игра после последней.
+ */
+static void fullRowsScalar(const GameBatch *batch, uint32_t *full, int from,
+                           int to) {
+  for (int b = from; b < to; b++) {
+    uint32_t mask = 0;
+    for (int i = 0; i < FIELD_HEIGHT; i++)
+      if (batch->rows[b][BATCH_TOP + i] == FIELD_FULL_ROW) mask |= 1u << i;
+    full[b] = mask;
+  }
+}
+
+#if BATCH_X86
+
+/**
+ * @brief Читает 32-битное слово по невыровненному адресу.
+ * @param data Адрес слова.
+ * @return Слово.
+ */
+static int loadWord(const void *data) {
+  int word;
+  memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+/**
+ * @brief Возвращает 2^s в каждой 32-битной дорожке (0 <= s < 31).
+ *
+ * Показатель степени записывается в поле экспоненты числа с плавающей
+ * точкой, которое затем переводится в целое.
+ *
+ * @param s Показатели степени.
+ * @return Степени двойки.
+ */
+__attribute__((target("sse4.1"))) static __m128i powersSse41(__m128i s) {
+  __m128i bits = _mm_slli_epi32(_mm_add_epi32(s, _mm_set1_epi32(127)), 23);
+  return _mm_cvttps_epi32(_mm_castsi128_ps(bits));
+}
+
+/**
+ * @brief Собирает четыре 32-битных слова в вектор (SSE4.1).
+ *
+ * Слова вставляются в дорожки командой pinsrd сразу после чтения: сборка
+ * через массив в памяти и последующее 16-байтное чтение упирается в
+ * несработавшую передачу данных из очереди записи.
+ *
+ * @param at Адреса для дорожек 0-3.
+ * @param offset Смещение слова от адреса в байтах.
+ * @return Вектор слов.
+ */
+__attribute__((target("sse4.1"))) static __m128i gatherSse41(
+    const char *const *at, int offset) {
+  __m128i words = _mm_cvtsi32_si128(loadWord(at[0] + offset));
+  words = _mm_insert_epi32(words, loadWord(at[1] + offset), 1);
+  words = _mm_insert_epi32(words, loadWord(at[2] + offset), 2);
+  return _mm_insert_epi32(words, loadWord(at[3] + offset), 3);
+}
+
+/**
+ * @brief Проверка столкновений четырёх игр за итерацию (SSE4.1).
+ * @param batch Указатель на набор.
+ * @param from Первая игра.
+ * @param to Игра после последней.
+ */
+__attribute__((target("sse4.1"))) static void collideSse41(GameBatch *batch,
+                                                           int from, int to) {
+  const char *rows = (const char *)batch->rows;
+  const char *shapes = (const char *)batch->shapes;
+  const __m128i zero = _mm_setzero_si128();
+  int b = from;
+  for (; b + 4 <= to; b += 4) {
+    __m128i x = _mm_loadu_si128((const __m128i *)(const void *)(batch->cx + b));
+    __m128i y = _mm_loadu_si128((const __m128i *)(const void *)(batch->cy + b));
+    __m128i id =
+        _mm_loadu_si128((const __m128i *)(const void *)(batch->id + b));
+    __m128i rotation =
+        _mm_loadu_si128((const __m128i *)(const void *)(batch->crotation + b));
+    x = _mm_min_epi32(_mm_max_epi32(x, _mm_set1_epi32(-FIELD_WIDTH)),
+                      _mm_set1_epi32(FIELD_WIDTH));
+    y = _mm_min_epi32(_mm_max_epi32(y, _mm_set1_epi32(-BATCH_TOP)),
+                      _mm_set1_epi32(BATCH_MAX_Y));
+
+    __m128i board =
+        _mm_add_epi32(_mm_set1_epi32(b), _mm_setr_epi32(0, 1, 2, 3));
+    __m128i row = _mm_add_epi32(
+        _mm_mullo_epi32(board, _mm_set1_epi32(BATCH_ROWS)),
+        _mm_add_epi32(y, _mm_set1_epi32(BATCH_TOP)));
+    __m128i shape = _mm_add_epi32(
+        _mm_mullo_epi32(id, _mm_set1_epi32(ROTATIONS_COUNT)), rotation);
+    const char *window[4];
+    const char *form[4];
+    window[0] = rows + 2 * _mm_cvtsi128_si32(row);
+    window[1] = rows + 2 * _mm_extract_epi32(row, 1);
+    window[2] = rows + 2 * _mm_extract_epi32(row, 2);
+    window[3] = rows + 2 * _mm_extract_epi32(row, 3);
+    form[0] = shapes + sizeof(BatchShape) * _mm_cvtsi128_si32(shape);
+    form[1] = shapes + sizeof(BatchShape) * _mm_extract_epi32(shape, 1);
+    form[2] = shapes + sizeof(BatchShape) * _mm_extract_epi32(shape, 2);
+    form[3] = shapes + sizeof(BatchShape) * _mm_extract_epi32(shape, 3);
+
+    __m128i windowLow = gatherSse41(window, 0);
+    __m128i windowHigh = gatherSse41(window, 4);
+    __m128i below = _mm_srli_epi32(gatherSse41(window, 6), 16);
+    __m128i formLow = gatherSse41(form, 0);
+    __m128i formHigh = gatherSse41(form, 4);
+    __m128i tail = gatherSse41(form, 4 * BATCH_LAST_WORD);
+
+    __m128i formShift = powersSse41(_mm_max_epi32(x, zero));
+    __m128i fieldShift =
+        powersSse41(_mm_max_epi32(_mm_sub_epi32(zero, x), zero));
+    __m128i last = _mm_and_si128(tail, _mm_set1_epi32(0xFFFF));
+    __m128i left = _mm_srai_epi32(_mm_slli_epi32(tail, 8), 24);
+    __m128i right = _mm_srai_epi32(tail, 24);
+
+    __m128i overlap = _mm_or_si128(
+        _mm_or_si128(_mm_and_si128(_mm_mullo_epi32(formLow, formShift),
+                                   _mm_mullo_epi32(windowLow, fieldShift)),
+                     _mm_and_si128(_mm_mullo_epi32(formHigh, formShift),
+                                   _mm_mullo_epi32(windowHigh, fieldShift))),
+        _mm_and_si128(_mm_mullo_epi32(last, formShift),
+                      _mm_mullo_epi32(below, fieldShift)));
+    __m128i hit = _mm_or_si128(
+        _mm_or_si128(_mm_cmpgt_epi32(zero, _mm_add_epi32(x, left)),
+                     _mm_cmpgt_epi32(_mm_add_epi32(x, right),
+                                     _mm_set1_epi32(FIELD_WIDTH - 1))),
+        _mm_xor_si128(_mm_cmpeq_epi32(overlap, zero), _mm_set1_epi32(-1)));
+    _mm_storeu_si128((__m128i *)(void *)(batch->hit + b),
+                     _mm_srli_epi32(hit, 31));
+  }
+  collideScalar(batch, b, to);
+}
+
+/**
+ * @brief Проверка столкновений восьми игр за итерацию (AVX2).
+ * @param batch Указатель на набор.
+ * @param from Первая игра.
+ * @param to Игра после последней.
+ */
+__attribute__((target("avx2"))) static void collideAvx2(GameBatch *batch,
+                                                        int from, int to) {
+  const int *rows = (const int *)(const void *)batch->rows;
+  const int *shapes = (const int *)(const void *)batch->shapes;
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  int b = from;
+  for (; b + 8 <= to; b += 8) {
+    __m256i x =
+        _mm256_loadu_si256((const __m256i *)(const void *)(batch->cx + b));
+    __m256i y =
+        _mm256_loadu_si256((const __m256i *)(const void *)(batch->cy + b));
+    __m256i id =
+        _mm256_loadu_si256((const __m256i *)(const void *)(batch->id + b));
+    __m256i rotation = _mm256_loadu_si256(
+        (const __m256i *)(const void *)(batch->crotation + b));
+    x = _mm256_min_epi32(_mm256_max_epi32(x, _mm256_set1_epi32(-FIELD_WIDTH)),
+                         _mm256_set1_epi32(FIELD_WIDTH));
+    y = _mm256_min_epi32(_mm256_max_epi32(y, _mm256_set1_epi32(-BATCH_TOP)),
+                         _mm256_set1_epi32(BATCH_MAX_Y));
+
+    __m256i board = _mm256_add_epi32(_mm256_set1_epi32(b), lanes);
+    __m256i row = _mm256_add_epi32(
+        _mm256_mullo_epi32(board, _mm256_set1_epi32(BATCH_ROWS)),
+        _mm256_add_epi32(y, _mm256_set1_epi32(BATCH_TOP)));
+    __m256i shape = _mm256_mullo_epi32(
+        _mm256_add_epi32(
+            _mm256_mullo_epi32(id, _mm256_set1_epi32(ROTATIONS_COUNT)),
+            rotation),
+        _mm256_set1_epi32(BATCH_SHAPE_WORDS));
+
+    __m256i windowLow = _mm256_i32gather_epi32(rows, row, 2);
+    __m256i windowHigh = _mm256_i32gather_epi32(
+        rows, _mm256_add_epi32(row, _mm256_set1_epi32(2)), 2);
+    __m256i below = _mm256_srli_epi32(
+        _mm256_i32gather_epi32(rows,
+                               _mm256_add_epi32(row, _mm256_set1_epi32(3)), 2),
+        16);
+    __m256i formLow = _mm256_i32gather_epi32(shapes, shape, 4);
+    __m256i formHigh = _mm256_i32gather_epi32(
+        shapes, _mm256_add_epi32(shape, _mm256_set1_epi32(1)), 4);
+    __m256i tail = _mm256_i32gather_epi32(
+        shapes, _mm256_add_epi32(shape, _mm256_set1_epi32(BATCH_LAST_WORD)), 4);
+
+    __m256i shiftLeft = _mm256_max_epi32(x, zero);
+    __m256i shiftRight = _mm256_max_epi32(_mm256_sub_epi32(zero, x), zero);
+    __m256i last = _mm256_and_si256(tail, _mm256_set1_epi32(0xFFFF));
+    __m256i left = _mm256_srai_epi32(_mm256_slli_epi32(tail, 8), 24);
+    __m256i right = _mm256_srai_epi32(tail, 24);
+    formLow =
+        _mm256_srlv_epi32(_mm256_sllv_epi32(formLow, shiftLeft), shiftRight);
+    formHigh =
+        _mm256_srlv_epi32(_mm256_sllv_epi32(formHigh, shiftLeft), shiftRight);
+    last = _mm256_srlv_epi32(_mm256_sllv_epi32(last, shiftLeft), shiftRight);
+
+    __m256i overlap = _mm256_or_si256(
+        _mm256_or_si256(_mm256_and_si256(formLow, windowLow),
+                        _mm256_and_si256(formHigh, windowHigh)),
+        _mm256_and_si256(last, below));
+    __m256i hit = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpgt_epi32(zero, _mm256_add_epi32(x, left)),
+                        _mm256_cmpgt_epi32(_mm256_add_epi32(x, right),
+                                           _mm256_set1_epi32(FIELD_WIDTH - 1))),
+        _mm256_xor_si256(_mm256_cmpeq_epi32(overlap, zero),
+                         _mm256_set1_epi32(-1)));
+    _mm256_storeu_si256((__m256i *)(void *)(batch->hit + b),
+                        _mm256_srli_epi32(hit, 31));
+  }
+  collideScalar(batch, b, to);
+}
+
+/**
+ * @brief Поиск заполненных строк по 8 строк за сравнение (SSE4.1).
+ * @param batch Указатель на набор.
+ * @param full Маски заполненных строк по играм.
+ * @param from Первая игра.
+ * @param to Игра после последней.
+ */
+__attribute__((target("sse4.1"))) static void fullRowsSse41(
+    const GameBatch *batch, uint32_t *full, int from, int to) {
+  const __m128i filled = _mm_set1_epi16(FIELD_FULL_ROW);
+  for (int b = from; b < to; b++) {
+    const __m128i *rows = (const __m128i *)(const void *)batch->rows[b];
+    __m128i top = _mm_cmpeq_epi16(_mm_load_si128(rows), filled);
+    __m128i middle = _mm_cmpeq_epi16(_mm_load_si128(rows + 1), filled);
+    __m128i bottom = _mm_cmpeq_epi16(_mm_load_si128(rows + 2), filled);
+    uint32_t mask =
+        (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(top, middle)) |
+        (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(bottom, bottom)) << 16;
+    full[b] = (mask >> BATCH_TOP) & ((1u << FIELD_HEIGHT) - 1);
+  }
+}
+
+/**
+ * @brief Поиск заполненных строк по 16 строк за сравнение (AVX2).
+ * @param batch Указатель на набор.
+ * @param full Маски заполненных строк по играм.
+ * @param from Первая игра.
+ * @param to Игра после последней.
+ */
+__attribute__((target("avx2"))) static void fullRowsAvx2(
+    const GameBatch *batch, uint32_t *full, int from, int to) {
+  const __m256i filled = _mm256_set1_epi16(FIELD_FULL_ROW);
+  for (int b = from; b < to; b++) {
+    const __m256i *rows = (const __m256i *)(const void *)batch->rows[b];
+    __m256i top = _mm256_cmpeq_epi16(_mm256_load_si256(rows), filled);
+    __m256i bottom = _mm256_cmpeq_epi16(_mm256_load_si256(rows + 1), filled);
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(top, bottom),
+                                              _MM_SHUFFLE(3, 1, 2, 0));
+    uint32_t mask = (uint32_t)_mm256_movemask_epi8(packed);
+    full[b] = (mask >> BATCH_TOP) & ((1u << FIELD_HEIGHT) - 1);
+  }
+}
+
+#endif
+
+/**
+ * @brief Возвращает лучший набор команд, поддерживаемый процессором.
+ * @return Набор команд.
+ */
+BatchIsa supportedBatchIsa(void) {
+  BatchIsa isa = IsaScalar;
+#if BATCH_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    isa = IsaAvx2;
+  else if (__builtin_cpu_supports("sse4.1"))
+    isa = IsaSse41;
+#endif
+  return isa;
+}
+
+/**
+ * @brief Возвращает набор команд, которым выполняются ядра набора игр.
+ *
+ * При первом вызове выбирается supportedBatchIsa().
+ *
+ * @return Набор команд.
+ */
+BatchIsa batchIsa(void) {
+  int isa = atomic_load(&activeIsa);
+  if (isa < 0) {
+    isa = (int)supportedBatchIsa();
+    atomic_store(&activeIsa, isa);
+  }
+  return (BatchIsa)isa;
+}
+
+/**
+ * @brief Выбирает набор команд для ядер набора игр.
+ *
+ * Набор, не поддерживаемый процессором, заменяется лучшим поддерживаемым.
+ * Используется тестами и бенчмарками для сравнения реализаций.
+ *
+ * @param isa Желаемый набор команд.
+ * @return Выбранный набор команд.
+ */
+BatchIsa setBatchIsa(BatchIsa isa) {
+  BatchIsa supported = supportedBatchIsa();
+  if (isa > supported) isa = supported;
+  atomic_store(&activeIsa, (int)isa);
+  return isa;
+}
+
+/**
+ * @brief Возвращает название набора команд.
+ * @param isa Набор команд.
+ * @return Название: "scalar", "sse4.1" или "avx2".
+ */
+const char *batchIsaName(BatchIsa isa) {
+  static const char *const names[] = {"scalar", "sse4.1", "avx2"};
+  return names[isa];
+}
+
+/**
+ * @brief Проверяет столкновения проверяемых положений фигур всех игр.
+ *
+ * Для каждой игры фигура `id` в положении (`cx`, `cy`, `crotation`)
+ * проверяется так же, как в figureCollides(); результат записывается в
+ * `hit`. Строки рамки заполнены, поэтому выход фигуры за верх и дно поля
+ * тоже даёт пересечение; выход за боковые стены проверяется по границам
+ * формы. Координата `cy` ограничивается высотой рамки: фигура игры не
+ * поднимается выше поля.
+ *
+ * @param batch Указатель на набор.
+ */
+void collideBatch(GameBatch *batch) {
+  collideBatchRange(batch, 0, batch->count);
+}
+
+/**
+ * @brief Проверяет столкновения проверяемых положений игр [from, to).
+ *
+ * Используется stepBatch() для игр, в которых фигура шагнула вниз.
+ *
+ * @param batch Указатель на набор.
+ * @param from Первая игра.
+ * @param to Игра после последней.
+ */
+void collideBatchRange(GameBatch *batch, int from, int to) {
+#if BATCH_X86
+  BatchIsa isa = batchIsa();
+  if (isa == IsaAvx2)
+    collideAvx2(batch, from, to);
+  else if (isa == IsaSse41)
+    collideSse41(batch, from, to);
+  else
+#endif
+    collideScalar(batch, from, to);
+}
+
+/**
+ * @brief Находит заполненные строки полей всех игр.
+ *
+ * Бит `i` маски игры установлен, если строка `i` её поля заполнена
+ * (как lineFilled()).
+ *
+ * @param batch Указатель на набор.
+ * @param full Массив из `batch->count` масок.
+ */
+void fullRowsBatch(const GameBatch *batch, uint32_t *full) {
+  fullRowsBatchRange(batch, full, 0, batch->count);
+}
+
+/**
+ * @brief Находит заполненные строки полей игр с номерами [from, to).
+ *
+ * Используется stepBatch() для игр, в которых фиксируется фигура.
+ *
+ * @param batch Указатель на набор.
+ * @param full Массив масок, индексируемый номером игры.
+ * @param from Первая игра.
+ * @param to Игра после последней.
+ */
+void fullRowsBatchRange(const GameBatch *batch, uint32_t *full, int from,
+                        int to) {
+#if BATCH_X86
+  BatchIsa isa = batchIsa();
+  if (isa == IsaAvx2)
+    fullRowsAvx2(batch, full, from, to);
+  else if (isa == IsaSse41)
+    fullRowsSse41(batch, full, from, to);
+  else
+#endif
+    fullRowsScalar(batch, full, from, to);
+}
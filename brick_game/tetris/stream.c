@@ -0,0 +1,404 @@
+/**
+ * @file stream.c
+ * @brief Поток изменений игры для зрителей и архива (см. stream.h).
+ *
+ * В отличие от повтора (replay.h), который хранит действия и требует
+ * повторить игру, поток передаёт само видимое состояние: строки поля,
+ * положение фигуры и информацию об игре. Передаются только изменения, а
+ * тики без изменений сворачиваются в одну запись, поэтому секунда игры
+ * обычно занимает десятки байт вместо полного кадра на каждый тик.
+ */
+
+#include "stream.h"
+
+#include <string.h>
+
+#define STREAM_ALL_ROWS ((1u << FIELD_HEIGHT) - 1) /*!< Маска всех строк */
+#define STREAM_VARINT_MAX 10 /*!< Наибольшая длина varint в байтах */
+
+/**
+ * @struct StreamReader
+ * @brief Чтение записи из буфера с проверкой границ.
+ */
+typedef struct StreamReader {
+  const uint8_t *data;  ///< Данные
+  size_t size;          ///< Размер данных
+  size_t pos;           ///< Прочитано байт
+  bool complete;        ///< false - запись не поместилась в данные
+} StreamReader;
+
+/**
+ * @brief Собирает видимое состояние игры.
+ * @param game Игра.
+ * @param state Заполняемое состояние.
+ */
+static void captureState(const Game *game, StreamState *state) {
+  memcpy(state->rows, game->field->rows, sizeof(state->rows));
+  state->figure = *game->figure;
+  state->nextID = game->gameInfo->nextID;
+  state->score = game->gameInfo->score;
+  state->highScore = game->gameInfo->high_score;
+  state->level = game->gameInfo->level;
+  state->speed = game->gameInfo->speed;
+  state->state = game->gameInfo->state;
+  state->pause = game->gameInfo->pause;
+}
+
+/**
+ * @brief Записывает число в формате varint.
+ * @param out Буфер.
+ * @param value Число.
+ * @return Количество записанных байт.
+ */
+static size_t putVarint(uint8_t *out, uint64_t value) {
+  size_t length = 0;
+  while (value >= 0x80) {
+    out[length++] = (uint8_t)(value | 0x80);
+    value >>= 7;
+  }
+  out[length++] = (uint8_t)value;
+  return length;
+}
+
+/**
+ * @brief Записывает накопленные тики без изменений записью STREAM_IDLE.
+ * @param encoder Кодировщик.
+ * @param out Буфер.
+ * @return Количество записанных байт.
+ */
+static size_t putIdle(StreamEncoder *encoder, uint8_t *out) {
+  size_t length = 0;
+  if (encoder->idle) {
+    out[length++] = STREAM_IDLE;
+    length += putVarint(out + length, encoder->idle);
+    encoder->idle = 0;
+  }
+  return length;
+}
+
+/**
+ * @brief Инициализирует кодировщик; первый тик станет ключевым кадром.
+ * @param encoder Кодировщик.
+ * @param keyframeTicks Тиков между ключевыми кадрами, не больше 0 -
+ * STREAM_KEYFRAME_TICKS.
+ */
+void initStreamEncoder(StreamEncoder *encoder, int keyframeTicks) {
+  memset(encoder, 0, sizeof(*encoder));
+  encoder->keyframeTicks =
+      keyframeTicks > 0 ? keyframeTicks : STREAM_KEYFRAME_TICKS;
+}
+
+/**
+ * @brief Кодирует состояние игры после очередного тика.
+ *
+ * Если с предыдущего тика ничего не изменилось и ключевой кадр не нужен,
+ * ничего не записывается: тик учитывается в следующей записи STREAM_IDLE.
+ *
+ * @param encoder Кодировщик.
+ * @param game Игра после тика.
+ * @param out Буфер записей.
+ * @return Количество записанных байт (0 - тик без изменений).
+ */
+size_t encodeDelta(StreamEncoder *encoder, const Game *game,
+                   uint8_t out[STREAM_MAX_RECORD]) {
+  StreamState state;
+  captureState(game, &state);
+  const StreamState *last = &encoder->last;
+  bool key = encoder->ticks == 0 ||
+             encoder->ticks - encoder->keyTick >=
+                 (uint64_t)encoder->keyframeTicks;
+
+  uint32_t rows = key ? STREAM_ALL_ROWS : 0;
+  for (int i = 0; !key && i < FIELD_HEIGHT; i++)
+    if (state.rows[i] != last->rows[i]) rows |= 1u << i;
+  uint8_t flags = key ? STREAM_KEY : 0;
+  if (rows) flags |= STREAM_ROWS;
+  if (key || state.figure.x != last->figure.x ||
+      state.figure.y != last->figure.y || state.figure.id != last->figure.id ||
+      state.figure.rotation != last->figure.rotation)
+    flags |= STREAM_FIGURE;
+  if (key || state.nextID != last->nextID) flags |= STREAM_NEXT;
+  if (key || state.score != last->score ||
+      state.highScore != last->highScore)
+    flags |= STREAM_SCORE;
+  if (key || state.level != last->level || state.speed != last->speed)
+    flags |= STREAM_LEVEL;
+  if (key || state.state != last->state || state.pause != last->pause)
+    flags |= STREAM_STATE;
+
+  size_t length = 0;
+  if (key) encoder->keyTick = encoder->ticks;
+  encoder->ticks++;
+  if (!flags) {
+    encoder->idle++;
+  } else {
+    length = putIdle(encoder, out);
+    out[length++] = flags;
+    if (flags & STREAM_ROWS) {
+      for (int i = 0; i < 3; i++) out[length++] = (uint8_t)(rows >> (8 * i));
+      for (int i = 0; i < FIELD_HEIGHT; i++) {
+        if (rows >> i & 1) {
+          out[length++] = (uint8_t)state.rows[i];
+          out[length++] = (uint8_t)(state.rows[i] >> 8);
+        }
+      }
+    }
+    if (flags & STREAM_FIGURE) {
+      out[length++] = (uint8_t)(int8_t)state.figure.x;
+      out[length++] = (uint8_t)(int8_t)state.figure.y;
+      out[length++] =
+          (uint8_t)(state.figure.id * ROTATIONS_COUNT + state.figure.rotation);
+    }
+    if (flags & STREAM_NEXT) out[length++] = (uint8_t)state.nextID;
+    if (flags & STREAM_SCORE) {
+      length += putVarint(out + length, (uint32_t)state.score);
+      length += putVarint(out + length, (uint32_t)state.highScore);
+    }
+    if (flags & STREAM_LEVEL) {
+      out[length++] = (uint8_t)state.level;
+      out[length++] = (uint8_t)state.speed;
+    }
+    if (flags & STREAM_STATE)
+      out[length++] = (uint8_t)(state.state + 8 * (state.pause != 0));
+    encoder->last = state;
+  }
+  return length;
+}
+
+/**
+ * @brief Записывает тики без изменений, накопленные в конце потока.
+ * @param encoder Кодировщик.
+ * @param out Буфер записей.
+ * @return Количество записанных байт.
+ */
+size_t finishDelta(StreamEncoder *encoder, uint8_t out[STREAM_MAX_RECORD]) {
+  return putIdle(encoder, out);
+}
+
+/**
+ * @brief Инициализирует декодировщик, ожидающий ключевого кадра.
+ * @param decoder Декодировщик.
+ */
+void initStreamDecoder(StreamDecoder *decoder) {
+  memset(decoder, 0, sizeof(*decoder));
+  decoder->snapshot.gameInfo.state = Start;
+  decoder->snapshot.player.action = ACTION;
+}
+
+/**
+ * @brief Читает байт записи.
+ * @param reader Чтение записи.
+ * @return Байт или 0, если данные закончились.
+ */
+static uint8_t getByte(StreamReader *reader) {
+  uint8_t byte = 0;
+  if (reader->pos < reader->size)
+    byte = reader->data[reader->pos++];
+  else
+    reader->complete = false;
+  return byte;
+}
+
+/**
+ * @brief Читает число в формате varint.
+ * @param reader Чтение записи.
+ * @param valid Сбрасывается в false, если число длиннее STREAM_VARINT_MAX.
+ * @return Число.
+ */
+static uint64_t getVarint(StreamReader *reader, bool *valid) {
+  uint64_t value = 0;
+  uint8_t byte = 0x80;
+  for (int i = 0; reader->complete && byte & 0x80; i++) {
+    if (i == STREAM_VARINT_MAX) {
+      *valid = false;
+      break;
+    }
+    byte = getByte(reader);
+    value |= (uint64_t)(byte & 0x7F) << (7 * i);
+  }
+  return value;
+}
+
+/**
+ * @brief Декодирует одну запись потока.
+ *
+ * Запись применяется к снимку целиком или не применяется вовсе: если
+ * данных не хватает, снимок не меняется и возвращается 0.
+ *
+ * @param decoder Декодировщик.
+ * @param data Данные потока, начинающиеся с записи.
+ * @param size Размер данных.
+ * @return Размер записи в байтах, 0 - запись не полностью в данных, -1 -
+ * данные не являются потоком.
+ */
+int decodeDelta(StreamDecoder *decoder, const uint8_t *data, size_t size) {
+  StreamReader reader = {data, size, 0, true};
+  StreamState state;
+  bool valid = true;
+  uint64_t idle = 0;
+  uint8_t flags = getByte(&reader);
+  if (flags & STREAM_IDLE) {
+    valid = flags == STREAM_IDLE;
+    idle = getVarint(&reader, &valid);
+  } else {
+    GameSnapshot *snapshot = &decoder->snapshot;
+    memcpy(state.rows, snapshot->field.rows, sizeof(state.rows));
+    state.figure = snapshot->figure;
+    state.nextID = snapshot->gameInfo.nextID;
+    state.score = snapshot->gameInfo.score;
+    state.highScore = snapshot->gameInfo.high_score;
+    state.level = snapshot->gameInfo.level;
+    state.speed = snapshot->gameInfo.speed;
+    state.state = snapshot->gameInfo.state;
+    state.pause = snapshot->gameInfo.pause;
+
+    if (flags & STREAM_ROWS) {
+      uint32_t rows = 0;
+      for (int i = 0; i < 3; i++) rows |= (uint32_t)getByte(&reader) << (8 * i);
+      valid = (rows & ~STREAM_ALL_ROWS) == 0;
+      for (int i = 0; i < FIELD_HEIGHT; i++) {
+        if (rows >> i & 1) {
+          state.rows[i] = getByte(&reader);
+          state.rows[i] |= (uint16_t)(getByte(&reader) << 8);
+          valid = valid && state.rows[i] < 1u << FIELD_WIDTH;
+        }
+      }
+    }
+    if (flags & STREAM_FIGURE) {
+      state.figure.x = (int8_t)getByte(&reader);
+      state.figure.y = (int8_t)getByte(&reader);
+      int shape = getByte(&reader);
+      state.figure.id = shape / ROTATIONS_COUNT;
+      state.figure.rotation = shape % ROTATIONS_COUNT;
+      valid = valid && state.figure.id < FIGURES_COUNT &&
+              state.figure.x >= -FIGURE_WIDTH &&
+              state.figure.x <= FIELD_WIDTH &&
+              state.figure.y >= -FIGURE_HEIGHT &&
+              state.figure.y <= FIELD_HEIGHT;
+    }
+    if (flags & STREAM_NEXT) {
+      state.nextID = getByte(&reader);
+      valid = valid && state.nextID < FIGURES_COUNT;
+    }
+    if (flags & STREAM_SCORE) {
+      state.score = (int)(uint32_t)getVarint(&reader, &valid);
+      state.highScore = (int)(uint32_t)getVarint(&reader, &valid);
+    }
+    if (flags & STREAM_LEVEL) {
+      state.level = getByte(&reader);
+      state.speed = getByte(&reader);
+    }
+    if (flags & STREAM_STATE) {
+      uint8_t byte = getByte(&reader);
+      state.state = (GameState)(byte & 7);
+      state.pause = byte >> 3;
+      valid = valid && state.state <= Quit && state.pause <= 1;
+    }
+  }
+
+  int result = -1;
+  if (valid && !reader.complete) {
+    result = 0;
+  } else if (valid) {
+    result = (int)reader.pos;
+    if (flags & STREAM_IDLE) {
+      decoder->ticks += idle;
+    } else {
+      GameSnapshot *snapshot = &decoder->snapshot;
+      if (flags & STREAM_ROWS) {
+        memcpy(snapshot->field.rows, state.rows, sizeof(state.rows));
+        snapshot->field.dirty = 0;
+        updateHeights(&snapshot->field);
+        snapshot->field.hash = hashField(&snapshot->field);
+      }
+      snapshot->figure = state.figure;
+      snapshot->gameInfo.nextID = state.nextID;
+      snapshot->gameInfo.score = state.score;
+      snapshot->gameInfo.high_score = state.highScore;
+      snapshot->gameInfo.level = state.level;
+      snapshot->gameInfo.speed = state.speed;
+      snapshot->gameInfo.state = state.state;
+      snapshot->gameInfo.pause = state.pause;
+      decoder->ticks++;
+      if (flags & STREAM_KEY) decoder->synced = true;
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief Связывает игру с восстановленным снимком для вывода.
+ *
+ * Получившуюся игру можно передать printGame(); продвигать её stepGame()
+ * нельзя: генератор фигур и тики в поток не входят.
+ *
+ * @param decoder Декодировщик.
+ * @param figurest Шаблоны фигур (createFiguresT()).
+ * @return Игра, указатели которой ссылаются на снимок декодировщика.
+ */
+Game streamGame(StreamDecoder *decoder, FiguresT *figurest) {
+  return snapshotView(&decoder->snapshot, figurest);
+}
+
+/**
+ * @brief Открывает файл для записи потока зрителя.
+ * @param path Путь к файлу.
+ * @param keyframeTicks Тиков между ключевыми кадрами (см.
+ * initStreamEncoder()).
+ * @return Запись потока или NULL, если файл не открылся.
+ */
+StreamWriter *openStream(const char *path, int keyframeTicks) {
+  StreamWriter *writer = (StreamWriter *)malloc(sizeof(StreamWriter));
+  if (writer) {
+    writer->file = fopen(path, "wb");
+    writer->pending = false;
+    initStreamEncoder(&writer->encoder, keyframeTicks);
+    if (!writer->file) {
+      free(writer);
+      writer = NULL;
+    }
+  }
+  return writer;
+}
+
+/**
+ * @brief Записывает изменения игры после очередного тика.
+ * @param writer Запись потока.
+ * @param game Игра после тика.
+ */
+void writeStream(StreamWriter *writer, const Game *game) {
+  uint8_t record[STREAM_MAX_RECORD];
+  size_t length = encodeDelta(&writer->encoder, game, record);
+  if (length) {
+    fwrite(record, 1, length, writer->file);
+    writer->pending = true;
+  }
+}
+
+/**
+ * @brief Передаёт записанные изменения в файл, чтобы их увидел зритель.
+ *
+ * Вызывается раз в кадр; если за кадр ничего не изменилось, ничего не
+ * делает.
+ *
+ * @param writer Запись потока.
+ */
+void flushStream(StreamWriter *writer) {
+  if (writer->pending) fflush(writer->file);
+  writer->pending = false;
+}
+
+/**
+ * @brief Завершает поток и закрывает файл.
+ * @param writer Запись потока.
+ * @return true, если поток записан без ошибок.
+ */
+bool closeStream(StreamWriter *writer) {
+  uint8_t record[STREAM_MAX_RECORD];
+  size_t length = finishDelta(&writer->encoder, record);
+  fwrite(record, 1, length, writer->file);
+  bool ok = !ferror(writer->file);
+  ok = fclose(writer->file) == 0 && ok;
+  free(writer);
+  return ok;
+}
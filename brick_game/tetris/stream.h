@@ -0,0 +1,93 @@
+#ifndef STREAM_H_
+#define STREAM_H_
+
+#include "tetris.h"
+
+#define STREAM_KEYFRAME_TICKS 500 /*!< Тиков между ключевыми кадрами */
+#define STREAM_MAX_RECORD 80 /*!< Наибольший размер записей одного тика */
+
+#define STREAM_KEY 0x01    /*!< Ключевой кадр: все поля ниже */
+#define STREAM_ROWS 0x02   /*!< Маска строк (3 байта) и изменённые строки */
+#define STREAM_FIGURE 0x04 /*!< Столбец, строка, фигура и поворот */
+#define STREAM_NEXT 0x08   /*!< Следующая фигура */
+#define STREAM_SCORE 0x10  /*!< Счёт и рекорд (varint) */
+#define STREAM_LEVEL 0x20  /*!< Уровень и скорость */
+#define STREAM_STATE 0x40  /*!< Состояние игры и пауза */
+#define STREAM_IDLE 0x80   /*!< Тики без изменений (varint количества) */
+
+/**
+ * @struct StreamState
+ * @brief Видимое состояние игры, передаваемое потоком зрителя.
+ */
+typedef struct StreamState {
+  uint16_t rows[FIELD_HEIGHT];  ///< Строки поля
+  Figure figure;                ///< Текущая фигура
+  int nextID;                   ///< Следующая фигура
+  int score;                    ///< Счёт
+  int highScore;                ///< Рекорд
+  int level;                    ///< Уровень
+  int speed;                    ///< Скорость
+  GameState state;              ///< Состояние игры
+  int pause;                    ///< Флаг паузы
+} StreamState;
+
+/**
+ * @struct StreamEncoder
+ * @brief Кодировщик потока зрителя.
+ *
+ * Поток - последовательность записей. Запись начинается с байта флагов
+ * STREAM_*, за которым следуют только изменившиеся с предыдущей записи
+ * части состояния в порядке флагов: маска изменённых строк поля (3 байта,
+ * little-endian) и сами строки (uint16), столбец и строка фигуры (int8) и
+ * байт `фигура * 4 + поворот`, следующая фигура, счёт и рекорд (varint),
+ * уровень и скорость, байт `состояние + 8 * пауза`. Тики без изменений не
+ * записываются по отдельности: их количество передаётся одной записью
+ * STREAM_IDLE перед следующим изменением. Каждые `keyframeTicks` тиков
+ * записывается ключевой кадр со всем состоянием, с которого может начать
+ * декодирование зритель, подключившийся к середине потока.
+ */
+typedef struct StreamEncoder {
+  StreamState last;    ///< Состояние, переданное последним
+  uint64_t ticks;      ///< Закодированных тиков
+  uint64_t idle;       ///< Тиков без изменений, ещё не записанных
+  uint64_t keyTick;    ///< Тик последнего ключевого кадра
+  int keyframeTicks;   ///< Тиков между ключевыми кадрами
+} StreamEncoder;
+
+/**
+ * @struct StreamDecoder
+ * @brief Декодировщик потока зрителя.
+ *
+ * Восстанавливает снимок игры, пригодный для вывода printGame() (см.
+ * streamGame()). До первого ключевого кадра записи пропускаются.
+ */
+typedef struct StreamDecoder {
+  GameSnapshot snapshot;  ///< Восстановленное состояние игры
+  uint64_t ticks;         ///< Декодированных тиков
+  bool synced;            ///< Ключевой кадр получен
+} StreamDecoder;
+
+/**
+ * @struct StreamWriter
+ * @brief Запись потока зрителя в файл.
+ */
+typedef struct StreamWriter {
+  FILE *file;              ///< Файл потока
+  StreamEncoder encoder;   ///< Кодировщик
+  bool pending;            ///< Есть записанные, но не сброшенные данные
+} StreamWriter;
+
+void initStreamEncoder(StreamEncoder *encoder, int keyframeTicks);
+size_t encodeDelta(StreamEncoder *encoder, const Game *game,
+                   uint8_t out[STREAM_MAX_RECORD]);
+size_t finishDelta(StreamEncoder *encoder, uint8_t out[STREAM_MAX_RECORD]);
+void initStreamDecoder(StreamDecoder *decoder);
+int decodeDelta(StreamDecoder *decoder, const uint8_t *data, size_t size);
+Game streamGame(StreamDecoder *decoder, FiguresT *figurest);
+
+StreamWriter *openStream(const char *path, int keyframeTicks);
+void writeStream(StreamWriter *writer, const Game *game);
+void flushStream(StreamWriter *writer);
+bool closeStream(StreamWriter *writer);
+
+#endif
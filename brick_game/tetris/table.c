@@ -0,0 +1,133 @@
+/**
+ * @file table.c
+ * @brief Таблица транспозиций для поиска ходов.
+ *
+ * Поиск с просмотром вперёд приходит к одинаковым полям разными
+ * последовательностями ходов. Таблица кеширует оценку поля и лучший ход по
+ * ключу, полученному из хеша Зобриста поля (Field::hash). Доступ к записям
+ * не требует блокировок: используется приём с XOR ключа и данных.
+ */
+
+#include "table.h"
+
+#include <string.h>
+
+#define TABLE_VALID (1ULL << 63) /*!< Бит занятой записи в упакованном ходе */
+
+/**
+ * @brief Упаковывает фигуру в 64-битное слово.
+ *
+ * Старший бит слова (TABLE_VALID) всегда установлен, поэтому обнулённая
+ * запись не совпадёт ни с одним ключом.
+ *
+ * @param figure Указатель на фигуру.
+ * @return Упакованная фигура.
+ */
+static uint64_t packFigure(const Figure *figure) {
+  return TABLE_VALID | (uint64_t)(uint8_t)figure->x |
+         (uint64_t)(uint8_t)figure->y << 8 |
+         (uint64_t)(uint8_t)figure->id << 16 |
+         (uint64_t)(uint8_t)figure->rotation << 24;
+}
+
+/**
+ * @brief Распаковывает фигуру из 64-битного слова.
+ * @param packed Упакованная фигура.
+ * @param figure Указатель на фигуру-результат.
+ */
+static void unpackFigure(uint64_t packed, Figure *figure) {
+  figure->x = (int8_t)(packed & 0xFF);
+  figure->y = (int8_t)((packed >> 8) & 0xFF);
+  figure->id = (int8_t)((packed >> 16) & 0xFF);
+  figure->rotation = (int8_t)((packed >> 24) & 0xFF);
+}
+
+/**
+ * @brief Создаёт пустую таблицу из 2^bits записей.
+ * @param bits Двоичный логарифм количества записей (от 1 до 30).
+ * @return Указатель на таблицу или NULL, если не удалось выделить память.
+ */
+TransTable *createTable(int bits) {
+  if (bits < 1) bits = 1;
+  if (bits > 30) bits = 30;
+  TransTable *table = (TransTable *)malloc(sizeof(TransTable));
+  if (table) {
+    table->mask = ((uint64_t)1 << bits) - 1;
+    table->entries =
+        (TableEntry *)malloc((table->mask + 1) * sizeof(TableEntry));
+    if (table->entries) {
+      clearTable(table);
+    } else {
+      free(table);
+      table = NULL;
+    }
+  }
+  return table;
+}
+
+/**
+ * @brief Освобождает таблицу.
+ * @param table Указатель на таблицу или NULL.
+ */
+void freeTable(TransTable *table) {
+  if (table) {
+    free(table->entries);
+    free(table);
+  }
+}
+
+/**
+ * @brief Очищает все записи таблицы.
+ * @param table Указатель на таблицу.
+ */
+void clearTable(TransTable *table) {
+  for (uint64_t i = 0; i <= table->mask; i++) {
+    atomic_init(&table->entries[i].check, 0);
+    atomic_init(&table->entries[i].value, 0);
+    atomic_init(&table->entries[i].move, 0);
+  }
+}
+
+/**
+ * @brief Ищет запись по ключу.
+ * @param table Указатель на таблицу.
+ * @param key Ключ.
+ * @param value Оценка найденной записи.
+ * @param move Лучший ход найденной записи или NULL.
+ * @return true, если запись найдена.
+ */
+bool probeTable(TransTable *table, uint64_t key, double *value,
+                Figure *move) {
+  TableEntry *entry = &table->entries[key & table->mask];
+  uint64_t bits = atomic_load_explicit(&entry->value, memory_order_relaxed);
+  uint64_t packed = atomic_load_explicit(&entry->move, memory_order_relaxed);
+  uint64_t check = atomic_load_explicit(&entry->check, memory_order_relaxed);
+  bool found = (packed & TABLE_VALID) && (check ^ bits ^ packed) == key;
+
+  if (found) {
+    memcpy(value, &bits, sizeof(bits));
+    if (move) unpackFigure(packed, move);
+  }
+  return found;
+}
+
+/**
+ * @brief Записывает оценку и лучший ход по ключу.
+ * @param table Указатель на таблицу.
+ * @param key Ключ.
+ * @param value Оценка.
+ * @param move Лучший ход или NULL.
+ */
+void storeTable(TransTable *table, uint64_t key, double value,
+                const Figure *move) {
+  TableEntry *entry = &table->entries[key & table->mask];
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  Figure none = {0, 0, 0, 0};
+  uint64_t packed = packFigure(move ? move : &none);
+
+  atomic_store_explicit(&entry->check, key ^ bits ^ packed,
+                        memory_order_relaxed);
+  atomic_store_explicit(&entry->value, bits, memory_order_relaxed);
+  atomic_store_explicit(&entry->move, packed, memory_order_relaxed);
+}
@@ -0,0 +1,41 @@
+#ifndef TABLE_H_
+#define TABLE_H_
+
+#include <stdatomic.h>
+
+#include "tetris.h"
+
+/**
+ * @struct TableEntry
+ * @brief Запись таблицы транспозиций.
+ *
+ * Вместо ключа хранится `check = key ^ value ^ move`. Запись читается и
+ * пишется без блокировок; если чтение попало на одновременную запись
+ * другого потока, проверка не сойдётся и запись будет считаться пустой.
+ */
+typedef struct TableEntry {
+  atomic_uint_fast64_t check;  ///< Ключ, смешанный с данными
+  atomic_uint_fast64_t value;  ///< Биты оценки (double)
+  atomic_uint_fast64_t move;   ///< Упакованная фигура лучшего хода
+} TableEntry;
+
+/**
+ * @struct TransTable
+ * @brief Таблица транспозиций фиксированного размера.
+ *
+ * Запись выбирается младшими битами ключа и всегда перезаписывается.
+ * Таблицу могут одновременно использовать несколько потоков.
+ */
+typedef struct TransTable {
+  TableEntry *entries;   ///< Записи
+  uint64_t mask;         ///< Количество записей минус один
+} TransTable;
+
+TransTable *createTable(int bits);
+void freeTable(TransTable *table);
+void clearTable(TransTable *table);
+bool probeTable(TransTable *table, uint64_t key, double *value, Figure *move);
+void storeTable(TransTable *table, uint64_t key, double value,
+                const Figure *move);
+
+#endif
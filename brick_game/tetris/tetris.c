@@ -5,41 +5,329 @@
  * Он отвечает за инициализацию графического интерфейса, управление игровым
  * процессом и завершение игры
  */
+#define _POSIX_C_SOURCE 200809L
 
 #include "tetris.h"
 
+#include <string.h>
+#include <unistd.h>
+
+#include "ai.h"
+#include "input.h"
+#include "profile.h"
+#include "replay.h"
+#include "stream.h"
 #include "../../gui/cli/cli.h"
 
+#define TICK_NS (TICK_MS * 1000000ULL) /*!< Длительность тика в наносекундах */
+#define MAX_CATCHUP_TICKS 5 /*!< Наибольшее число тиков, догоняемых за кадр */
+#define STREAM_BUFFER 4096 /*!< Буфер чтения потока зрителя */
+#define STREAM_POLL_MS 50  /*!< Ожидание новых данных потока зрителя */
+
+#ifdef TETRIS_PROFILE
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+/**
+ * @brief Обёртка malloc(), считающая выделения памяти в профиле.
+ */
+void *__wrap_malloc(size_t size) {
+  PROFILE_COUNT(CounterAllocations, 1);
+  return __real_malloc(size);
+}
+
+/**
+ * @brief Обёртка calloc(), считающая выделения памяти в профиле.
+ */
+void *__wrap_calloc(size_t count, size_t size) {
+  PROFILE_COUNT(CounterAllocations, 1);
+  return __real_calloc(count, size);
+}
+
+/**
+ * @brief Обёртка realloc(), считающая выделения памяти в профиле.
+ */
+void *__wrap_realloc(void *ptr, size_t size) {
+  PROFILE_COUNT(CounterAllocations, 1);
+  return __real_realloc(ptr, size);
+}
+#endif
+
+/**
+ * @brief Выполняет один игровой тик и сохраняет рекорд по окончании игры.
+ * @param game Указатель на объект игры.
+ * @param replay Запись повтора или NULL.
+ * @param stream Запись потока зрителя или NULL.
+ * @param action Действие игрока на этом тике.
+ */
+static void runTick(Game *game, Replay *replay, StreamWriter *stream,
+                    UserAction action) {
+  bool over = game->gameInfo->state == GameOver;
+  if (replay) recordAction(replay, action);
+  stepGame(game, action);
+  if (stream) writeStream(stream, game);
+  if (!over && game->gameInfo->state == GameOver)
+    saveHighScore(game->gameInfo->high_score);
+}
+
+/**
+ * @brief Забирает все действия из очереди и проверяет, нажат ли выход.
+ * @param input Очередь действий игрока.
+ * @return true, если среди действий есть TERMINATE.
+ */
+static bool quitPressed(InputQueue *input) {
+  bool quit = false;
+  for (UserAction action = popInput(input); action != ACTION;
+       action = popInput(input))
+    quit = quit || action == TERMINATE;
+  return quit;
+}
+
+/**
+ * @brief Показывает игру по потоку зрителя (см. stream.h).
+ *
+ * Записи до первого ключевого кадра пропускаются, дальше тики выводятся
+ * printGame() с шагом TICK_MS; отставший зритель догоняет поток без
+ * ожидания. Когда данные в файле заканчиваются, файл читается снова, так
+ * что можно смотреть игру, поток которой ещё пишется. Просмотр
+ * заканчивается, когда игрок записанной игры вышел из неё, или клавишей
+ * выхода.
+ *
+ * @param path Путь к файлу потока.
+ * @param render Способ вывода кадров.
+ * @return 0 при успешном завершении, 1 если файл не читается или не
+ * является потоком.
+ */
+static int watchStream(const char *path, RenderBackend render) {
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    fprintf(stderr, "cannot read stream %s\n", path);
+    return 1;
+  }
+  FiguresT *figurest = createFiguresT();
+  StreamDecoder decoder;
+  initStreamDecoder(&decoder);
+  Game game = streamGame(&decoder, figurest);
+  InputQueue input;
+  initInput(&input, NULL);
+  initGui(render);
+
+  uint8_t buffer[STREAM_BUFFER];
+  size_t length = 0;
+  int result = 0;
+  bool watching = true;
+  uint64_t start = 0;
+  uint64_t base = 0;
+  while (watching) {
+    int used = decodeDelta(&decoder, buffer, length);
+    if (used > 0) {
+      length -= (size_t)used;
+      memmove(buffer, buffer + used, length);
+    }
+    if (used > 0 && decoder.synced) {
+      if (!start) {
+        start = monotonicNs();
+        base = decoder.ticks;
+      }
+      uint64_t due = start + (decoder.ticks - base) * TICK_NS;
+      for (uint64_t now = monotonicNs(); watching && now < due;
+           now = monotonicNs()) {
+        getActions(&input, (int)((due - now + 999999) / 1000000));
+        watching = !quitPressed(&input);
+      }
+      printGame(&game);
+      watching = watching && game.gameInfo->state != Quit;
+    } else if (used == 0) {
+      size_t n = fread(buffer + length, 1, sizeof(buffer) - length, file);
+      length += n;
+      if (!n) {
+        clearerr(file);
+        getActions(&input, STREAM_POLL_MS);
+        watching = !quitPressed(&input);
+      }
+    } else if (used < 0) {
+      result = 1;
+      watching = false;
+    }
+  }
+
+  closeGui();
+  fclose(file);
+  freeFiguresT(figurest);
+  if (result) fprintf(stderr, "malformed stream %s\n", path);
+  return result;
+}
+
+/**
+ * @brief Проверяет, стоит ли игра: тик без действия игрока её не изменит.
+ * @param gameInfo Указатель на информацию об игре.
+ * @return true в ожидании начала, на паузе и после окончания игры.
+ */
+static bool gameIdle(const GameInfo *gameInfo) {
+  return gameInfo->state == Start || gameInfo->state == Pause ||
+         gameInfo->state == GameOver;
+}
+
 /**
  * @brief Запуск Tetris
  *
  * Эта функция инициализирует графический интерфейс и основной игровой процесс.
  * Она запускает цикл игры, обрабатывающий действия игрока и обновляющий
- * состояние игры, пока игрок не решит выйти
+ * состояние игры, пока игрок не решит выйти. Рекордный счёт сохраняется в
+ * файл по окончании каждой игры и при выходе
+ *
+ * Игровые тики выполняются с фиксированным шагом TICK_MS по монотонным
+ * часам, независимо от частоты нажатий и скорости терминала. Ввод ожидается
+ * не дольше, чем до следующего тика; все клавиши, нажатые за кадр,
+ * ставятся в очередь (см. input.h), и каждый тик применяет одно действие
+ * из неё.
+ * Если цикл отстал, за один кадр догоняется не более MAX_CATCHUP_TICKS
+ * тиков, а остальное отставание отбрасывается
+ *
+ * Пока игра не идёт (ожидание начала, пауза, конец игры), тики ничего не
+ * меняют, поэтому цикл не выполняет их и блокируется в waitActions() до
+ * нажатия клавиши или изменения размера терминала, не расходуя время
+ * процессора. После пробуждения тик выполняется сразу
+ *
+ * При сборке с TETRIS_PROFILE (`make PROFILE=1`) длительности ввода,
+ * логики и вывода каждого кадра записываются в гистограммы (см.
+ * profile.h), клавиша `o` показывает их процентили на экране, а при выходе
+ * профиль записывается в PROFILE_FILE
  *
- * @return Возвращает 0 при успешном завершении
+ * Параметры: `-s seed` задаёт начальное значение генератора фигур (по
+ * умолчанию - текущее время), `-b` включает генератор "мешок из 7 фигур",
+ * `-r файл` записывает повтор сессии в файл (см. replay.h), `-a` передаёт
+ * управление фигурами автоматическому игроку (см. ai.h), `-l` включает для
+ * него учёт следующей фигуры, `-D мс` и `-R мс` задают задержку и период
+ * автоповтора удерживаемых сдвигов (DAS/ARR, не меньше 0), `-g curses|ansi` выбирает
+ * вывод кадров: через ncurses (по умолчанию) или одним write()
+ * escape-последовательностей ANSI за кадр (см. ansi.h), `-o файл`
+ * записывает поток изменений игры для зрителей (см. stream.h), а `-v файл`
+ * вместо игры показывает игру по такому потоку (watchStream()). Клавиши
+ * старта, паузы и выхода работают и в режиме автоматического игрока
+ *
+ * @return Возвращает 0 при успешном завершении, 1 при неверных аргументах
+ * или ошибке записи повтора, потока или профиля
  */
-int main() {
-  srand((unsigned int)time(NULL));
-  initGui();
-  Game *game = initGame();
+int main(int argc, char **argv) {
+  GameConfig config = {HIGH_SCORE_FILE, (uint64_t)time(NULL), false};
+  const char *replayPath = NULL;
+  const char *streamPath = NULL;
+  const char *watchPath = NULL;
+  bool autoplay = false;
+  bool lookahead = false;
+  InputConfig inputConfig = {INPUT_DAS_MS, INPUT_ARR_MS, INPUT_RELEASE_MS};
+  RenderBackend render = RenderCurses;
+  bool error = false;
+  int opt;
+  while ((opt = getopt(argc, argv, "s:br:alD:R:g:o:v:")) != -1) {
+    if (opt == 's') {
+      config.seed = strtoull(optarg, NULL, 10);
+    } else if (opt == 'b') {
+      config.useBag = true;
+    } else if (opt == 'r') {
+      replayPath = optarg;
+    } else if (opt == 'a') {
+      autoplay = true;
+    } else if (opt == 'l') {
+      lookahead = true;
+    } else if (opt == 'D') {
+      inputConfig.dasMs = atoi(optarg);
+    } else if (opt == 'R') {
+      inputConfig.arrMs = atoi(optarg);
+    } else if (opt == 'o') {
+      streamPath = optarg;
+    } else if (opt == 'v') {
+      watchPath = optarg;
+    } else if (opt == 'g' && strcmp(optarg, "curses") == 0) {
+      render = RenderCurses;
+    } else if (opt == 'g' && strcmp(optarg, "ansi") == 0) {
+      render = RenderAnsi;
+    } else {
+      error = true;
+    }
+  }
+  if (error || inputConfig.dasMs < 0 || inputConfig.arrMs < 0) {
+    fprintf(stderr,
+            "usage: %s [-s seed] [-b] [-r replay] [-a] [-l] [-D das_ms] "
+            "[-R arr_ms] [-g curses|ansi] [-o stream] [-v stream]\n",
+            argv[0]);
+    return 1;
+  }
+  if (watchPath) return watchStream(watchPath, render);
+  StreamWriter *stream =
+      streamPath ? openStream(streamPath, STREAM_KEYFRAME_TICKS) : NULL;
+  if (streamPath && !stream) {
+    fprintf(stderr, "cannot write stream %s\n", streamPath);
+    return 1;
+  }
+
+  initGui(render);
+  Game *game = initGameWith(&config);
+  Replay *replay = replayPath ? createReplay(game->gameInfo) : NULL;
+  Autoplayer ai;
+  initAutoplayer(&ai, lookahead);
+  InputQueue input;
+  initInput(&input, &inputConfig);
+
+  uint64_t next = monotonicNs() + TICK_NS;
+  printGame(game);
 
   while (game->gameInfo->state != Quit) {
-    getActions(game);
+    uint64_t now = monotonicNs();
+    if (gameIdle(game->gameInfo) && !pendingInput(&input)) {
+      waitActions(&input);
+      now = monotonicNs();
+      next = now;
+    } else if (now < next) {
+      getActions(&input, (int)((next - now + 999999) / 1000000));
+      now = monotonicNs();
+    }
 
-    if (game->gameInfo->state != GameOver) {
-      calculate(game);
+    int ticks = 0;
+    PROFILE_BEGIN(logicStart);
+    while (now >= next && ticks < MAX_CATCHUP_TICKS &&
+           game->gameInfo->state != Quit) {
+      updateInput(&input, now);
+      UserAction action = popInput(&input);
+      if (autoplay && action == ACTION) action = aiAction(&ai, game);
+      runTick(game, replay, stream, action);
+      next += TICK_NS;
+      ticks++;
+    }
+    if (now >= next) next = now + TICK_NS;
+    if (ticks) {
+      PROFILE_END(PhaseLogic, logicStart);
+      PROFILE_BEGIN(renderStart);
       printGame(game);
-    } else {
-      if (game->player->action == START) {
-        freeGame(game);
-        game = initGame();
-      }
+      PROFILE_END(PhaseRender, renderStart);
+      if (stream) flushStream(stream);
     }
   }
 
+  saveHighScore(game->gameInfo->high_score);
+  closeGui();
+  int result = 0;
+  if (replay) {
+    finishReplay(replay, game);
+    if (!saveReplay(replay, replayPath)) {
+      fprintf(stderr, "cannot write replay %s\n", replayPath);
+      result = 1;
+    }
+    freeReplay(replay);
+  }
+  if (stream && !closeStream(stream)) {
+    fprintf(stderr, "cannot write stream %s\n", streamPath);
+    result = 1;
+  }
   freeGame(game);
-  endwin();
+#ifdef TETRIS_PROFILE
+  if (!profileDump(PROFILE_FILE)) {
+    fprintf(stderr, "cannot write profile %s\n", PROFILE_FILE);
+    result = 1;
+  }
+#endif
 
-  return 0;
+  return result;
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define TETRIS_H_
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
@@ -11,7 +12,12 @@
 #define FIGURE_WIDTH 5  /*!< Ширина фигуры */
 #define FIGURE_HEIGHT 5 /*!< Высота фигуры */
 #define FIGURES_COUNT 7 /*!< Общее количество фигур */
-#define TICKS 30 /*!< Количество тиков в одной игровой итерации */
+#define ROTATIONS_COUNT 4 /*!< Количество состояний поворота фигуры */
+#define TICK_MS 10 /*!< Длительность одного игрового тика в миллисекундах */
+#define LEVELS_COUNT 10 /*!< Количество уровней сложности */
+#define HIGH_SCORE_FILE "high_score.dat" /*!< Файл рекорда по умолчанию */
+#define FIELD_FULL_ROW \
+  ((uint16_t)((1u << FIELD_WIDTH) - 1)) /*!< Маска заполненной строки */
 
 typedef enum GameState {
   Start,   ///< Инициализация игры
@@ -31,7 +37,8 @@ typedef enum UserAction {
   RIGHT,      ///< Перемещение вправо
   DOWN,       ///< Перемещение вниз
   ROTATE,     ///< Поворот фигуры
-  ACTION      ///< Действие в игре
+  ACTION,     ///< Действие в игре
+  HARD_DROP   ///< Мгновенное падение и фиксация фигуры
 } UserAction;
 
 /**
@@ -48,24 +55,60 @@ typedef struct Block {
  * @struct Field
  * @brief Структура, представляющая игровое поле.
  *
- * Эта структура содержит массив блоков, представляющих игровое поле,
- * на котором располагаются фигуры.
+ * Поле хранится в виде битовых масок: каждая строка - это `uint16_t`,
+ * в котором бит `j` установлен, если занят блок в столбце `j`. Всё поле
+ * занимает 40 байт, поэтому проверка заполненности строки сводится к одному
+ * сравнению, а проверка столкновения - к нескольким операциям AND.
+ * Для поблочного доступа используются функции getBlock() и setBlock().
+ *
+ * Маска `dirty` отмечает строки, в которых блоки добавлялись после
+ * последнего вызова eraseLines(): заполниться могла только такая строка.
+ *
+ * Массив `heights` хранит высоту каждого столбца - число строк от дна поля
+ * до верхнего занятого блока включительно (0 для пустого столбца). Он
+ * обновляется при фиксации фигуры, удалении линий и в setBlock(), и по нему
+ * место падения фигуры находится без пошаговой проверки столкновений.
+ *
+ * `hash` - хеш Зобриста поля: XOR ключей всех занятых клеток. Он
+ * обновляется в тех же местах, что и высоты, и всегда равен hashField().
  */
 typedef struct Field {
-  Block **blocks;  ///< Двумерный массив блоков, представляющий поле
+  uint16_t rows[FIELD_HEIGHT];  ///< Битовые маски строк поля
+  uint32_t dirty;  ///< Бит `i` - строка `i` изменена после eraseLines()
+  uint8_t heights[FIELD_WIDTH];  ///< Высоты столбцов поля
+  uint64_t hash;                 ///< Хеш Зобриста занятых клеток
 } Field;
 
+/**
+ * @struct FigureShape
+ * @brief Структура, представляющая одно состояние поворота фигуры.
+ *
+ * Матрица фигуры 5x5 хранится в виде масок строк: бит `j` в `rows[i]`
+ * установлен, если занят блок в строке `i` и столбце `j`. Границы задают
+ * ограничивающий прямоугольник занятых блоков внутри матрицы.
+ */
+typedef struct FigureShape {
+  uint8_t rows[FIGURE_HEIGHT];  ///< Битовые маски строк фигуры
+  int8_t top;     ///< Первая занятая строка
+  int8_t bottom;  ///< Последняя занятая строка
+  int8_t left;    ///< Первый занятый столбец
+  int8_t right;   ///< Последний занятый столбец
+  int8_t bottoms[FIGURE_WIDTH];  ///< Нижняя занятая строка столбца или -1
+} FigureShape;
+
 /**
  * @struct Figure
  * @brief Структура, представляющая фигуру.
  *
- * Эта структура содержит координаты фигуры и массив блоков, которые
- * образуют фигуру.
+ * Эта структура содержит координаты фигуры, её идентификатор и номер
+ * состояния поворота. Форма фигуры берётся из заранее рассчитанной таблицы
+ * figureShapes, поэтому поворот не требует копирования блоков.
  */
 typedef struct Figure {
   int x;  ///< Координата по горизонтали (сдвиг)
   int y;  ///< Координата по вертикали (высота)
-  Block **blocks;  ///< Двумерный массив блоков, представляющий фигуру
+  int id;        ///< Идентификатор фигуры
+  int rotation;  ///< Номер состояния поворота (от 0 до ROTATIONS_COUNT - 1)
 } Figure;
 
 /**
@@ -75,7 +118,7 @@ typedef struct Figure {
  * Эта структура содержит массив блоков для всех фигур, доступных в игре.
  */
 typedef struct FiguresT {
-  Block **blocks;  ///< Двумерный массив блоков для всех фигур
+  Block *blocks[FIGURES_COUNT];  ///< Матрицы блоков для всех фигур
 } FiguresT;
 
 /**
@@ -89,6 +132,19 @@ typedef struct Player {
       action;  ///< Действие игрока, например, перемещение или поворот фигуры
 } Player;
 
+/**
+ * @struct Random
+ * @brief Состояние генератора псевдослучайных чисел PCG32.
+ *
+ * У каждой игры собственный генератор, поэтому игры в разных потоках не
+ * разделяют изменяемое состояние, а последовательность фигур определяется
+ * начальным значением.
+ */
+typedef struct Random {
+  uint64_t state;  ///< Внутреннее состояние генератора
+  uint64_t inc;    ///< Приращение (номер последовательности), всегда нечётное
+} Random;
+
 /**
  * @struct GameInfo
  * @brief Структура, содержащая информацию об игре.
@@ -103,9 +159,15 @@ typedef struct GameInfo {
   int level;       ///< Уровень сложности
   int speed;       ///< Скорость игры
   int pause;  ///< Флаг паузы (0 - не приостановлено, 1 - приостановлено)
-  int ticks_left;  ///< Остаток тиков до следующего действия
-  int ticks;        ///< Общее количество тиков
+  int ticks_left;  ///< Остаток тиков до следующего шага фигуры вниз
+  int ticks;  ///< Количество тиков между шагами фигуры вниз (по уровню)
+  int pieces;       ///< Количество появившихся фигур
   GameState state;  ///< Текущее состояние игры
+  Random random;    ///< Генератор случайных фигур
+  uint64_t seed;    ///< Начальное значение генератора
+  bool useBag;      ///< Фигуры выдаются "мешками" по FIGURES_COUNT штук
+  int bagLeft;      ///< Количество фигур, оставшихся в мешке
+  uint8_t bag[FIGURES_COUNT];  ///< Оставшиеся фигуры текущего мешка
 } GameInfo;
 
 /**
@@ -114,7 +176,9 @@ typedef struct GameInfo {
  *
  * Эта структура объединяет всю необходимую информацию для управления
  * игровым процессом, включая информацию об игре, поле, текущую фигуру
- * и игрока.
+ * и игрока. Игра, созданная initGame(), размещается в памяти одним блоком:
+ * указатели ссылаются на части этого блока, а resetGame() переиспользует
+ * его без новых выделений памяти.
  */
 typedef struct Game {
   GameInfo *gameInfo;  ///< Указатель на информацию об игре
@@ -124,15 +188,63 @@ typedef struct Game {
   Player *player;  ///< Указатель на игрока
 } Game;  ///< Тип, представляющий состояние игры "Тетрис"
 
+/**
+ * @struct GameSnapshot
+ * @brief Снимок изменяемого состояния игры.
+ *
+ * Снимок не содержит указателей: поле, текущая фигура, генератор фигур,
+ * счёт, уровень и тики хранятся по значению, поэтому снимок копируется
+ * присваиванием или одним memcpy(). Шаблоны фигур (FiguresT) не меняются
+ * во время игры и в снимок не входят.
+ */
+typedef struct GameSnapshot {
+  GameInfo gameInfo;  ///< Информация об игре
+  Field field;        ///< Игровое поле
+  Figure figure;      ///< Текущая фигура
+  Player player;      ///< Игрок
+} GameSnapshot;
+
+/**
+ * @struct GameConfig
+ * @brief Параметры создания игры.
+ */
+typedef struct GameConfig {
+  const char *highScorePath;  ///< Файл рекорда, NULL - не загружать рекорд
+  uint64_t seed;  ///< Начальное значение генератора случайных фигур
+  bool useBag;    ///< Генератор "мешок из 7 фигур" вместо равновероятного
+} GameConfig;
+
 // init object
 Game *initGame();
+Game *initGameWith(const GameConfig *config);
+void resetGame(Game *game);
+Game *cloneGame(const Game *game);
+void snapshotGame(const Game *game, GameSnapshot *snapshot);
+void restoreGame(Game *game, const GameSnapshot *snapshot);
+Game snapshotView(GameSnapshot *snapshot, FiguresT *figurest);
 GameInfo *createGameInfo();
+void fillGameInfo(GameInfo *gameInfo);
 Field *createField();
+void clearField(Field *field);
 Figure *createFigure();
 FiguresT *createFiguresT();
+void fillFiguresT(FiguresT *figurest);
 Player *createPlayer();
 int **createNextBlock(Game *game);
 
+// field blocks
+int getBlock(const Field *field, int y, int x);
+void setBlock(Field *field, int y, int x, int value);
+uint64_t hashField(const Field *field);
+uint64_t zobristKey(int y, int x);
+uint64_t zobristRow(int y, uint16_t mask);
+void updateHeights(Field *field);
+void lowerHeights(Field *field, uint32_t cleared);
+
+// figure blocks
+const FigureShape *getFigureShape(const Figure *figure);
+int getFigureBlock(const Figure *figure, int i, int j);
+
 // free object
 void freeGame(Game *game);
 void freeGameInfo(GameInfo *gameInfo);
@@ -144,21 +256,36 @@ void freeNextBlock(int **next);
 // highScore
 void saveHighScore(int high_score);
 int loadHighScore();
+void saveHighScoreTo(const char *path, int high_score);
+int loadHighScoreFrom(const char *path);
+
+// random
+void seedRandom(Random *random, uint64_t seed);
+uint32_t nextRandom(Random *random);
+int randomRange(Random *random, int n);
+int randomFigure(GameInfo *gameInfo);
 
 // move figure
 void upFigure(Figure *figure);
 void downFigure(Figure *figure);
 void leftFigure(Figure *figure);
 void rightFigure(Figure *figure);
-Figure *rotationFigure(Game *game);
+void rotationFigure(Figure *figure);
 
 // logic
 bool inField(int fx, int fy);
+void spawnFigure(Figure *figure, int id);
 void dropNewFigure(Game *game);
 void updateCurrentState(Game *game);
 void calculate(Game *game);
+int levelTicks(int level);
+void stepGame(Game *game, UserAction action);
 void calcOne(Game *game);
 bool collision(Game *game);
+bool figureCollides(const Field *field, const Figure *figure);
+int landingRow(const Field *field, const Figure *figure);
+void hardDrop(Game *game);
+void lockFigure(Game *game);
 int eraseLines(Field *field);
 bool lineFilled(int i, Field *field);
 void dropLine(int i, Field *field);
@@ -169,6 +296,7 @@ void down(Game *game);
 void left(Game *game);
 void right(Game *game);
 void plantFigure(Game *game);
+void plantShape(Field *field, const Figure *figure);
 void countScore(Game *game);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,227 @@
+/**
+ * @file ansi.c
+ * @brief Вывод кадров escape-последовательностями ANSI одним write().
+ *
+ * Кадр собирается в заранее выделенном буфере по разнице с предыдущим
+ * кадром (те же клетки, что и у вывода через ncurses: fieldCells(),
+ * nextCells(), infoValues()) и передаётся терминалу одним вызовом write().
+ * Курсор перемещается только если следующая клетка не стоит сразу за
+ * предыдущей, цвет меняется только при смене цветовой пары. Если ничего
+ * не изменилось, кадр не выводится.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "ansi.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../../brick_game/tetris/profile.h"
+
+/**
+ * @struct AnsiOutput
+ * @brief Буфер кадра и известное состояние терминала.
+ */
+typedef struct AnsiOutput {
+  char buffer[ANSI_BUFFER_SIZE];  ///< Собираемый кадр
+  size_t length;                  ///< Занято байт буфера
+  int fd;                         ///< Дескриптор терминала
+  int y;      ///< Строка курсора, -1 - неизвестна
+  int x;      ///< Столбец курсора
+  int color;  ///< Текущая цветовая пара, 0 - неизвестна
+} AnsiOutput;
+
+static AnsiOutput output; /*!< Буфер и состояние терминала */
+static Screen screen;     /*!< Последний выведенный кадр */
+
+/**
+ * @brief Цвета символов и фона цветовых пар (как в initGui()).
+ */
+static const char *const pairColors[] = {"", "\033[30;100m", "\033[32;42m",
+                                         "\033[32;40m", "\033[90;40m"};
+
+/**
+ * @brief Передаёт собранный кадр терминалу.
+ *
+ * Частичная запись и прерывание сигналом дописываются; при другой ошибке
+ * кадр отбрасывается.
+ */
+static void flushAnsi() {
+  size_t done = 0;
+  while (done < output.length) {
+    ssize_t written =
+        write(output.fd, output.buffer + done, output.length - done);
+    if (written > 0)
+      done += (size_t)written;
+    else if (written < 0 && errno != EINTR)
+      break;
+  }
+  output.length = 0;
+}
+
+/**
+ * @brief Добавляет байты в буфер кадра.
+ *
+ * Буфер рассчитан на полный кадр; если он всё же заполнен, собранная часть
+ * выводится отдельным write().
+ *
+ * @param data Байты.
+ * @param length Количество байт.
+ */
+static void append(const char *data, size_t length) {
+  if (output.length + length > ANSI_BUFFER_SIZE) flushAnsi();
+  memcpy(output.buffer + output.length, data, length);
+  output.length += length;
+}
+
+/**
+ * @brief Перемещает курсор, если он не стоит в нужном месте.
+ * @param y Строка экрана (с 0).
+ * @param x Столбец экрана (с 0).
+ */
+static void moveTo(int y, int x) {
+  if (output.y != y || output.x != x) {
+    char sequence[24];
+    int length = snprintf(sequence, sizeof(sequence), "\033[%d;%dH", y + 1,
+                          x + 1);
+    append(sequence, (size_t)length);
+    output.y = y;
+    output.x = x;
+  }
+}
+
+/**
+ * @brief Выбирает цветовую пару, если она не выбрана.
+ * @param color Цветовая пара (1-4).
+ */
+static void setColor(int color) {
+  if (output.color != color) {
+    append(pairColors[color], strlen(pairColors[color]));
+    output.color = color;
+  }
+}
+
+/**
+ * @brief Выводит текст с текущего положения курсора.
+ * @param text Текст.
+ * @param length Количество символов.
+ */
+static void putText(const char *text, int length) {
+  append(text, (size_t)length);
+  output.x += length;
+}
+
+/**
+ * @brief Выводит клетку экрана шириной в два символа.
+ * @param y Строка экрана.
+ * @param x Столбец экрана.
+ * @param cell Клетка, закодированная SCREEN_CELL().
+ */
+static void putCell(int y, int x, int cell) {
+  char text[2] = {(char)((cell >> 8) & 0xFF), (char)((cell >> 16) & 0xFF)};
+  moveTo(y, x);
+  setColor(cell & 0xFF);
+  putText(text, 2);
+}
+
+/**
+ * @brief Готовит терминал к выводу кадров.
+ *
+ * Первый кадр очищает экран и выводится полностью.
+ *
+ * @param fd Дескриптор терминала.
+ */
+void initAnsi(int fd) {
+  output.fd = fd;
+  output.length = 0;
+  screen.valid = false;
+}
+
+/**
+ * @brief Помечает экран для полной перерисовки следующим кадром.
+ *
+ * Следующий кадр очищает экран, как первый.
+ */
+void redrawAnsi() { screen.valid = false; }
+
+/**
+ * @brief Выводит кадр игры одним write().
+ * @param game Указатель на структуру Game, содержащую данные о текущей игре.
+ */
+void printGameAnsi(Game *game) {
+  int field[FIELD_HEIGHT][FIELD_WIDTH];
+  int next[FIGURE_HEIGHT][FIGURE_WIDTH];
+  int values[INFO_COUNT];
+  fieldCells(game, field);
+  nextCells(game, next);
+  infoValues(game->gameInfo, values);
+
+  if (!screen.valid) {
+    static const char clear[] = "\033[?25l\033[0m\033[2J";
+    append(clear, sizeof(clear) - 1);
+    output.y = -1;
+    output.color = 0;
+    for (int i = 0; i < LABEL_COUNT; i++) {
+      moveTo(labelLines[i].y, labelLines[i].x);
+      setColor(labelLines[i].color);
+      putText(labelLines[i].format, (int)strlen(labelLines[i].format));
+    }
+  }
+
+  for (int i = 0; i < FIELD_HEIGHT; i++) {
+    for (int j = 0; j < FIELD_WIDTH; j++) {
+      if (!screen.valid || screen.field[i][j] != field[i][j]) {
+        putCell(i + 3, j * 2 + 2, field[i][j]);
+        screen.field[i][j] = field[i][j];
+      }
+    }
+  }
+  for (int i = 0; i < FIGURE_HEIGHT; i++) {
+    for (int j = 0; j < FIGURE_WIDTH; j++) {
+      if (!screen.valid || screen.next[i][j] != next[i][j]) {
+        putCell(i + 5, j * 2 + 28, next[i][j]);
+        screen.next[i][j] = next[i][j];
+      }
+    }
+  }
+  for (int i = 0; i < INFO_COUNT; i++) {
+    if (!screen.valid || screen.info[i] != values[i]) {
+      char text[32];
+      int length = snprintf(text, sizeof(text), infoLines[i].format,
+                            values[i]);
+      moveTo(infoLines[i].y, infoLines[i].x);
+      setColor(infoLines[i].color);
+      putText(text, length);
+      append("\033[K", 3);
+#ifdef TETRIS_PROFILE
+      forgetOverlayRow(infoLines[i].y);
+#endif
+      screen.info[i] = values[i];
+    }
+  }
+#ifdef TETRIS_PROFILE
+  char lines[OVERLAY_LINES][OVERLAY_WIDTH];
+  int count = overlayLines(lines);
+  for (int i = 0; i < count; i++) {
+    if (overlayChanged(i, lines[i]) || !screen.valid) {
+      moveTo(OVERLAY_ROW + i, OVERLAY_COLUMN);
+      setColor(4);
+      putText(lines[i], (int)strlen(lines[i]));
+      append("\033[K", 3);
+    }
+  }
+#endif
+  screen.valid = true;
+
+  if (output.length) flushAnsi();
+}
+
+/**
+ * @brief Сбрасывает цвета терминала и показывает курсор.
+ */
+void closeAnsi() {
+  static const char reset[] = "\033[0m\033[?25h";
+  append(reset, sizeof(reset) - 1);
+  flushAnsi();
+}
@@ -0,0 +1,13 @@
+#ifndef ANSI_H_
+#define ANSI_H_
+
+#include "cli.h"
+
+#define ANSI_BUFFER_SIZE 16384 /*!< Размер буфера кадра в байтах */
+
+void initAnsi(int fd);
+void printGameAnsi(Game *game);
+void redrawAnsi();
+void closeAnsi();
+
+#endif
@@ -1,15 +1,61 @@
 #include "cli.h"
 
+#include <poll.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
+
+#include "../../brick_game/tetris/profile.h"
+#include "ansi.h"
 /** @file */
 
+#define MESSAGE_ROW 9 /*!< Строка поля, поверх которой выводятся сообщения */
+#define ESCAPE_DELAY_MS \
+  25 /*!< Ожидание продолжения escape-последовательности клавиши */
+
+/**
+ * @brief Подписи, выводимые при полной перерисовке экрана.
+ */
+const InfoLine labelLines[LABEL_COUNT] = {
+    {1, 10, 4, "TETRIS"},
+    {3, 45, 4, "Start: 'Enter'"},
+    {4, 45, 4, "Pause: 'p'"},
+    {5, 45, 4, "Exit: 'q'"},
+    {6, 45, 4, "Arrows to move: 'a' 'd'"},
+    {7, 45, 4, "Space to rotate"},
+    {8, 45, 4, "Arrow down to plant: 's'"},
+    {9, 45, 4, "Arrow up to drop"},
+    {3, 26, 3, "Next figure:"}};
+
+/**
+ * @brief Положение и формат выводимых значений (см. InfoValue).
+ */
+const InfoLine infoLines[INFO_COUNT] = {
+    {11, 26, 3, "Lvl: %d"},   {13, 26, 3, "Speed: %d"},
+    {15, 26, 3, "Score: %d"}, {17, 26, 3, "High score: %d"},
+    {19, 26, 3, "nextID: %d"}, {10, 45, 4, "%d"}};
+
+static Screen screen; /*!< Последний выведенный кадр */
+static RenderBackend backend = RenderCurses; /*!< Вывод кадров */
+#ifdef TETRIS_PROFILE
+static bool showProfile = false; /*!< Показывать профиль (клавиша 'o') */
 /**
- * @brief Инициализация NCURSES.
+ * @brief Строки профиля на экране, общие для обоих способов вывода.
+ */
+static char overlayShown[OVERLAY_LINES][OVERLAY_WIDTH];
+#endif
+
+/**
+ * @brief Инициализация NCURSES и выбранного вывода кадров.
+ *
+ * Ввод с клавиатуры всегда читается через ncurses. При выводе RenderAnsi
+ * ncurses после первой очистки экрана больше ничего не рисует: stdscr не
+ * меняется, поэтому getch() не выводит обновлений, а кадры пишет
+ * ansi.c.
  *
- * @return статус выполнения функции.
+ * @param render Способ вывода кадров.
  */
-void initGui() {
+void initGui(RenderBackend render) {
   initscr();
   curs_set(0);
   start_color();
@@ -21,63 +67,170 @@ void initGui() {
   cbreak();
   noecho();
   nodelay(stdscr, TRUE);
+  keypad(stdscr, TRUE);
+  set_escdelay(ESCAPE_DELAY_MS);
   scrollok(stdscr, TRUE);
+  screen.valid = false;
+  backend = render;
+  if (backend == RenderAnsi) {
+    refresh();
+    initAnsi(STDOUT_FILENO);
+  }
+}
+
+/**
+ * @brief Восстанавливает терминал после игры.
+ */
+void closeGui() {
+  if (backend == RenderAnsi) closeAnsi();
+  endwin();
+}
+
+/**
+ * @brief Помечает экран для полной перерисовки следующим кадром.
+ *
+ * Вызывается после изменения размера терминала (KEY_RESIZE).
+ */
+void redrawGui() {
+  screen.valid = false;
+  if (backend == RenderAnsi)
+    redrawAnsi();
+  else
+    clear();
 }
 
 /**
  * @brief Отображает все элементы игры
  *
+ * Выводятся только изменения с предыдущего кадра; если изменений нет,
+ * экран не обновляется.
+ *
  * @param game Указатель на структуру Game, содержащую данные о текущей игре.
- * @param sp_start Время начала текущего шага.
- * @param sp_end Время конца текущего шага.
  */
 void printGame(Game *game) {
-  printField(game);
-  printFigure(game);
-  printNextFigure(game);
-  printInfo(game->gameInfo);
+  if (backend == RenderAnsi) {
+    printGameAnsi(game);
+  } else {
+    int changes = printField(game);
+    changes += printNextFigure(game);
+    changes += printInfo(game->gameInfo);
+    screen.valid = true;
 
-  timeout(TICKS);
+    if (changes) refresh();
+  }
+}
 
-  refresh();
+/**
+ * @brief Выводит клетку экрана шириной в два символа.
+ *
+ * @param y Строка экрана.
+ * @param x Столбец экрана.
+ * @param cell Клетка, закодированная SCREEN_CELL().
+ */
+static void printCell(int y, int x, int cell) {
+  int color = cell & 0xFF;
+  attron(COLOR_PAIR(color));
+  mvaddch(y, x, (cell >> 8) & 0xFF);
+  mvaddch(y, x + 1, (cell >> 16) & 0xFF);
+  attroff(COLOR_PAIR(color));
 }
 
 /**
- * @brief Отображает игровое поле.
+ * @brief Составляет клетки игрового поля вместе с текущей фигурой.
+ *
+ * Место, куда упадёт фигура, показывается контуром ("тень" фигуры).
+ * Сообщения о паузе и окончании игры выводятся поверх строки MESSAGE_ROW
+ * и входят в кадр поля.
  *
  * @param game Указатель на структуру Game, содержащую данные о поле.
+ * @param cells Клетки поля, закодированные SCREEN_CELL().
  */
-void printField(Game *game) {
+void fieldCells(Game *game, int cells[FIELD_HEIGHT][FIELD_WIDTH]) {
+  const char *message = NULL;
+  if (game->gameInfo->state == GameOver)
+    message = "      GameOver      ";
+  else if (game->gameInfo->pause)
+    message = "Press ENTER to play.";
+
+  Figure *figure = game->figure;
+  Figure ghost = *figure;
+  if (game->gameInfo->state != GameOver && !figureCollides(game->field, figure))
+    ghost.y = landingRow(game->field, figure);
   for (int i = 0; i < FIELD_HEIGHT; i++) {
     for (int j = 0; j < FIELD_WIDTH; j++) {
-      int sym = game->field->blocks[i][j].block ? 2 : 1;
-      attron(COLOR_PAIR(sym));
-      mvaddch(i + 3, j * 2 + 2, ' ');
-      mvaddch(i + 3, j * 2 + 3, ' ');
-      attroff(COLOR_PAIR(sym));
+      int fi = i - figure->y;
+      int fj = j - figure->x;
+      int gi = i - ghost.y;
+      bool filled = getBlock(game->field, i, j) ||
+                    (fi >= 0 && fi < FIGURE_HEIGHT && fj >= 0 &&
+                     fj < FIGURE_WIDTH && getFigureBlock(figure, fi, fj));
+      bool shadow = gi >= 0 && gi < FIGURE_HEIGHT && fj >= 0 &&
+                    fj < FIGURE_WIDTH && getFigureBlock(&ghost, gi, fj);
+      int cell = SCREEN_CELL(filled ? 2 : 1, ' ', ' ');
+      if (!filled && shadow) cell = SCREEN_CELL(1, '[', ']');
+      if (message && i == MESSAGE_ROW)
+        cell = SCREEN_CELL(3, message[j * 2], message[j * 2 + 1]);
+      cells[i][j] = cell;
+    }
+  }
+}
+
+/**
+ * @brief Составляет клетки области следующей фигуры.
+ * @param game Указатель на структуру Game, содержащую данные о следующей
+ * фигуре.
+ * @param cells Клетки области, закодированные SCREEN_CELL().
+ */
+void nextCells(Game *game, int cells[FIGURE_HEIGHT][FIGURE_WIDTH]) {
+  for (int i = 0; i < FIGURE_HEIGHT; i++) {
+    for (int j = 0; j < FIGURE_WIDTH; j++) {
+      int num =
+          game->figurest->blocks[game->gameInfo->nextID][i * FIGURE_WIDTH + j]
+                  .block
+              ? 2
+              : 3;
+      cells[i][j] = SCREEN_CELL(num, ' ', ' ');
     }
   }
 }
 
 /**
- * @brief Отображает текущую фигуру на игровом поле.
+ * @brief Составляет выводимые значения информации об игре.
+ * @param gameInfo Указатель на структуру GameInfo.
+ * @param values Значения в порядке InfoValue.
+ */
+void infoValues(const GameInfo *gameInfo, int values[INFO_COUNT]) {
+  values[INFO_LEVEL] = gameInfo->level;
+  values[INFO_SPEED] = gameInfo->speed;
+  values[INFO_SCORE] = gameInfo->score;
+  values[INFO_HIGH_SCORE] = gameInfo->high_score;
+  values[INFO_NEXT_ID] = gameInfo->nextID;
+  values[INFO_STATE] = gameInfo->state;
+}
+
+/**
+ * @brief Отображает игровое поле вместе с текущей фигурой.
  *
- * Использует координаты фигуры и ее блоки для вывода на экран.
+ * Перерисовываются только клетки, изменившиеся с предыдущего кадра (см.
+ * fieldCells()).
  *
- * @param game Указатель на структуру Game, содержащую текущую фигуру.
+ * @param game Указатель на структуру Game, содержащую данные о поле.
+ * @return Количество перерисованных клеток.
  */
-void printFigure(Game *game) {
-  Figure *figure = game->figure;
-  for (int i = 0; i < FIGURE_HEIGHT; ++i) {
-    for (int j = 0; j < FIGURE_WIDTH; ++j) {
-      if (figure->blocks[i][j].block != 0) {
-        attron(COLOR_PAIR(2));
-        mvaddch(i + 3 + figure->y, j * 2 + 2 + figure->x * 2, ' ');
-        mvaddch(i + 3 + figure->y, j * 2 + 3 + figure->x * 2, ' ');
-        attroff(COLOR_PAIR(2));
+int printField(Game *game) {
+  int cells[FIELD_HEIGHT][FIELD_WIDTH];
+  fieldCells(game, cells);
+  int changes = 0;
+  for (int i = 0; i < FIELD_HEIGHT; i++) {
+    for (int j = 0; j < FIELD_WIDTH; j++) {
+      if (!screen.valid || screen.field[i][j] != cells[i][j]) {
+        printCell(i + 3, j * 2 + 2, cells[i][j]);
+        screen.field[i][j] = cells[i][j];
+        changes++;
       }
     }
   }
+  return changes;
 }
 
 /**
@@ -88,95 +241,236 @@ void printFigure(Game *game) {
  *
  * @param game Указатель на структуру Game, содержащую данные о следующей
  * фигуре.
+ * @return Количество перерисованных клеток.
  */
-void printNextFigure(Game *game) {
+int printNextFigure(Game *game) {
+  int cells[FIGURE_HEIGHT][FIGURE_WIDTH];
+  nextCells(game, cells);
+  int changes = 0;
   for (int i = 0; i < FIGURE_HEIGHT; i++) {
     for (int j = 0; j < FIGURE_WIDTH; j++) {
-      int num =
-          game->figurest->blocks[game->gameInfo->nextID][i * FIGURE_WIDTH + j]
-                  .block
-              ? 2
-              : 3;
-      attron(COLOR_PAIR(num));
-      mvaddch(i + 5, j * 2 + 28, ' ');
-      mvaddch(i + 5, j * 2 + 29, ' ');
-      attroff(COLOR_PAIR(num));
+      if (!screen.valid || screen.next[i][j] != cells[i][j]) {
+        printCell(i + 5, j * 2 + 28, cells[i][j]);
+        screen.next[i][j] = cells[i][j];
+        changes++;
+      }
+    }
+  }
+  return changes;
+}
+
+#ifdef TETRIS_PROFILE
+/**
+ * @brief Составляет строки профиля кадра для вывода на экран.
+ *
+ * Для каждой фазы кадра выводятся медиана и 99-й процентиль длительности
+ * в микросекундах, затем счётчики событий (см. profile.h).
+ *
+ * @param lines Строки профиля.
+ * @return Количество строк, 0 - профиль скрыт.
+ */
+int overlayLines(char lines[OVERLAY_LINES][OVERLAY_WIDTH]) {
+  int count = 0;
+  if (showProfile) {
+    for (int i = 0; i < PHASE_COUNT; i++) {
+      const Histogram *histogram = profileHistogram((ProfilePhase)i);
+      snprintf(lines[count++], OVERLAY_WIDTH, "%-6s p50 %7.1f p99 %7.1f us",
+               profilePhaseName((ProfilePhase)i),
+               (double)histogramPercentile(histogram, 50) / 1000.0,
+               (double)histogramPercentile(histogram, 99) / 1000.0);
+    }
+    snprintf(lines[count++], OVERLAY_WIDTH, "spawns %llu locks %llu",
+             (unsigned long long)profileCounter(CounterSpawns),
+             (unsigned long long)profileCounter(CounterLocks));
+    snprintf(lines[count++], OVERLAY_WIDTH, "lines %llu allocs %llu",
+             (unsigned long long)profileCounter(CounterLines),
+             (unsigned long long)profileCounter(CounterAllocations));
+  }
+  return count;
+}
+
+/**
+ * @brief Отображает изменившиеся строки профиля кадра.
+ * @return Количество перерисованных строк.
+ */
+static int printOverlay() {
+  char lines[OVERLAY_LINES][OVERLAY_WIDTH];
+  int count = overlayLines(lines);
+  int changes = 0;
+  for (int i = 0; i < count; i++) {
+    if (overlayChanged(i, lines[i]) || !screen.valid) {
+      attron(COLOR_PAIR(4));
+      mvwprintw(stdscr, OVERLAY_ROW + i, OVERLAY_COLUMN, "%s", lines[i]);
+      clrtoeol();
+      attroff(COLOR_PAIR(4));
+      changes++;
     }
   }
+  return changes;
+}
+
+/**
+ * @brief Запоминает строку профиля и сообщает, нужно ли её вывести.
+ * @param i Номер строки профиля.
+ * @param line Новый текст строки.
+ * @return true, если текст отличается от выведенного или строка стёрта.
+ */
+bool overlayChanged(int i, const char *line) {
+  bool changed = strcmp(overlayShown[i], line) != 0;
+  if (changed) strcpy(overlayShown[i], line);
+  return changed;
 }
 
+/**
+ * @brief Отмечает строку профиля как стёртую.
+ *
+ * Значения информации стирают строку экрана до конца (clrtoeol(), а при
+ * выводе RenderAnsi - `ESC [K`), в том числе часть профиля правее них;
+ * такая строка профиля выводится заново. Вызывается обоими способами
+ * вывода.
+ *
+ * @param y Строка экрана.
+ */
+void forgetOverlayRow(int y) {
+  if (y >= OVERLAY_ROW && y < OVERLAY_ROW + OVERLAY_LINES)
+    overlayShown[y - OVERLAY_ROW][0] = '\0';
+}
+#endif
+
 /**
  * @brief Отображает информацию о текущем состоянии игры.
  *
- * Выводит уровень, скорость, счет, максимальный результат.
+ * Выводит уровень, скорость, счет, максимальный результат. Постоянные
+ * подписи выводятся только при полной перерисовке экрана, значения - при
+ * их изменении.
  *
  * @param gameInfo Указатель на структуру GameInfo, содержащую данные об игре.
+ * @return Количество перерисованных элементов.
+ */
+int printInfo(GameInfo *gameInfo) {
+  int values[INFO_COUNT];
+  infoValues(gameInfo, values);
+  int changes = 0;
+
+  if (!screen.valid) {
+    for (int i = 0; i < LABEL_COUNT; i++) {
+      attron(COLOR_PAIR(labelLines[i].color));
+      mvwprintw(stdscr, labelLines[i].y, labelLines[i].x, "%s",
+                labelLines[i].format);
+      attroff(COLOR_PAIR(labelLines[i].color));
+    }
+    changes++;
+  }
+
+  for (int i = 0; i < INFO_COUNT; i++) {
+    if (!screen.valid || screen.info[i] != values[i]) {
+      attron(COLOR_PAIR(infoLines[i].color));
+      mvwprintw(stdscr, infoLines[i].y, infoLines[i].x, infoLines[i].format,
+                values[i]);
+      clrtoeol();
+      attroff(COLOR_PAIR(infoLines[i].color));
+#ifdef TETRIS_PROFILE
+      forgetOverlayRow(infoLines[i].y);
+#endif
+      screen.info[i] = values[i];
+      changes++;
+    }
+  }
+#ifdef TETRIS_PROFILE
+  changes += printOverlay();
+#endif
+  return changes;
+}
+
+/**
+ * @brief Переводит код клавиши в действие игрока.
+ *
+ * Стрелки распознаются ncurses (keypad()) как KEY_LEFT и т. п., а не по
+ * байтам escape-последовательности.
+ *
+ * @param key Код клавиши, возвращённый getch().
+ * @return Действие; ACTION для клавиш без действия.
  */
-void printInfo(GameInfo *gameInfo) {
-  attron(COLOR_PAIR(4));
-  mvwprintw(stdscr, 1, 10, "TETRIS");
-  attroff(COLOR_PAIR(4));
-
-  attron(COLOR_PAIR(3));
-  mvwprintw(stdscr, 3, 26, "Next figure:");
-  mvwprintw(stdscr, 11, 26, "Lvl: %d", gameInfo->level);
-  mvwprintw(stdscr, 13, 26, "Speed: %d", gameInfo->speed);
-  mvwprintw(stdscr, 15, 26, "Score: %d", gameInfo->score);
-  mvwprintw(stdscr, 17, 26, "nextID: %d", gameInfo->nextID);
-  clrtoeol();
-  mvwprintw(stdscr, 17, 26, "High score: %d", gameInfo->high_score);
-  mvwprintw(stdscr, 19, 26, "nextID: %d", gameInfo->nextID);
-
-  if (gameInfo->pause) mvwprintw(stdscr, 12, 2, "Press ENTER to play.");
-  if (gameInfo->state == GameOver)
-    mvwprintw(stdscr, 12, 2, "      GameOver      ");
-  attroff(COLOR_PAIR(3));
-  attron(COLOR_PAIR(4));
-  mvwprintw(stdscr, 3, 45, "Start: 'Enter'");
-  mvwprintw(stdscr, 4, 45, "Pause: 'p'");
-  mvwprintw(stdscr, 5, 45, "Exit: 'q'");
-  mvwprintw(stdscr, 6, 45, "Arrows to move: 'a' 'd'");
-  mvwprintw(stdscr, 7, 45, "Space to rotate");
-  mvwprintw(stdscr, 8, 45, "Arrow down to plant: 's'");
-  mvwprintw(stdscr, 10, 45, "%d", gameInfo->state);
-  attroff(COLOR_PAIR(4));
-}
-
-/**
- * @brief Считывает действия игрока из ввода.
- *
- * Преобразует нажатия клавиш в действия игрока, такие как поворот, движение или
- * пауза.
- *
- * @param game Указатель на структуру Game, в которой обновляются действия
- * игрока.
- */
-void getActions(Game *game) {
-  char ch = getch();
-  switch (ch) {
+UserAction keyAction(int key) {
+  UserAction action = ACTION;
+  switch (key) {
     case ' ':
-      game->player->action = ROTATE;
+      action = ROTATE;
       break;
-    case 66:
-      game->player->action = DOWN;
+    case KEY_UP:
+      action = HARD_DROP;
       break;
-    case 67:
-      game->player->action = RIGHT;
+    case KEY_DOWN:
+    case 's':
+      action = DOWN;
       break;
-    case 68:
-      game->player->action = LEFT;
+    case KEY_RIGHT:
+    case 'd':
+      action = RIGHT;
+      break;
+    case KEY_LEFT:
+    case 'a':
+      action = LEFT;
       break;
     case '\n':
-      game->player->action = START;
+    case KEY_ENTER:
+      action = START;
       break;
     case 'p':
-      game->player->action = PAUSE;
+      action = PAUSE;
       break;
     case 'q':
-      game->player->action = TERMINATE;
-      break;
-    default:
-      game->player->action = ACTION;
+      action = TERMINATE;
       break;
   }
-}
\ No newline at end of file
+  return action;
+}
+
+/**
+ * @brief Считывает все нажатия клавиш, накопившиеся к этому кадру.
+ *
+ * Первое нажатие ожидается не дольше `timeoutMs`, после чего без ожидания
+ * вычитываются все остальные клавиши из буфера терминала. Каждое нажатие
+ * с действием передаётся в очередь (pushKey()) со временем чтения, так
+ * что несколько клавиш за кадр не теряются. В профиле кадра (TETRIS_PROFILE)
+ * фаза ввода измеряется от первого нажатия, без ожидания.
+ *
+ * @param queue Очередь действий игрока.
+ * @param timeoutMs Наибольшее время ожидания первого нажатия в
+ * миллисекундах.
+ */
+void getActions(InputQueue *queue, int timeoutMs) {
+  timeout(timeoutMs);
+  int key = getch();
+  PROFILE_BEGIN(inputStart);
+  for (; key != ERR; key = getch()) {
+    UserAction action = keyAction(key);
+    if (key == KEY_RESIZE) redrawGui();
+#ifdef TETRIS_PROFILE
+    if (key == 'o') {
+      showProfile = !showProfile;
+      redrawGui();
+    }
+#endif
+    if (action != ACTION) pushKey(queue, action, monotonicNs());
+    timeout(0);
+  }
+  PROFILE_END(PhaseInput, inputStart);
+}
+
+/**
+ * @brief Ожидает ввода без ограничения времени.
+ *
+ * Блокируется в poll() на стандартном вводе, не расходуя время процессора,
+ * пока не будет нажата клавиша или не придёт сигнал (SIGWINCH при
+ * изменении размера терминала прерывает poll() через обработчик ncurses).
+ * После пробуждения все накопившиеся клавиши передаются в очередь, как в
+ * getActions().
+ *
+ * @param queue Очередь действий игрока.
+ */
+void waitActions(InputQueue *queue) {
+  struct pollfd input = {STDIN_FILENO, POLLIN, 0};
+  poll(&input, 1, -1);
+  getActions(queue, 0);
+}
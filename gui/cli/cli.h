@@ -3,15 +3,91 @@
 
 #include <ncurses.h>
 
+#include "../../brick_game/tetris/input.h"
 #include "../../brick_game/tetris/tetris.h"
 
-void initGui();
+#define LABEL_COUNT 9 /*!< Количество постоянных подписей на экране */
+#define OVERLAY_LINES 5    /*!< Строк профиля на экране */
+#define OVERLAY_WIDTH 40   /*!< Наибольшая длина строки профиля */
+#define OVERLAY_ROW 12     /*!< Строка экрана первой строки профиля */
+#define OVERLAY_COLUMN 45  /*!< Столбец экрана строк профиля */
+
+/**
+ * @brief Кодирует клетку экрана: цветовую пару и два символа.
+ */
+#define SCREEN_CELL(color, left, right) \
+  ((color) | (unsigned char)(left) << 8 | (unsigned char)(right) << 16)
+
+/**
+ * @enum RenderBackend
+ * @brief Способ вывода кадров в терминал.
+ */
+typedef enum RenderBackend {
+  RenderCurses,  ///< Вывод через ncurses
+  RenderAnsi     ///< Один write() escape-последовательностей за кадр (ansi.h)
+} RenderBackend;
+
+/**
+ * @enum InfoValue
+ * @brief Выводимые значения информации об игре.
+ */
+typedef enum InfoValue {
+  INFO_LEVEL,       ///< Уровень
+  INFO_SPEED,       ///< Скорость
+  INFO_SCORE,       ///< Счёт
+  INFO_HIGH_SCORE,  ///< Рекорд
+  INFO_NEXT_ID,     ///< Идентификатор следующей фигуры
+  INFO_STATE,       ///< Состояние игры
+  INFO_COUNT        ///< Количество значений
+} InfoValue;
+
+/**
+ * @struct InfoLine
+ * @brief Положение и формат одного выводимого значения.
+ */
+typedef struct InfoLine {
+  int y;               ///< Строка экрана
+  int x;               ///< Столбец экрана
+  int color;           ///< Цветовая пара
+  const char *format;  ///< Формат вывода
+} InfoLine;
+
+/**
+ * @struct Screen
+ * @brief Копия последнего выведенного кадра.
+ *
+ * Кадр выводится по разнице с этой копией: изменившиеся клетки поля и
+ * следующей фигуры и изменившиеся значения информации. Если ничего не
+ * изменилось, терминал не обновляется.
+ */
+typedef struct Screen {
+  int field[FIELD_HEIGHT][FIELD_WIDTH];     ///< Клетки поля
+  int next[FIGURE_HEIGHT][FIGURE_WIDTH];    ///< Клетки следующей фигуры
+  int info[INFO_COUNT];                     ///< Значения информации
+  bool valid;  ///< false - экран нужно вывести полностью
+} Screen;
+
+extern const InfoLine labelLines[LABEL_COUNT];
+extern const InfoLine infoLines[INFO_COUNT];
+
+void initGui(RenderBackend render);
+void closeGui();
+void redrawGui();
 void printGame(Game *game);
-void printField(Game *game);
-void printFigure(Game *game);
-void printNextFigure(Game *game);
-void printInfo(GameInfo *gameInfo);
-void getActions(Game *game);
+void fieldCells(Game *game, int cells[FIELD_HEIGHT][FIELD_WIDTH]);
+void nextCells(Game *game, int cells[FIGURE_HEIGHT][FIGURE_WIDTH]);
+void infoValues(const GameInfo *gameInfo, int values[INFO_COUNT]);
+int printField(Game *game);
+int printNextFigure(Game *game);
+int printInfo(GameInfo *gameInfo);
+void getActions(InputQueue *queue, int timeoutMs);
+void waitActions(InputQueue *queue);
+UserAction keyAction(int key);
 UserAction check_symbol(char ch);
+#ifdef TETRIS_PROFILE
+int overlayLines(char lines[OVERLAY_LINES][OVERLAY_WIDTH]);
+bool overlayChanged(int i, const char *line);
+void forgetOverlayRow(int y);
+#endif
 
-#endif
\ No newline at end of file
+#endif
@@ -241,7 +241,7 @@ START_TEST(countScore_1) {
   calculate(game);
 
   for (int i = FIELD_HEIGHT - 1; i > FIELD_HEIGHT - 2; --i)
-    for (int j = 0; j < FIELD_WIDTH; ++j) game->field->blocks[i][j].block = 1;
+    for (int j = 0; j < FIELD_WIDTH; ++j) setBlock(game->field, i, j, 1);
 
   countScore(game);
   int score = game->gameInfo->score;
@@ -259,7 +259,7 @@ START_TEST(countScore_2) {
   calculate(game);
 
   for (int i = FIELD_HEIGHT - 1; i > FIELD_HEIGHT - 3; --i)
-    for (int j = 0; j < FIELD_WIDTH; ++j) game->field->blocks[i][j].block = 1;
+    for (int j = 0; j < FIELD_WIDTH; ++j) setBlock(game->field, i, j, 1);
 
   countScore(game);
   int score = game->gameInfo->score;
@@ -277,7 +277,7 @@ START_TEST(countScore_3) {
   calculate(game);
 
   for (int i = FIELD_HEIGHT - 1; i > FIELD_HEIGHT - 4; --i)
-    for (int j = 0; j < FIELD_WIDTH; ++j) game->field->blocks[i][j].block = 1;
+    for (int j = 0; j < FIELD_WIDTH; ++j) setBlock(game->field, i, j, 1);
 
   countScore(game);
   int score = game->gameInfo->score;
@@ -295,7 +295,7 @@ START_TEST(countScore_4) {
   calculate(game);
 
   for (int i = FIELD_HEIGHT - 1; i > FIELD_HEIGHT - 5; --i)
-    for (int j = 0; j < FIELD_WIDTH; ++j) game->field->blocks[i][j].block = 1;
+    for (int j = 0; j < FIELD_WIDTH; ++j) setBlock(game->field, i, j, 1);
 
   countScore(game);
   int score = game->gameInfo->score;
@@ -306,6 +306,1048 @@ START_TEST(countScore_4) {
 }
 END_TEST
 
+START_TEST(level_ticks) {
+  Game *game = initGame();
+  ck_assert_int_eq(game->gameInfo->ticks, levelTicks(1));
+  ck_assert_int_eq(levelTicks(1) * TICK_MS, 900);
+  ck_assert_int_eq(levelTicks(LEVELS_COUNT) * TICK_MS, 100);
+  ck_assert_int_eq(levelTicks(LEVELS_COUNT + 5), levelTicks(LEVELS_COUNT));
+
+  game->gameInfo->score = 550;
+  for (int j = 0; j < FIELD_WIDTH; ++j)
+    setBlock(game->field, FIELD_HEIGHT - 1, j, 1);
+  countScore(game);
+
+  ck_assert_int_eq(game->gameInfo->level, 2);
+  ck_assert_int_eq(game->gameInfo->ticks, levelTicks(2));
+  ck_assert_int_lt(levelTicks(2), levelTicks(1));
+
+  freeGame(game);
+}
+END_TEST
+
+START_TEST(field_blocks) {
+  Field *field = createField();
+
+  setBlock(field, 5, 0, 1);
+  setBlock(field, 5, FIELD_WIDTH - 1, 1);
+  setBlock(field, FIELD_HEIGHT, 0, 1);
+
+  ck_assert_int_eq(getBlock(field, 5, 0), 1);
+  ck_assert_int_eq(getBlock(field, 5, 1), 0);
+  ck_assert_int_eq(getBlock(field, 5, FIELD_WIDTH - 1), 1);
+  ck_assert_int_eq(getBlock(field, FIELD_HEIGHT, 0), 0);
+  ck_assert_int_eq(field->rows[5], 1 | 1 << (FIELD_WIDTH - 1));
+
+  setBlock(field, 5, 0, 0);
+  ck_assert_int_eq(getBlock(field, 5, 0), 0);
+
+  freeField(field);
+}
+END_TEST
+
+START_TEST(field_erase) {
+  Field *field = createField();
+
+  for (int j = 0; j < FIELD_WIDTH; ++j) {
+    setBlock(field, FIELD_HEIGHT - 1, j, 1);
+    setBlock(field, FIELD_HEIGHT - 3, j, 1);
+  }
+  setBlock(field, FIELD_HEIGHT - 2, 4, 1);
+  setBlock(field, 0, 7, 1);
+
+  ck_assert_int_eq(lineFilled(FIELD_HEIGHT - 1, field), 1);
+  ck_assert_int_eq(lineFilled(FIELD_HEIGHT - 2, field), 0);
+  ck_assert_int_eq(eraseLines(field), 2);
+  ck_assert_int_eq(getBlock(field, FIELD_HEIGHT - 1, 4), 1);
+  ck_assert_int_eq(getBlock(field, 2, 7), 1);
+  ck_assert_int_eq(field->rows[0], 0);
+  ck_assert_int_eq(field->rows[1], 0);
+
+  freeField(field);
+}
+END_TEST
+
+START_TEST(field_erase_random) {
+  Field *field = createField();
+  Field *expected = createField();
+  Random random;
+  seedRandom(&random, 42);
+
+  for (int round = 0; round < 200; ++round) {
+    clearField(field);
+    for (int i = 0; i < FIELD_HEIGHT; ++i) {
+      bool full = randomRange(&random, 3) == 0;
+      for (int j = 0; j < FIELD_WIDTH; ++j)
+        setBlock(field, i, j, full || randomRange(&random, 2));
+    }
+    *expected = *field;
+
+    int lines = 0;
+    for (int i = FIELD_HEIGHT - 1; i >= 0; i--)
+      while (lineFilled(i, expected)) {
+        dropLine(i, expected);
+        lines++;
+      }
+
+    ck_assert_int_eq(eraseLines(field), lines);
+    for (int i = 0; i < FIELD_HEIGHT; ++i)
+      ck_assert_int_eq(field->rows[i], expected->rows[i]);
+    for (int j = 0; j < FIELD_WIDTH; ++j)
+      ck_assert_int_eq(field->heights[j], expected->heights[j]);
+    ck_assert_uint_eq(field->hash, expected->hash);
+    ck_assert_int_eq(field->dirty, 0);
+  }
+
+  freeField(expected);
+  freeField(field);
+}
+END_TEST
+
+START_TEST(field_erase_dirty) {
+  Game *game = initGame();
+  Field *field = game->field;
+
+  for (int j = 0; j < FIELD_WIDTH; ++j) setBlock(field, FIELD_HEIGHT - 1, j, 1);
+  field->dirty = 0;
+  ck_assert_int_eq(eraseLines(field), 0);
+
+  game->figure->y = FIELD_HEIGHT - FIGURE_HEIGHT;
+  game->figure->x = 0;
+  plantFigure(game);
+  ck_assert_int_ne(field->dirty, 0);
+  ck_assert_int_eq(field->dirty & ((1u << (FIELD_HEIGHT - FIGURE_HEIGHT)) - 1),
+                   0);
+
+  for (int j = 0; j < FIELD_WIDTH; ++j) setBlock(field, FIELD_HEIGHT - 1, j, 1);
+  ck_assert_int_eq(eraseLines(field), 1);
+  ck_assert_int_eq(field->dirty, 0);
+
+  freeGame(game);
+}
+END_TEST
+
+START_TEST(field_features) {
+  Field *field = createField();
+  FieldFeatures features = fieldFeatures(field);
+  ck_assert_int_eq(features.height, 0);
+  ck_assert_int_eq(features.rowTransitions, 2 * FIELD_HEIGHT);
+  ck_assert_int_eq(features.columnTransitions, FIELD_WIDTH);
+
+  for (int i = FIELD_HEIGHT - 3; i < FIELD_HEIGHT; ++i)
+    for (int j = 1; j < FIELD_WIDTH; ++j) setBlock(field, i, j, 1);
+  // колодец глубины 3 у левой стены
+  features = fieldFeatures(field);
+  ck_assert_int_eq(features.height, 3 * (FIELD_WIDTH - 1));
+  ck_assert_int_eq(features.maxHeight, 3);
+  ck_assert_int_eq(features.holes, 0);
+  ck_assert_int_eq(features.rowTransitions, 2 * FIELD_HEIGHT);
+  ck_assert_int_eq(features.columnTransitions, FIELD_WIDTH);
+  ck_assert_int_eq(features.wells, 1 + 2 + 3);
+  ck_assert_int_eq(features.bumpiness, 3);
+
+  setBlock(field, FIELD_HEIGHT - 4, 0, 1);
+  features = fieldFeatures(field);
+  ck_assert_int_eq(features.holes, 3);
+  ck_assert_int_eq(features.wells, 0);
+
+  freeField(field);
+}
+END_TEST
+
+START_TEST(field_features_random) {
+  Field *field = createField();
+  Random random;
+  seedRandom(&random, 16);
+
+  for (int round = 0; round < 2000; ++round) {
+    clearField(field);
+    if (round % 2) {
+      int density = randomRange(&random, 101);
+      for (int i = randomRange(&random, FIELD_HEIGHT + 1); i < FIELD_HEIGHT;
+           ++i)
+        for (int j = 0; j < FIELD_WIDTH; ++j)
+          setBlock(field, i, j, randomRange(&random, 100) < density);
+    } else {
+      for (int j = 0; j < FIELD_WIDTH; ++j) {
+        int height = randomRange(&random, FIELD_HEIGHT + 1);
+        for (int i = FIELD_HEIGHT - height; i < FIELD_HEIGHT; ++i)
+          setBlock(field, i, j, randomRange(&random, 8) != 0);
+      }
+    }
+
+    FieldFeatures fast = fieldFeatures(field);
+    FieldFeatures slow = fieldFeaturesScalar(field);
+    ck_assert_int_eq(fast.height, slow.height);
+    ck_assert_int_eq(fast.maxHeight, slow.maxHeight);
+    ck_assert_int_eq(fast.holes, slow.holes);
+    ck_assert_int_eq(fast.rowTransitions, slow.rowTransitions);
+    ck_assert_int_eq(fast.columnTransitions, slow.columnTransitions);
+    ck_assert_int_eq(fast.wells, slow.wells);
+    ck_assert_int_eq(fast.bumpiness, slow.bumpiness);
+  }
+
+  freeField(field);
+}
+END_TEST
+
+START_TEST(collision_walls) {
+  Game *game = initGame();
+
+  ck_assert_int_eq(figureCollides(game->field, game->figure), 0);
+  game->figure->x = -FIGURE_WIDTH;
+  ck_assert_int_eq(figureCollides(game->field, game->figure), 1);
+  game->figure->x = FIELD_WIDTH;
+  ck_assert_int_eq(figureCollides(game->field, game->figure), 1);
+
+  game->figure->x = 3;
+  for (int j = 0; j < FIELD_WIDTH; ++j) setBlock(game->field, 10, j, 1);
+  game->figure->y = 10 - FIGURE_HEIGHT + 1;
+  ck_assert_int_eq(figureCollides(game->field, game->figure), 0);
+  game->figure->y = 10 - FIGURE_HEIGHT / 2;
+  ck_assert_int_eq(figureCollides(game->field, game->figure), 1);
+
+  freeGame(game);
+}
+END_TEST
+
+START_TEST(rotation_table) {
+  Game *game = initGame();
+  Figure figure = {0, 0, 0, 0};
+
+  for (int id = 0; id < FIGURES_COUNT; ++id) {
+    int blocks[FIGURE_HEIGHT][FIGURE_WIDTH];
+    for (int i = 0; i < FIGURE_HEIGHT; ++i)
+      for (int j = 0; j < FIGURE_WIDTH; ++j)
+        blocks[i][j] = game->figurest->blocks[id][i * FIGURE_WIDTH + j].block;
+
+    figure.id = id;
+    figure.rotation = 0;
+    for (int r = 0; r < ROTATIONS_COUNT; ++r) {
+      for (int i = 0; i < FIGURE_HEIGHT; ++i)
+        for (int j = 0; j < FIGURE_WIDTH; ++j)
+          ck_assert_int_eq(getFigureBlock(&figure, i, j), blocks[i][j]);
+      for (int j = 0; j < FIGURE_WIDTH; ++j) {
+        int bottom = -1;
+        for (int i = 0; i < FIGURE_HEIGHT; ++i)
+          if (blocks[i][j]) bottom = i;
+        ck_assert_int_eq(getFigureShape(&figure)->bottoms[j], bottom);
+      }
+
+      int rotated[FIGURE_HEIGHT][FIGURE_WIDTH];
+      for (int i = 0; i < FIGURE_HEIGHT; ++i)
+        for (int j = 0; j < FIGURE_WIDTH; ++j)
+          rotated[i][j] = blocks[j][FIGURE_WIDTH - 1 - i];
+      for (int i = 0; i < FIGURE_HEIGHT; ++i)
+        for (int j = 0; j < FIGURE_WIDTH; ++j) blocks[i][j] = rotated[i][j];
+      rotationFigure(&figure);
+    }
+    ck_assert_int_eq(figure.rotation, 0);
+  }
+
+  freeGame(game);
+}
+END_TEST
+
+START_TEST(rotation_blocked) {
+  Game *game = initGame();
+
+  game->player->action = check_symbol('\n');
+  calculate(game);
+  game->figure->id = 0;
+  game->figure->rotation = 0;
+  game->figure->x = -2;
+  game->player->action = check_symbol(' ');
+  calculate(game);
+
+  ck_assert_int_eq(game->figure->rotation, 0);
+  ck_assert_int_eq(game->gameInfo->state, Collision);
+
+  freeGame(game);
+}
+END_TEST
+
+START_TEST(reset_game) {
+  Game *game = initGame();
+  Field *field = game->field;
+  Figure *figure = game->figure;
+
+  game->player->action = check_symbol('\n');
+  calculate(game);
+  for (int j = 0; j < FIELD_WIDTH; ++j)
+    setBlock(game->field, FIELD_HEIGHT - 1, j, 1);
+  countScore(game);
+  setBlock(game->field, FIELD_HEIGHT - 1, 0, 1);
+  game->gameInfo->state = GameOver;
+  resetGame(game);
+
+  ck_assert_ptr_eq(game->field, field);
+  ck_assert_ptr_eq(game->figure, figure);
+  ck_assert_int_eq(game->gameInfo->score, 0);
+  ck_assert_int_ge(game->gameInfo->high_score, 100);
+  ck_assert_int_eq(game->gameInfo->state, Start);
+  ck_assert_int_eq(getBlock(game->field, FIELD_HEIGHT - 1, 0), 0);
+  ck_assert_int_eq(game->figure->y, 0);
+
+  freeGame(game);
+}
+END_TEST
+
+START_TEST(seeded_games) {
+  GameConfig config = {NULL, 42, false};
+  Game *first = initGameWith(&config);
+  Game *second = initGameWith(&config);
+
+  ck_assert_int_eq(first->gameInfo->high_score, 0);
+  for (int i = 0; i < 100; ++i) {
+    ck_assert_int_eq(first->figure->id, second->figure->id);
+    ck_assert_int_eq(first->gameInfo->nextID, second->gameInfo->nextID);
+    dropNewFigure(first);
+    dropNewFigure(second);
+  }
+  ck_assert_int_eq(first->gameInfo->pieces, 101);
+
+  freeGame(first);
+  freeGame(second);
+}
+END_TEST
+
+START_TEST(step_restart) {
+  GameConfig config = {NULL, 7, false};
+  Game *game = initGameWith(&config);
+
+  stepGame(game, START);
+  ck_assert_int_eq(game->gameInfo->state, Moving);
+  while (game->gameInfo->state != GameOver) stepGame(game, DOWN);
+  stepGame(game, LEFT);
+  ck_assert_int_eq(game->gameInfo->state, GameOver);
+  stepGame(game, START);
+  ck_assert_int_eq(game->gameInfo->state, Start);
+  ck_assert_int_eq(game->gameInfo->pieces, 1);
+
+  freeGame(game);
+}
+END_TEST
+
+START_TEST(bag_generator) {
+  GameConfig config = {NULL, 3, true};
+  Game *game = initGameWith(&config);
+
+  while (game->gameInfo->bagLeft) randomFigure(game->gameInfo);
+  for (int bag = 0; bag < 10; ++bag) {
+    int seen[FIGURES_COUNT] = {0};
+    for (int i = 0; i < FIGURES_COUNT; ++i)
+      seen[randomFigure(game->gameInfo)]++;
+    for (int id = 0; id < FIGURES_COUNT; ++id) ck_assert_int_eq(seen[id], 1);
+  }
+  ck_assert_int_eq(game->gameInfo->seed, 3);
+
+  freeGame(game);
+}
+END_TEST
+
+START_TEST(field_heights) {
+  Field *field = createField();
+
+  setBlock(field, FIELD_HEIGHT - 1, 0, 1);
+  setBlock(field, 5, 0, 1);
+  ck_assert_int_eq(field->heights[0], FIELD_HEIGHT - 5);
+  setBlock(field, 5, 0, 0);
+  ck_assert_int_eq(field->heights[0], 1);
+
+  for (int j = 0; j < FIELD_WIDTH; ++j) setBlock(field, FIELD_HEIGHT - 1, j, 1);
+  setBlock(field, FIELD_HEIGHT - 3, 4, 1);
+  eraseLines(field);
+  ck_assert_int_eq(field->heights[0], 0);
+  ck_assert_int_eq(field->heights[4], 2);
+
+  freeField(field);
+}
+END_TEST
+
+START_TEST(field_zobrist) {
+  Field *field = createField();
+  ck_assert_uint_eq(field->hash, 0);
+
+  setBlock(field, 7, 3, 1);
+  uint64_t single = field->hash;
+  ck_assert_uint_eq(single, zobristKey(7, 3));
+  setBlock(field, 7, 3, 1);
+  ck_assert_uint_eq(field->hash, single);
+  setBlock(field, 12, 9, 1);
+  setBlock(field, 12, 9, 0);
+  ck_assert_uint_eq(field->hash, single);
+
+  for (int j = 0; j < FIELD_WIDTH; ++j) setBlock(field, FIELD_HEIGHT - 1, j, 1);
+  ck_assert_uint_eq(eraseLines(field), 1);
+  ck_assert_uint_eq(field->hash, zobristKey(8, 3));
+  ck_assert_uint_eq(field->hash, hashField(field));
+
+  freeField(field);
+}
+END_TEST
+
+START_TEST(trans_table) {
+  TransTable *table = createTable(4);
+  Figure move = {3, 17, 5, 2};
+  Figure found = {0, 0, 0, 0};
+  double value = 0;
+
+  ck_assert_int_eq(probeTable(table, 0, &value, &found), 0);
+  ck_assert_int_eq(probeTable(table, 42, &value, &found), 0);
+  storeTable(table, 42, -1.5, &move);
+  ck_assert_int_eq(probeTable(table, 42, &value, &found), 1);
+  ck_assert_double_eq(value, -1.5);
+  ck_assert_int_eq(found.x, 3);
+  ck_assert_int_eq(found.y, 17);
+  ck_assert_int_eq(found.id, 5);
+  ck_assert_int_eq(found.rotation, 2);
+  ck_assert_int_eq(probeTable(table, 42 + 16, &value, NULL), 0);
+
+  storeTable(table, 42 + 16, 7, NULL);
+  ck_assert_int_eq(probeTable(table, 42, &value, NULL), 0);
+
+  clearTable(table);
+  ck_assert_int_eq(probeTable(table, 42 + 16, &value, NULL), 0);
+  freeTable(table);
+}
+END_TEST
+
+START_TEST(hard_drop) {
+  GameConfig config = {NULL, 21, false};
+  Game *game = initGameWith(&config);
+  Random actions;
+  seedRandom(&actions, 9);
+  int drops = 0;
+
+  for (int tick = 0; tick < 20000; ++tick) {
+    if (game->gameInfo->state != GameOver &&
+        !figureCollides(game->field, game->figure)) {
+      Figure probe = *game->figure;
+      while (!figureCollides(game->field, &probe)) probe.y++;
+      ck_assert_int_eq(landingRow(game->field, game->figure), probe.y - 1);
+    }
+
+    int roll = randomRange(&actions, 16);
+    UserAction action = roll == 0   ? HARD_DROP
+                        : roll < 4  ? (UserAction)(LEFT + roll - 1)
+                        : roll == 4 ? ROTATE
+                                    : ACTION;
+    if (game->gameInfo->state == GameOver || game->gameInfo->pause)
+      action = START;
+    stepGame(game, action);
+    if (action == HARD_DROP) drops++;
+
+    Field expected = *game->field;
+    updateHeights(&expected);
+    for (int j = 0; j < FIELD_WIDTH; ++j)
+      ck_assert_int_eq(game->field->heights[j], expected.heights[j]);
+    ck_assert_uint_eq(game->field->hash, hashField(game->field));
+  }
+  ck_assert_int_gt(drops, 100);
+
+  resetGame(game);
+  stepGame(game, START);
+  int pieces = game->gameInfo->pieces;
+  stepGame(game, HARD_DROP);
+  ck_assert_int_eq(game->gameInfo->pieces, pieces + 1);
+  ck_assert_uint_ne(game->field->hash, 0);
+
+  freeGame(game);
+}
+END_TEST
+
+START_TEST(snapshot_rollback) {
+  GameConfig config = {NULL, 17, true};
+  Game *game = initGameWith(&config);
+  stepGame(game, START);
+  for (int tick = 0; tick < 3000; ++tick)
+    stepGame(game, tick % 7 ? ACTION : LEFT + tick % 4);
+
+  GameSnapshot snapshot;
+  snapshotGame(game, &snapshot);
+  Game *clone = cloneGame(game);
+
+  for (int round = 0; round < 2; ++round) {
+    restoreGame(game, &snapshot);
+    for (int tick = 0; tick < 5000; ++tick) {
+      UserAction action = tick % 5 ? ACTION : LEFT + tick % 4;
+      stepGame(game, action);
+      if (round == 0) stepGame(clone, action);
+    }
+    ck_assert_uint_eq(hashField(game->field), hashField(clone->field));
+    ck_assert_int_eq(game->gameInfo->pieces, clone->gameInfo->pieces);
+    ck_assert_int_eq(game->gameInfo->score, clone->gameInfo->score);
+    ck_assert_uint_eq(game->gameInfo->random.state,
+                      clone->gameInfo->random.state);
+  }
+
+  ck_assert_ptr_ne(clone->field, game->field);
+  ck_assert_ptr_eq(clone->figurest->blocks[0], game->figurest->blocks[0]);
+
+  freeGame(clone);
+  freeGame(game);
+}
+END_TEST
+
+START_TEST(ai_evaluate) {
+  Field *field = createField();
+  AiWeights weights = {1, 10, 100, 1000};
+
+  setBlock(field, FIELD_HEIGHT - 1, 0, 1);
+  setBlock(field, FIELD_HEIGHT - 3, 0, 1);
+  setBlock(field, FIELD_HEIGHT - 2, 1, 1);
+  // высоты 3, 2, 0...; дыры под блоками обоих столбцов; перепады 1 + 2
+  ck_assert_double_eq(evaluateField(field, 2, &weights),
+                      5 + 10 * 2 + 100 * 2 + 1000 * 3);
+
+  freeField(field);
+}
+END_TEST
+
+START_TEST(ai_placements) {
+  Field *field = createField();
+  Figure figure;
+  spawnFigure(&figure, 0);
+  Placement placements[AI_MAX_PLACEMENTS];
+
+  int count = findPlacements(field, &figure, placements);
+  ck_assert_int_eq(count, 2 * FIELD_WIDTH + 2 * (FIELD_WIDTH - 3));
+  for (int i = 0; i < count; ++i) {
+    Figure *placed = &placements[i].figure;
+    ck_assert_int_eq(figureCollides(field, placed), 0);
+    placed->y++;
+    ck_assert_int_eq(figureCollides(field, placed), 1);
+    placed->y--;
+
+    UserAction actions[AI_MAX_PLAN];
+    int length = planActions(&figure, &placements[i], actions);
+    ck_assert_int_le(length, AI_MAX_PLAN);
+    ck_assert_int_eq(actions[length - 1], HARD_DROP);
+  }
+
+  freeField(field);
+}
+END_TEST
+
+START_TEST(ai_plays) {
+  GameConfig config = {NULL, 8, false};
+  Game *game = initGameWith(&config);
+  Autoplayer ai;
+  initAutoplayer(&ai, true);
+
+  stepGame(game, START);
+  for (int tick = 0; tick < 3000 && game->gameInfo->state != GameOver;
+       ++tick)
+    stepGame(game, aiAction(&ai, game));
+
+  ck_assert_int_ne(game->gameInfo->state, GameOver);
+  ck_assert_int_gt(game->gameInfo->score, 1000);
+  ck_assert_int_gt(ai.counters.evaluations, 0);
+
+  freeGame(game);
+}
+END_TEST
+
+START_TEST(ai_parallel) {
+  GameConfig config = {NULL, 12, true};
+  Game *game = initGameWith(&config);
+  Autoplayer serial;
+  Autoplayer parallel;
+  initAutoplayer(&serial, true);
+  initAutoplayer(&parallel, true);
+  SearchPool *pool = createSearchPool(4);
+
+  stepGame(game, START);
+  for (int tick = 0; tick < 1000 && game->gameInfo->state != GameOver;
+       ++tick) {
+    Placement expected = bestPlacement(&serial, game);
+    Placement actual = parallelPlacement(pool, &parallel, game);
+    ck_assert_int_eq(actual.figure.x, expected.figure.x);
+    ck_assert_int_eq(actual.figure.y, expected.figure.y);
+    ck_assert_int_eq(actual.figure.rotation, expected.figure.rotation);
+    ck_assert_double_eq(actual.score, expected.score);
+    stepGame(game, aiAction(&serial, game));
+  }
+
+  SearchStats stats = searchStats(pool);
+  ck_assert_int_eq(stats.nodes, parallel.counters.evaluations);
+  ck_assert_int_eq(stats.searches, 1000);
+  ck_assert_int_gt(stats.tasks, stats.searches);
+
+  freeSearchPool(pool);
+  freeGame(game);
+}
+END_TEST
+
+START_TEST(ai_table) {
+  GameConfig config = {NULL, 14, false};
+  Game *game = initGameWith(&config);
+  Autoplayer plain;
+  Autoplayer cached;
+  initAutoplayer(&plain, true);
+  initAutoplayer(&cached, true);
+  cached.table = createTable(12);
+
+  stepGame(game, START);
+  for (int tick = 0; tick < 1000 && game->gameInfo->state != GameOver;
+       ++tick) {
+    Placement expected = bestPlacement(&plain, game);
+    Placement actual = bestPlacement(&cached, game);
+    ck_assert_int_eq(actual.figure.x, expected.figure.x);
+    ck_assert_int_eq(actual.figure.rotation, expected.figure.rotation);
+    ck_assert_double_eq(actual.score, expected.score);
+    stepGame(game, aiAction(&plain, game));
+  }
+  ck_assert_int_gt(cached.counters.hits, 0);
+  ck_assert_int_gt(cached.counters.probes, cached.counters.hits);
+  ck_assert_int_eq(plain.counters.probes, 0);
+  ck_assert_int_lt(cached.counters.evaluations, plain.counters.evaluations);
+
+  freeTable(cached.table);
+  freeGame(game);
+}
+END_TEST
+
+START_TEST(batch_differential) {
+  enum { BOARDS = 48 };
+  GameConfig config = {NULL, 100, false};
+  GameBatch *batch = createBatch(BOARDS, &config);
+  Game *games[BOARDS];
+  for (int b = 0; b < BOARDS; ++b) {
+    GameConfig own = {NULL, config.seed + b, b % 3 == 0};
+    games[b] = initGameWith(&own);
+    if (own.useBag) {
+      GameSnapshot snapshot;
+      snapshotGame(games[b], &snapshot);
+      restoreBatchGame(batch, b, &snapshot);
+    }
+  }
+  Random random;
+  seedRandom(&random, 17);
+
+  for (int tick = 0; tick < 10000; ++tick) {
+    UserAction actions[BOARDS];
+    for (int b = 0; b < BOARDS; ++b) {
+      int roll = randomRange(&random, 1000);
+      actions[b] = roll < 400   ? ACTION
+                   : roll < 900 ? (UserAction)(LEFT + roll % 4)
+                   : roll < 960 ? HARD_DROP
+                   : roll < 980 ? START
+                   : roll < 999 ? PAUSE
+                                : TERMINATE;
+      if (games[b]->gameInfo->state == Quit && roll % 50 == 0) {
+        resetGame(games[b]);
+        GameSnapshot snapshot;
+        snapshotGame(games[b], &snapshot);
+        restoreBatchGame(batch, b, &snapshot);
+      }
+      stepGame(games[b], actions[b]);
+    }
+    stepBatch(batch, actions);
+
+    for (int b = 0; b < BOARDS; ++b) {
+      GameSnapshot actual;
+      GameSnapshot expected;
+      snapshotBatchGame(batch, b, &actual);
+      snapshotGame(games[b], &expected);
+      for (int i = 0; i < FIELD_HEIGHT; ++i)
+        ck_assert_int_eq(actual.field.rows[i], expected.field.rows[i]);
+      ck_assert_uint_eq(actual.field.hash, expected.field.hash);
+      ck_assert_int_eq(actual.figure.x, expected.figure.x);
+      ck_assert_int_eq(actual.figure.y, expected.figure.y);
+      ck_assert_int_eq(actual.figure.id, expected.figure.id);
+      ck_assert_int_eq(actual.figure.rotation, expected.figure.rotation);
+      ck_assert_int_eq(actual.gameInfo.state, expected.gameInfo.state);
+      ck_assert_int_eq(actual.gameInfo.pause, expected.gameInfo.pause);
+      ck_assert_int_eq(actual.gameInfo.score, expected.gameInfo.score);
+      ck_assert_int_eq(actual.gameInfo.level, expected.gameInfo.level);
+      ck_assert_int_eq(actual.gameInfo.speed, expected.gameInfo.speed);
+      ck_assert_int_eq(actual.gameInfo.ticks, expected.gameInfo.ticks);
+      ck_assert_int_eq(actual.gameInfo.ticks_left,
+                       expected.gameInfo.ticks_left);
+      ck_assert_int_eq(actual.gameInfo.pieces, expected.gameInfo.pieces);
+      ck_assert_int_eq(actual.gameInfo.nextID, expected.gameInfo.nextID);
+      ck_assert_uint_eq(actual.gameInfo.random.state,
+                        expected.gameInfo.random.state);
+      ck_assert_int_eq(actual.gameInfo.bagLeft, expected.gameInfo.bagLeft);
+    }
+  }
+
+  for (int b = 0; b < BOARDS; ++b) freeGame(games[b]);
+  freeBatch(batch);
+}
+END_TEST
+
+START_TEST(batch_kernels) {
+  enum { BOARDS = 61 };
+  GameBatch *batch = createBatch(BOARDS, NULL);
+  Field fields[BOARDS];
+  uint32_t full[BOARDS];
+  Random random;
+  seedRandom(&random, 23);
+
+  for (int isa = IsaScalar; isa <= (int)supportedBatchIsa(); ++isa) {
+    ck_assert_int_eq(setBatchIsa((BatchIsa)isa), isa);
+    for (int round = 0; round < 200; ++round) {
+      for (int b = 0; b < BOARDS; ++b) {
+        clearField(&fields[b]);
+        for (int i = 0; i < FIELD_HEIGHT; ++i) {
+          int roll = randomRange(&random, 100);
+          uint16_t row = roll < 10   ? FIELD_FULL_ROW
+                         : roll < 40 ? 0
+                                     : (uint16_t)(randomRange(&random, 1024) &
+                                                  FIELD_FULL_ROW);
+          fields[b].rows[i] = row;
+          batch->rows[b][BATCH_TOP + i] = row;
+        }
+        batch->cx[b] = randomRange(&random, 25) - 12;
+        batch->cy[b] = randomRange(&random, 29) - 4;
+        batch->id[b] = randomRange(&random, FIGURES_COUNT);
+        batch->crotation[b] = randomRange(&random, ROTATIONS_COUNT);
+      }
+      collideBatch(batch);
+      fullRowsBatch(batch, full);
+      for (int b = 0; b < BOARDS; ++b) {
+        Figure figure = {batch->cx[b], batch->cy[b], batch->id[b],
+                         batch->crotation[b]};
+        ck_assert_int_eq(batch->hit[b], figureCollides(&fields[b], &figure));
+        for (int i = 0; i < FIELD_HEIGHT; ++i)
+          ck_assert_int_eq((full[b] >> i) & 1, lineFilled(i, &fields[b]));
+      }
+    }
+  }
+
+  setBatchIsa(supportedBatchIsa());
+  freeBatch(batch);
+}
+END_TEST
+
+START_TEST(brickgame_api) {
+  BrickGameConfig config = {29, 1, 500};
+  GameConfig same = {NULL, 29, true};
+  BrickGame *game = brickGameCreate(&config);
+  Game *expected = initGameWith(&same);
+  expected->gameInfo->high_score = 500;
+  BrickObservation observation;
+  Random random;
+  seedRandom(&random, 31);
+
+  ck_assert_int_eq(brickGameVersion(), BRICKGAME_API_VERSION);
+  brickGameObserve(game, &observation);
+  ck_assert_int_eq(observation.state, BRICK_STATE_START);
+  ck_assert_int_eq(observation.highScore, 500);
+
+  BrickGame *clone = NULL;
+  for (int tick = 0; tick < 5000; ++tick) {
+    BrickAction action = tick == 0 ? BRICK_START
+                                   : (BrickAction)(BRICK_LEFT +
+                                                   randomRange(&random, 5));
+    if (tick == 200) clone = brickGameClone(game);
+    stepGame(expected, (UserAction)action);
+    ck_assert_int_eq(brickGameStep(game, action), expected->gameInfo->state);
+  }
+
+  brickGameObserve(game, &observation);
+  for (int i = 0; i < FIELD_HEIGHT; ++i)
+    ck_assert_int_eq(observation.rows[i], expected->field->rows[i]);
+  const FigureShape *shape = getFigureShape(expected->figure);
+  for (int i = 0; i < FIGURE_HEIGHT; ++i)
+    ck_assert_int_eq(observation.figureRows[i], shape->rows[i]);
+  ck_assert_int_eq(observation.figureX, expected->figure->x);
+  ck_assert_int_eq(observation.figureY, expected->figure->y);
+  ck_assert_int_eq(observation.figureId, expected->figure->id);
+  ck_assert_int_eq(observation.nextId, expected->gameInfo->nextID);
+  ck_assert_int_eq(observation.score, expected->gameInfo->score);
+  ck_assert_int_eq(observation.pieces, expected->gameInfo->pieces);
+  ck_assert_int_gt(observation.pieces, 1);
+
+  BrickObservation copy;
+  brickGameObserve(clone, &copy);
+  ck_assert_int_lt(copy.pieces, observation.pieces);
+  brickGameReset(game);
+  brickGameObserve(game, &observation);
+  ck_assert_int_eq(observation.state, BRICK_STATE_START);
+  ck_assert_int_eq(observation.score, 0);
+
+  brickGameDestroy(clone);
+  brickGameDestroy(game);
+  brickGameDestroy(NULL);
+  freeGame(expected);
+}
+END_TEST
+
+START_TEST(input_queue) {
+  InputQueue queue;
+  initInput(&queue, NULL);
+  ck_assert_int_eq(popInput(&queue), ACTION);
+
+  pushKey(&queue, ROTATE, 0);
+  pushKey(&queue, LEFT, 1000);
+  pushKey(&queue, HARD_DROP, 2000);
+  ck_assert_int_eq(pendingInput(&queue), 3);
+  ck_assert_int_eq(popInput(&queue), ROTATE);
+  ck_assert_int_eq(popInput(&queue), LEFT);
+  ck_assert_int_eq(popInput(&queue), HARD_DROP);
+  ck_assert_int_eq(popInput(&queue), ACTION);
+
+  for (int i = 0; i < INPUT_QUEUE_SIZE + 5; ++i) pushKey(&queue, ROTATE, 0);
+  ck_assert_int_eq(pendingInput(&queue), INPUT_QUEUE_SIZE);
+  ck_assert_int_eq(queue.dropped, 5);
+  while (popInput(&queue) != ACTION) continue;
+  ck_assert_int_eq(pendingInput(&queue), 0);
+}
+END_TEST
+
+START_TEST(input_repeat) {
+  const uint64_t ms = 1000000;
+  InputConfig config = {150, 20, 50};
+  InputQueue queue;
+  initInput(&queue, &config);
+
+  // Нажатие в 0 мс, повторы терминала каждые 30 мс с 420 до 690 мс.
+  pushKey(&queue, RIGHT, 0);
+  int moves = 0;
+  uint64_t first = 0;
+  for (uint64_t t = 0; t <= 800 * ms; t += 10 * ms) {
+    if (t >= 400 * ms && t <= 700 * ms && t % (30 * ms) == 0)
+      pushKey(&queue, RIGHT, t);
+    updateInput(&queue, t);
+    for (UserAction action = popInput(&queue); action != ACTION;
+         action = popInput(&queue)) {
+      ck_assert_int_eq(action, RIGHT);
+      if (moves++ == 2) first = t;
+    }
+  }
+  // Нажатие, первый повтор терминала (420 мс) и собственные повторы каждые
+  // 20 мс с 450 мс, когда замечено удержание, до 730 мс: в 750 мс клавиша
+  // уже отпущена.
+  ck_assert_uint_eq(first, 450 * ms);
+  ck_assert_int_eq(moves, 2 + (730 - 450) / 20 + 1);
+  ck_assert(!queue.held);
+
+  // Частые отдельные нажатия разных сдвигов не считаются удержанием.
+  pushKey(&queue, LEFT, 900 * ms);
+  pushKey(&queue, RIGHT, 910 * ms);
+  pushKey(&queue, LEFT, 920 * ms);
+  updateInput(&queue, 2000 * ms);
+  ck_assert_int_eq(pendingInput(&queue), 3);
+}
+END_TEST
+
+START_TEST(profile_histogram) {
+  // Интервалы идут подряд: нижняя граница следующего на 1 больше
+  // наибольшего значения предыдущего, а ширина не больше 1/16 значения.
+  for (int b = 0; b + 1 < PROFILE_BUCKETS; b++) {
+    uint64_t low = histogramBucketLow(b);
+    uint64_t high = histogramBucketLow(b + 1) - 1;
+    ck_assert_int_eq(histogramBucket(low), b);
+    ck_assert_int_eq(histogramBucket(high), b);
+    ck_assert_uint_le(high - low, low / PROFILE_SUB_BUCKETS);
+  }
+  ck_assert_int_eq(histogramBucket(UINT64_MAX), PROFILE_BUCKETS - 1);
+
+  static Histogram histogram;
+  ck_assert_uint_eq(histogramPercentile(&histogram, 50), 0);
+  for (uint64_t v = 1; v <= 100000; v++) histogramRecord(&histogram, v);
+  ck_assert_uint_eq(histogram.count, 100000);
+  ck_assert_uint_eq(histogram.max, 100000);
+  const double percents[] = {1, 50, 90, 99, 99.9};
+  for (int i = 0; i < 5; i++) {
+    uint64_t exact = (uint64_t)(percents[i] * 1000);
+    uint64_t value = histogramPercentile(&histogram, percents[i]);
+    ck_assert_uint_ge(value, exact);
+    ck_assert_uint_le(value - exact, exact / PROFILE_SUB_BUCKETS);
+  }
+  ck_assert_uint_eq(histogramPercentile(&histogram, 100), 100000);
+}
+END_TEST
+
+START_TEST(replay_roundtrip) {
+  GameConfig config = {NULL, 11, true};
+  Game *game = initGameWith(&config);
+  Replay *replay = createReplay(game->gameInfo);
+  Random actions;
+  seedRandom(&actions, 5);
+
+  for (int tick = 0; tick < 20000; ++tick) {
+    UserAction action = tick % 500 == 0 ? START
+                        : randomRange(&actions, 4) ? ACTION
+                                                   : randomRange(&actions, 8);
+    if (action == PAUSE || action == TERMINATE) action = DOWN;
+    recordAction(replay, action);
+    stepGame(game, action);
+  }
+  finishReplay(replay, game);
+  ck_assert_uint_eq(replay->ticks, 20000);
+  ck_assert_uint_lt(replay->size, 20000 / 2);
+  ck_assert_int_eq(saveReplay(replay, "test_replay.trpl"), 1);
+
+  Replay *loaded = loadReplay("test_replay.trpl");
+  remove("test_replay.trpl");
+  ck_assert_ptr_nonnull(loaded);
+  ck_assert_uint_eq(loaded->seed, 11);
+  ck_assert_int_eq(loaded->useBag, 1);
+
+  Game *copy = initGameWith(&config);
+  ck_assert_uint_eq(playReplay(loaded, copy), 20000);
+  ck_assert_int_eq(checkReplay(loaded, copy), 1);
+  ck_assert_uint_eq(hashField(copy->field), hashField(game->field));
+  ck_assert_int_eq(copy->gameInfo->pieces, game->gameInfo->pieces);
+
+  freeReplay(replay);
+  freeReplay(loaded);
+  freeGame(game);
+  freeGame(copy);
+}
+END_TEST
+
+/**
+ * @brief Записывает файл повтора с заданным заголовком и потоком.
+ */
+static void writeReplayFile(const char *path, uint64_t ticks, uint32_t size,
+                            const uint8_t *data, size_t length) {
+  uint8_t header[40] = {'T', 'R', 'P', 'L', REPLAY_VERSION};
+  for (int i = 0; i < 8; i++) header[16 + i] = (uint8_t)(ticks >> (8 * i));
+  for (int i = 0; i < 4; i++) header[36 + i] = (uint8_t)(size >> (8 * i));
+  FILE *file = fopen(path, "wb");
+  ck_assert_ptr_nonnull(file);
+  fwrite(header, 1, sizeof(header), file);
+  fwrite(data, 1, length, file);
+  fclose(file);
+}
+
+START_TEST(replay_corrupt) {
+  const char *path = "test_corrupt.trpl";
+  GameConfig config = {NULL, 1, true};
+  const uint8_t valid[] = {ACTION | 3 << 4, DOWN};
+  const uint8_t badAction[] = {ACTION, 0x0C};
+  const uint8_t longRun[] = {ACTION | 0xF0, 0xFF, 0xFF, 0xFF, 0x7F};
+
+  writeReplayFile(path, 5, 0xFFFFFFFFu, valid, sizeof(valid));
+  ck_assert_ptr_eq(loadReplay(path), NULL);
+  writeReplayFile(path, 5, sizeof(valid) + 1, valid, sizeof(valid));
+  ck_assert_ptr_eq(loadReplay(path), NULL);
+
+  writeReplayFile(path, 5, sizeof(valid), valid, sizeof(valid));
+  Replay *replay = loadReplay(path);
+  ck_assert_ptr_nonnull(replay);
+  Game *game = initGameWith(&config);
+  ck_assert_uint_eq(playReplay(replay, game), 5);
+  freeGame(game);
+  freeReplay(replay);
+
+  writeReplayFile(path, 5, sizeof(badAction), badAction, sizeof(badAction));
+  replay = loadReplay(path);
+  game = initGameWith(&config);
+  ck_assert_uint_eq(playReplay(replay, game), REPLAY_INVALID);
+  freeGame(game);
+  freeReplay(replay);
+
+  writeReplayFile(path, 100, sizeof(longRun), longRun, sizeof(longRun));
+  replay = loadReplay(path);
+  game = initGameWith(&config);
+  ck_assert_uint_eq(playReplay(replay, game), REPLAY_INVALID);
+  freeGame(game);
+  freeReplay(replay);
+  remove(path);
+}
+END_TEST
+
+/**
+ * @brief Проверяет, что декодированное состояние совпадает с игрой.
+ */
+static void checkStreamState(const StreamDecoder *decoder,
+                             const GameSnapshot *expected) {
+  const GameSnapshot *got = &decoder->snapshot;
+  for (int i = 0; i < FIELD_HEIGHT; i++)
+    ck_assert_uint_eq(got->field.rows[i], expected->field.rows[i]);
+  ck_assert_uint_eq(got->field.hash, expected->field.hash);
+  for (int j = 0; j < FIELD_WIDTH; j++)
+    ck_assert_uint_eq(got->field.heights[j], expected->field.heights[j]);
+  ck_assert_int_eq(got->figure.x, expected->figure.x);
+  ck_assert_int_eq(got->figure.y, expected->figure.y);
+  ck_assert_int_eq(got->figure.id, expected->figure.id);
+  ck_assert_int_eq(got->figure.rotation, expected->figure.rotation);
+  ck_assert_int_eq(got->gameInfo.nextID, expected->gameInfo.nextID);
+  ck_assert_int_eq(got->gameInfo.score, expected->gameInfo.score);
+  ck_assert_int_eq(got->gameInfo.high_score, expected->gameInfo.high_score);
+  ck_assert_int_eq(got->gameInfo.level, expected->gameInfo.level);
+  ck_assert_int_eq(got->gameInfo.speed, expected->gameInfo.speed);
+  ck_assert_int_eq(got->gameInfo.state, expected->gameInfo.state);
+  ck_assert_int_eq(got->gameInfo.pause, expected->gameInfo.pause);
+}
+
+START_TEST(stream_roundtrip) {
+  enum { TICKS = 10000, JOIN = 3333 };
+  static GameSnapshot states[TICKS];
+  static uint8_t data[TICKS * STREAM_MAX_RECORD];
+  static size_t starts[TICKS];
+  GameConfig config = {NULL, 23, false};
+  Game *game = initGameWith(&config);
+  StreamEncoder encoder;
+  initStreamEncoder(&encoder, 1000);
+  Random actions;
+  seedRandom(&actions, 9);
+
+  size_t size = 0;
+  for (int tick = 0; tick < TICKS; ++tick) {
+    UserAction action = tick % 500 == 0 ? START
+                        : randomRange(&actions, 8) ? ACTION
+                                                   : randomRange(&actions, 8);
+    if (action == TERMINATE) action = DOWN;
+    stepGame(game, action);
+    snapshotGame(game, &states[tick]);
+    starts[tick] = size;
+    size += encodeDelta(&encoder, game, data + size);
+  }
+  size += finishDelta(&encoder, data + size);
+  // Полный кадр - 40 байт поля и состояние фигуры и игры на каждый тик.
+  ck_assert_uint_lt(size, TICKS * 2);
+
+  // Данные приходят частями случайной длины.
+  StreamDecoder decoder;
+  initStreamDecoder(&decoder);
+  size_t pos = 0;
+  size_t available = 0;
+  while (pos < size) {
+    int used = decodeDelta(&decoder, data + pos, available - pos);
+    ck_assert_int_ge(used, 0);
+    if (used == 0) {
+      available += 1 + randomRange(&actions, 16);
+      if (available > size) available = size;
+    } else {
+      pos += (size_t)used;
+      ck_assert(decoder.synced);
+      checkStreamState(&decoder, &states[decoder.ticks - 1]);
+    }
+  }
+  ck_assert_uint_eq(decoder.ticks, TICKS);
+
+  // Зритель, подключившийся к середине потока, ждёт ключевого кадра.
+  initStreamDecoder(&decoder);
+  pos = starts[JOIN];
+  while (pos < size && !decoder.synced) {
+    int used = decodeDelta(&decoder, data + pos, size - pos);
+    ck_assert_int_gt(used, 0);
+    pos += (size_t)used;
+  }
+  ck_assert(decoder.synced);
+  while (pos < size) {
+    int used = decodeDelta(&decoder, data + pos, size - pos);
+    ck_assert_int_gt(used, 0);
+    pos += (size_t)used;
+  }
+  checkStreamState(&decoder, &states[TICKS - 1]);
+  Game view = streamGame(&decoder, NULL);
+  ck_assert_ptr_eq(view.field, &decoder.snapshot.field);
+
+  const uint8_t malformed[] = {STREAM_IDLE | STREAM_KEY, 1};
+  ck_assert_int_eq(decodeDelta(&decoder, malformed, sizeof(malformed)), -1);
+  freeGame(game);
+}
+END_TEST
+
 Suite *tetris_suite() {
   Suite *s = suite_create("tetris_suite");
   TCase *tc = tcase_create("tetris_tc");
@@ -328,6 +1370,39 @@ Suite *tetris_suite() {
   tcase_add_test(tc, countScore_2);
   tcase_add_test(tc, countScore_3);
   tcase_add_test(tc, countScore_4);
+  tcase_add_test(tc, level_ticks);
+  tcase_add_test(tc, field_blocks);
+  tcase_add_test(tc, field_erase);
+  tcase_add_test(tc, field_erase_random);
+  tcase_add_test(tc, field_erase_dirty);
+  tcase_add_test(tc, collision_walls);
+  tcase_add_test(tc, rotation_table);
+  tcase_add_test(tc, rotation_blocked);
+  tcase_add_test(tc, reset_game);
+  tcase_add_test(tc, seeded_games);
+  tcase_add_test(tc, step_restart);
+  tcase_add_test(tc, bag_generator);
+  tcase_add_test(tc, replay_roundtrip);
+  tcase_add_test(tc, replay_corrupt);
+  tcase_add_test(tc, field_heights);
+  tcase_add_test(tc, hard_drop);
+  tcase_add_test(tc, snapshot_rollback);
+  tcase_add_test(tc, ai_evaluate);
+  tcase_add_test(tc, ai_placements);
+  tcase_add_test(tc, ai_plays);
+  tcase_add_test(tc, ai_parallel);
+  tcase_add_test(tc, field_zobrist);
+  tcase_add_test(tc, trans_table);
+  tcase_add_test(tc, ai_table);
+  tcase_add_test(tc, field_features);
+  tcase_add_test(tc, field_features_random);
+  tcase_add_test(tc, batch_differential);
+  tcase_add_test(tc, batch_kernels);
+  tcase_add_test(tc, brickgame_api);
+  tcase_add_test(tc, input_queue);
+  tcase_add_test(tc, input_repeat);
+  tcase_add_test(tc, profile_histogram);
+  tcase_add_test(tc, stream_roundtrip);
 
   suite_add_tcase(s, tc);
 
@@ -353,6 +1428,9 @@ UserAction check_symbol(char ch) {
     case ' ':
       action = ROTATE;
       break;
+    case 65:
+      action = HARD_DROP;
+      break;
     case 66:
       action = DOWN;
       break;
@@ -3,6 +3,16 @@
 
 #include <check.h>
 
+#include "../brick_game/tetris/ai.h"
+#include "../brick_game/tetris/batch.h"
+#include "../brick_game/tetris/brickgame.h"
+#include "../brick_game/tetris/eval.h"
+#include "../brick_game/tetris/input.h"
+#include "../brick_game/tetris/profile.h"
+#include "../brick_game/tetris/replay.h"
+#include "../brick_game/tetris/search.h"
+#include "../brick_game/tetris/stream.h"
+#include "../brick_game/tetris/table.h"
 #include "../brick_game/tetris/tetris.h"
 
 Suite *tetris_suite();
@@ -0,0 +1,451 @@
+/**
+ * @file bench.c
+ * @brief Микробенчмарки основных функций логики игры.
+ *
+ * Измеряет время и количество выделений памяти на одну операцию для
+ * calculate(), collision(), eraseLines(), rotationFigure(), rotate(),
+ * dropNewFigure(), countScore() и подсчёта признаков поля (fieldFeatures()
+ * и эталонной fieldFeaturesScalar()) на нескольких типичных состояниях
+ * поля.
+ * Пакетные ядра collideBatch() и fullRowsBatch() измеряются на наборе из
+ * BENCH_BOARDS игр для каждого набора команд, поддерживаемого процессором
+ * (строки `collideBatch.<isa>` и `fullRowsBatch.<isa>`), рядом со
+ * скалярными figureCollides() и lineFilled() из logic.c над теми же полями
+ * (строки `figureCollides` и `lineFilled`); для них время указано на одну
+ * игру.
+ * Тик всех игр набора stepBatch() (строки `stepBatch.<isa>`) сравнивается
+ * с тиками тех же игр по одной функцией stepGame() (строка `stepGame`):
+ * игры начинаются с полей описания и получают одинаковые случайные
+ * действия, как в `sim -B`; время указано на тик одной игры.
+ * Перед каждой операцией состояние игры восстанавливается из снимка
+ * (restoreGame()); время самого восстановления выводится отдельной строкой
+ * `restore`.
+ *
+ * Результаты печатаются в формате TSV (бенчмарк, поле, нс/оп, выделений/оп,
+ * итераций), чтобы их можно было сравнивать между коммитами.
+ *
+ * Запуск: `bench [-t секунд на бенчмарк] [-s seed]`. Сборка с
+ * `-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc` (см. цель `bench`).
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <unistd.h>
+
+#include "../brick_game/tetris/batch.h"
+#include "../brick_game/tetris/eval.h"
+
+#define BENCH_BATCH 1000 /*!< Количество операций между замерами времени */
+#define BENCH_BOARDS 1024 /*!< Игр в наборе для пакетных бенчмарков */
+#define BENCH_SCRIPT 4096 /*!< Длина общей последовательности действий */
+
+static long allocations = 0; /*!< Количество выделений памяти */
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+/**
+ * @brief Обёртка malloc(), считающая выделения памяти.
+ */
+void *__wrap_malloc(size_t size) {
+  allocations++;
+  return __real_malloc(size);
+}
+
+/**
+ * @brief Обёртка calloc(), считающая выделения памяти.
+ */
+void *__wrap_calloc(size_t count, size_t size) {
+  allocations++;
+  return __real_calloc(count, size);
+}
+
+/**
+ * @brief Обёртка realloc(), считающая выделения памяти.
+ */
+void *__wrap_realloc(void *ptr, size_t size) {
+  allocations++;
+  return __real_realloc(ptr, size);
+}
+
+/**
+ * @struct Fixture
+ * @brief Типичное состояние поля для измерений.
+ */
+typedef struct Fixture {
+  const char *name;        ///< Название поля
+  int top;                 ///< Первая заполняемая строка
+  int fullRows;            ///< Количество полностью заполненных нижних строк
+  int density;             ///< Заполненность остальных строк в процентах
+} Fixture;
+
+/**
+ * @struct Benchmark
+ * @brief Измеряемая операция.
+ */
+typedef struct Benchmark {
+  const char *name;         ///< Название операции
+  void (*run)(Game *game);  ///< Операция над игрой
+} Benchmark;
+
+static volatile int sink; /*!< Приёмник результатов, чтобы их не выбросил
+                               компилятор */
+
+static void benchRestore(Game *game) { (void)game; }
+static void benchCalculate(Game *game) { calculate(game); }
+static void benchCollision(Game *game) { sink = collision(game); }
+static void benchEraseLines(Game *game) { sink = eraseLines(game->field); }
+static void benchRotationFigure(Game *game) { rotationFigure(game->figure); }
+static void benchRotate(Game *game) { rotate(game); }
+static void benchDropNewFigure(Game *game) { dropNewFigure(game); }
+static void benchCountScore(Game *game) { countScore(game); }
+static void benchFeatures(Game *game) {
+  sink = fieldFeatures(game->field).wells;
+}
+static void benchFeaturesScalar(Game *game) {
+  sink = fieldFeaturesScalar(game->field).wells;
+}
+
+/**
+ * @struct BatchBench
+ * @brief Набор игр и те же поля и фигуры для скалярных функций logic.c.
+ */
+typedef struct BatchBench {
+  GameBatch *batch;              ///< Набор игр
+  Field fields[BENCH_BOARDS];    ///< Поля игр набора
+  Figure figures[BENCH_BOARDS];  ///< Проверяемые положения фигур
+  uint32_t full[BENCH_BOARDS];   ///< Маски заполненных строк
+  Game *games[BENCH_BOARDS];     ///< Те же игры для stepGame()
+  UserAction script[BENCH_SCRIPT];     ///< Случайные действия игроков
+  UserAction actions[BENCH_BOARDS];    ///< Действия текущего тика
+  long tick;                     ///< Номер тика с начала измерения
+} BatchBench;
+
+/**
+ * @struct BatchBenchmark
+ * @brief Измеряемая операция над набором игр.
+ */
+typedef struct BatchBenchmark {
+  const char *name;               ///< Название операции
+  void (*run)(BatchBench *bench);  ///< Операция над всеми играми набора
+} BatchBenchmark;
+
+static void benchCollideBatch(BatchBench *bench) { collideBatch(bench->batch); }
+static void benchFullRowsBatch(BatchBench *bench) {
+  fullRowsBatch(bench->batch, bench->full);
+}
+static void benchFigureCollides(BatchBench *bench) {
+  for (int b = 0; b < BENCH_BOARDS; b++)
+    bench->batch->hit[b] =
+        figureCollides(&bench->fields[b], &bench->figures[b]);
+}
+
+/**
+ * @brief Возвращает действие игрока на текущем тике.
+ *
+ * Закончившаяся игра начинается заново, остальные берут действия из общей
+ * последовательности со своим сдвигом.
+ *
+ * @param bench Набор игр.
+ * @param b Номер игры.
+ * @param state Состояние игры.
+ * @return Действие.
+ */
+static UserAction benchAction(const BatchBench *bench, int b, int state) {
+  return state == GameOver
+             ? START
+             : bench->script[(bench->tick + 7 * b) & (BENCH_SCRIPT - 1)];
+}
+static void benchStepGame(BatchBench *bench) {
+  for (int b = 0; b < BENCH_BOARDS; b++)
+    stepGame(bench->games[b],
+             benchAction(bench, b, bench->games[b]->gameInfo->state));
+  bench->tick++;
+}
+static void benchStepBatch(BatchBench *bench) {
+  for (int b = 0; b < BENCH_BOARDS; b++)
+    bench->actions[b] = benchAction(bench, b, bench->batch->state[b]);
+  stepBatch(bench->batch, bench->actions);
+  bench->tick++;
+}
+static void benchLineFilled(BatchBench *bench) {
+  for (int b = 0; b < BENCH_BOARDS; b++) {
+    uint32_t mask = 0;
+    for (int i = 0; i < FIELD_HEIGHT; i++)
+      if (lineFilled(i, &bench->fields[b])) mask |= 1u << i;
+    bench->full[b] = mask;
+  }
+}
+
+/**
+ * @brief Заполняет поле игры согласно описанию.
+ *
+ * Неполные строки всегда содержат хотя бы одну пустую клетку.
+ *
+ * @param game Указатель на объект игры.
+ * @param fixture Описание поля.
+ * @param random Генератор случайных клеток.
+ */
+static void fillFixture(Game *game, const Fixture *fixture, Random *random) {
+  clearField(game->field);
+  for (int i = fixture->top; i < FIELD_HEIGHT; i++) {
+    if (i >= FIELD_HEIGHT - fixture->fullRows) {
+      for (int j = 0; j < FIELD_WIDTH; j++) setBlock(game->field, i, j, 1);
+    } else {
+      for (int j = 0; j < FIELD_WIDTH; j++)
+        setBlock(game->field, i, j,
+                 randomRange(random, 100) < fixture->density);
+      setBlock(game->field, i, randomRange(random, FIELD_WIDTH), 0);
+    }
+  }
+}
+
+/**
+ * @brief Возвращает текущее время монотонных часов в наносекундах.
+ */
+static double nowNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Измеряет одну операцию на одном поле и печатает строку результата.
+ * @param game Указатель на объект игры в состоянии fixture.
+ * @param fixture Описание поля.
+ * @param bench Измеряемая операция.
+ * @param seconds Минимальное время измерения.
+ */
+static void runBenchmark(Game *game, const Fixture *fixture,
+                         const Benchmark *bench, double seconds) {
+  GameSnapshot state;
+  snapshotGame(game, &state);
+
+  long iterations = 0;
+  long allocs = allocations;
+  double start = nowNs();
+  double elapsed = 0;
+  while (elapsed < seconds * 1e9) {
+    for (int i = 0; i < BENCH_BATCH; i++) {
+      restoreGame(game, &state);
+      bench->run(game);
+    }
+    iterations += BENCH_BATCH;
+    elapsed = nowNs() - start;
+  }
+  allocs = allocations - allocs;
+  restoreGame(game, &state);
+
+  printf("%s\t%s\t%.2f\t%.3f\t%ld\n", bench->name, fixture->name,
+         elapsed / iterations, (double)allocs / iterations, iterations);
+}
+
+/**
+ * @brief Заполняет поля набора игр и выбирает проверяемые положения фигур.
+ *
+ * Положения выбираются так, чтобы часть фигур сталкивалась с блоками или
+ * стенами, а часть - нет.
+ *
+ * @param bench Набор игр.
+ * @param game Игра, поле которой используется для заполнения.
+ * @param fixture Описание полей.
+ * @param random Генератор случайных клеток и положений.
+ */
+static void fillBatchBench(BatchBench *bench, Game *game,
+                           const Fixture *fixture, Random *random) {
+  GameBatch *batch = bench->batch;
+  for (int b = 0; b < BENCH_BOARDS; b++) {
+    fillFixture(game, fixture, random);
+    bench->fields[b] = *game->field;
+    for (int i = 0; i < FIELD_HEIGHT; i++)
+      batch->rows[b][BATCH_TOP + i] = game->field->rows[i];
+    Figure *figure = &bench->figures[b];
+    figure->x = randomRange(random, FIELD_WIDTH + 1) - 2;
+    figure->y = randomRange(random, FIELD_HEIGHT - 2) - 1;
+    figure->id = randomRange(random, FIGURES_COUNT);
+    figure->rotation = randomRange(random, ROTATIONS_COUNT);
+    batch->cx[b] = figure->x;
+    batch->cy[b] = figure->y;
+    batch->id[b] = figure->id;
+    batch->crotation[b] = figure->rotation;
+  }
+}
+
+/**
+ * @brief Начинает игры набора и те же игры stepGame() с полей описания.
+ *
+ * Фигуры и генераторы игр различаются, а действия берутся из общей
+ * последовательности, поэтому через несколько тиков игры расходятся.
+ *
+ * @param bench Набор игр.
+ * @param game Игра, поле которой используется для заполнения.
+ * @param fixture Описание полей.
+ * @param random Генератор случайных клеток.
+ */
+static void fillStepBench(BatchBench *bench, Game *game,
+                          const Fixture *fixture, Random *random) {
+  for (int b = 0; b < BENCH_BOARDS; b++) {
+    GameSnapshot snapshot;
+    seedRandom(&game->gameInfo->random, nextRandom(random));
+    resetGame(game);
+    stepGame(game, START);
+    fillFixture(game, fixture, random);
+    snapshotGame(game, &snapshot);
+    restoreGame(bench->games[b], &snapshot);
+    restoreBatchGame(bench->batch, b, &snapshot);
+  }
+  bench->tick = 0;
+}
+
+/**
+ * @brief Измеряет операцию над набором игр и печатает строку результата.
+ *
+ * Время и выделения памяти указываются на одну игру набора.
+ *
+ * @param bench Набор игр в состоянии fixture.
+ * @param name Название строки результата.
+ * @param fixture Описание полей.
+ * @param run Операция над набором.
+ * @param seconds Минимальное время измерения.
+ */
+static void runBatchBenchmark(BatchBench *bench, const char *name,
+                              const Fixture *fixture,
+                              void (*run)(BatchBench *bench), double seconds) {
+  long iterations = 0;
+  long allocs = allocations;
+  double start = nowNs();
+  double elapsed = 0;
+  while (elapsed < seconds * 1e9) {
+    run(bench);
+    iterations += BENCH_BOARDS;
+    elapsed = nowNs() - start;
+  }
+  allocs = allocations - allocs;
+
+  printf("%s\t%s\t%.2f\t%.3f\t%ld\n", name, fixture->name,
+         elapsed / iterations, (double)allocs / iterations, iterations);
+}
+
+/**
+ * @brief Измеряет пакетные ядра и stepBatch() для всех поддерживаемых
+ * наборов команд и скалярные функции logic.c на тех же полях.
+ * @param game Игра, поле которой используется для заполнения.
+ * @param fixtures Описания полей.
+ * @param count Количество описаний.
+ * @param random Генератор случайных клеток и положений.
+ * @param seconds Минимальное время измерения одной строки.
+ */
+static void runBatchBenchmarks(Game *game, const Fixture *fixtures, int count,
+                               Random *random, double seconds) {
+  static const BatchBenchmark kernels[] = {
+      {"collideBatch", benchCollideBatch},
+      {"fullRowsBatch", benchFullRowsBatch}};
+  static const BatchBenchmark scalars[] = {
+      {"figureCollides", benchFigureCollides},
+      {"lineFilled", benchLineFilled}};
+  BatchBench *bench = (BatchBench *)malloc(sizeof(BatchBench));
+  GameConfig config = {NULL, 1, false};
+  bench->batch = createBatch(BENCH_BOARDS, &config);
+  BatchIsa initial = batchIsa();
+  static const UserAction actions[] = {LEFT,   RIGHT,  DOWN,  ROTATE,
+                                       ACTION, ACTION, ACTION};
+  for (int i = 0; i < BENCH_SCRIPT; i++)
+    bench->script[i] =
+        actions[randomRange(random, sizeof(actions) / sizeof(*actions))];
+  for (int b = 0; b < BENCH_BOARDS; b++)
+    bench->games[b] = initGameWith(&config);
+
+  for (size_t k = 0; k < sizeof(kernels) / sizeof(*kernels); k++) {
+    for (int f = 0; f < count; f++) {
+      fillBatchBench(bench, game, &fixtures[f], random);
+      runBatchBenchmark(bench, scalars[k].name, &fixtures[f], scalars[k].run,
+                        seconds);
+      for (int isa = IsaScalar; isa <= (int)supportedBatchIsa(); isa++) {
+        char name[64];
+        setBatchIsa((BatchIsa)isa);
+        snprintf(name, sizeof(name), "%s.%s", kernels[k].name,
+                 batchIsaName((BatchIsa)isa));
+        runBatchBenchmark(bench, name, &fixtures[f], kernels[k].run, seconds);
+      }
+    }
+  }
+
+  for (int f = 0; f < count; f++) {
+    Random start = *random;
+    fillStepBench(bench, game, &fixtures[f], random);
+    runBatchBenchmark(bench, "stepGame", &fixtures[f], benchStepGame, seconds);
+    for (int isa = IsaScalar; isa <= (int)supportedBatchIsa(); isa++) {
+      char name[64];
+      setBatchIsa((BatchIsa)isa);
+      snprintf(name, sizeof(name), "stepBatch.%s",
+               batchIsaName((BatchIsa)isa));
+      Random same = start;
+      fillStepBench(bench, game, &fixtures[f], &same);
+      runBatchBenchmark(bench, name, &fixtures[f], benchStepBatch, seconds);
+    }
+  }
+
+  setBatchIsa(initial);
+  for (int b = 0; b < BENCH_BOARDS; b++) freeGame(bench->games[b]);
+  freeBatch(bench->batch);
+  free(bench);
+}
+
+/**
+ * @brief Запуск микробенчмарков.
+ * @return 0 при успешном завершении, 1 при неверных аргументах.
+ */
+int main(int argc, char **argv) {
+  double seconds = 0.2;
+  uint64_t seed = 1;
+  int opt;
+  while ((opt = getopt(argc, argv, "t:s:")) != -1) {
+    if (opt == 't')
+      seconds = atof(optarg);
+    else if (opt == 's')
+      seed = strtoull(optarg, NULL, 10);
+    else {
+      fprintf(stderr, "usage: %s [-t seconds] [-s seed]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  static const Fixture fixtures[] = {{"empty", FIELD_HEIGHT, 0, 0},
+                                     {"half", FIELD_HEIGHT / 2, 0, 70},
+                                     {"topout", 4, 0, 80},
+                                     {"clears", FIELD_HEIGHT / 2, 4, 70}};
+  static const Benchmark benchmarks[] = {
+      {"restore", benchRestore},
+      {"calculate", benchCalculate},
+      {"collision", benchCollision},
+      {"eraseLines", benchEraseLines},
+      {"rotationFigure", benchRotationFigure},
+      {"rotate", benchRotate},
+      {"dropNewFigure", benchDropNewFigure},
+      {"countScore", benchCountScore},
+      {"features", benchFeatures},
+      {"featuresScalar", benchFeaturesScalar}};
+
+  GameConfig config = {NULL, seed, false};
+  Game *game = initGameWith(&config);
+  Random random;
+  seedRandom(&random, seed);
+
+  printf("benchmark\tfixture\tns_per_op\tallocs_per_op\titerations\n");
+  for (size_t b = 0; b < sizeof(benchmarks) / sizeof(*benchmarks); b++) {
+    for (size_t f = 0; f < sizeof(fixtures) / sizeof(*fixtures); f++) {
+      resetGame(game);
+      stepGame(game, START);
+      game->player->action = ACTION;
+      game->gameInfo->ticks_left = 0;
+      fillFixture(game, &fixtures[f], &random);
+      runBenchmark(game, &fixtures[f], &benchmarks[b], seconds);
+    }
+  }
+  runBatchBenchmarks(game, fixtures, sizeof(fixtures) / sizeof(*fixtures),
+                     &random, seconds);
+
+  freeGame(game);
+  return 0;
+}
@@ -0,0 +1,165 @@
+/**
+ * @file frames.c
+ * @brief Бенчмарк вывода кадров в терминал.
+ *
+ * Для каждого способа вывода (ncurses и ANSI, см. cli.h) играет одну и ту
+ * же игру автоматическим игроком и выводит кадр после каждого тика, как
+ * игровой цикл tetris.c. Вывод терминала направляется в /dev/null, а
+ * записанные байты и количество вызовов записи берутся из /proc/self/io
+ * (поля `wchar` и `syscw`). Каждый способ вывода измеряется в отдельном
+ * процессе, потому что ncurses нельзя инициализировать повторно.
+ *
+ * Результаты печатаются в формате TSV (вывод, кадры, байт/кадр,
+ * записей/кадр, нс/кадр); первый, полный кадр выводится отдельной строкой
+ * `<вывод>.full`, остальные - строкой `<вывод>.diff`.
+ *
+ * Запуск: `frames [-n тиков] [-s seed]`. Тип терминала берётся из `TERM`,
+ * по умолчанию `xterm-256color`.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../brick_game/tetris/ai.h"
+#include "../gui/cli/cli.h"
+
+#define FRAMES_TICKS 20000 /*!< Тиков игры по умолчанию */
+
+/**
+ * @struct IoCounters
+ * @brief Счётчики ввода-вывода процесса.
+ */
+typedef struct IoCounters {
+  long long bytes;   ///< Записано байт (`wchar`)
+  long long writes;  ///< Вызовов записи (`syscw`)
+} IoCounters;
+
+/**
+ * @brief Читает счётчики записи процесса из /proc/self/io.
+ * @return Счётчики; нули, если файл недоступен.
+ */
+static IoCounters readIo() {
+  IoCounters io = {0, 0};
+  FILE *file = fopen("/proc/self/io", "r");
+  if (file) {
+    char name[32];
+    long long value;
+    while (fscanf(file, "%31s %lld", name, &value) == 2) {
+      if (strcmp(name, "wchar:") == 0) io.bytes = value;
+      if (strcmp(name, "syscw:") == 0) io.writes = value;
+    }
+    fclose(file);
+  }
+  return io;
+}
+
+/**
+ * @brief Печатает строку результатов.
+ * @param out Поток результатов.
+ * @param name Название строки.
+ * @param frames Количество кадров.
+ * @param from Счётчики до вывода кадров.
+ * @param to Счётчики после вывода кадров.
+ * @param ns Время вывода кадров в наносекундах.
+ */
+static void report(FILE *out, const char *name, long long frames,
+                   IoCounters from, IoCounters to, uint64_t ns) {
+  fprintf(out, "%s\t%lld\t%.1f\t%.3f\t%.0f\n", name, frames,
+          (double)(to.bytes - from.bytes) / (double)frames,
+          (double)(to.writes - from.writes) / (double)frames,
+          (double)ns / (double)frames);
+}
+
+/**
+ * @brief Играет игру и измеряет вывод кадров одним способом.
+ * @param out Поток результатов.
+ * @param render Способ вывода кадров.
+ * @param name Название способа вывода.
+ * @param ticks Количество тиков.
+ * @param seed Начальное значение генератора фигур.
+ */
+static void measure(FILE *out, RenderBackend render, const char *name,
+                    long long ticks, uint64_t seed) {
+  GameConfig config = {NULL, seed, false};
+  Game *game = initGameWith(&config);
+  Autoplayer ai;
+  initAutoplayer(&ai, false);
+  initGui(render);
+  stepGame(game, START);
+
+  IoCounters start = readIo();
+  uint64_t startNs = monotonicNs();
+  printGame(game);
+  IoCounters full = readIo();
+  uint64_t fullNs = monotonicNs();
+
+  for (long long i = 0; i < ticks; i++) {
+    UserAction action = game->gameInfo->state == GameOver
+                            ? START
+                            : aiAction(&ai, game);
+    stepGame(game, action);
+    printGame(game);
+  }
+  IoCounters end = readIo();
+  uint64_t endNs = monotonicNs();
+  closeGui();
+  freeGame(game);
+
+  char row[64];
+  snprintf(row, sizeof(row), "%s.full", name);
+  report(out, row, 1, start, full, fullNs - startNs);
+  snprintf(row, sizeof(row), "%s.diff", name);
+  report(out, row, ticks, full, end, endNs - fullNs);
+}
+
+/**
+ * @brief Запуск бенчмарка вывода кадров.
+ * @return 0 при успешном завершении, 1 при неверных аргументах или ошибке.
+ */
+int main(int argc, char **argv) {
+  long long ticks = FRAMES_TICKS;
+  uint64_t seed = 1;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:s:")) != -1) {
+    if (opt == 'n') {
+      ticks = atoll(optarg);
+    } else if (opt == 's') {
+      seed = strtoull(optarg, NULL, 10);
+    } else {
+      fprintf(stderr, "usage: %s [-n ticks] [-s seed]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (ticks < 1) ticks = 1;
+
+  const char *names[] = {"curses", "ansi"};
+  const RenderBackend renders[] = {RenderCurses, RenderAnsi};
+  int result = 0;
+  int saved = dup(STDOUT_FILENO);
+  FILE *out = saved >= 0 ? fdopen(saved, "w") : NULL;
+  int null = open("/dev/null", O_WRONLY);
+  if (!out || null < 0 || dup2(null, STDOUT_FILENO) < 0) {
+    fprintf(stderr, "cannot redirect terminal output\n");
+    return 1;
+  }
+  setenv("TERM", getenv("TERM") ? getenv("TERM") : "xterm-256color", 1);
+  fprintf(out, "render\tframes\tbytes/frame\twrites/frame\tns/frame\n");
+  fflush(out);
+
+  for (int i = 0; i < 2; i++) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      measure(out, renders[i], names[i], ticks, seed);
+      fclose(out);
+      _exit(0);
+    }
+    int status = 1;
+    if (pid < 0 || waitpid(pid, &status, 0) < 0 || status != 0) result = 1;
+  }
+  fclose(out);
+  close(null);
+  return result;
+}
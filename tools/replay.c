@@ -0,0 +1,93 @@
+/**
+ * @file replay.c
+ * @brief Проверка и быстрое воспроизведение записанных игр.
+ *
+ * Для каждого файла повтора создаёт игру с записанными параметрами,
+ * выполняет все записанные действия без интерфейса с максимальной скоростью
+ * и сравнивает итоговый счёт и хеш поля с сохранёнными в файле.
+ *
+ * Запуск: `replay [-n повторений] файл...`. Код возврата 1 означает, что
+ * хотя бы один файл не прочитан или не совпал с записью.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <unistd.h>
+
+#include "../brick_game/tetris/replay.h"
+
+/**
+ * @brief Возвращает текущее время монотонных часов в секундах.
+ * @return Время в секундах.
+ */
+static double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Воспроизводит один файл и печатает результат проверки.
+ * @param path Путь к файлу повтора.
+ * @param repeat Количество воспроизведений.
+ * @return true, если файл прочитан и все воспроизведения совпали с записью.
+ */
+static bool verifyReplay(const char *path, int repeat) {
+  Replay *replay = loadReplay(path);
+  if (!replay) {
+    printf("%s: cannot read replay\n", path);
+    return false;
+  }
+
+  GameConfig config = {NULL, replay->seed, replay->useBag};
+  bool match = true;
+  uint64_t ticks = 0;
+  Game *game = NULL;
+  double start = now();
+  for (int i = 0; i < repeat && match; i++) {
+    freeGame(game);
+    game = initGameWith(&config);
+    ticks = playReplay(replay, game);
+    match = ticks == replay->ticks && checkReplay(replay, game);
+  }
+  double elapsed = now() - start;
+
+  if (ticks == REPLAY_INVALID)
+    printf("%s: malformed action stream\n", path);
+  else
+    printf("%s: %s ticks %llu score %d/%d hash %016llx/%016llx "
+           "%.0f ticks/sec\n",
+           path, match ? "OK" : "MISMATCH", (unsigned long long)ticks,
+           game->gameInfo->score, replay->score,
+           (unsigned long long)game->field->hash,
+           (unsigned long long)replay->hash,
+           ticks * (double)repeat / elapsed);
+
+  freeGame(game);
+  freeReplay(replay);
+  return match;
+}
+
+/**
+ * @brief Запуск проверки повторов.
+ * @return 0, если все повторы совпали с записью, иначе 1.
+ */
+int main(int argc, char **argv) {
+  int repeat = 1;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:")) != -1) {
+    if (opt == 'n') {
+      repeat = atoi(optarg);
+    } else {
+      repeat = 0;
+    }
+  }
+  if (repeat < 1 || optind >= argc) {
+    fprintf(stderr, "usage: %s [-n repeat] replay...\n", argv[0]);
+    return 1;
+  }
+
+  bool ok = true;
+  for (int i = optind; i < argc; i++) ok = verifyReplay(argv[i], repeat) && ok;
+
+  return ok ? 0 : 1;
+}
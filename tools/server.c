@@ -0,0 +1,430 @@
+/**
+ * @file server.c
+ * @brief Сервер множества игр на локальном сокете Unix.
+ *
+ * Один процесс ведёт до `-m` игр одновременно. Клиент подключается к
+ * сокету Unix (SOCK_STREAM), получает собственную игру (brickgame.h) и
+ * управляет ею, отправляя байты действий UserAction (0 - START, 1 - PAUSE,
+ * 2 - TERMINATE, 3 - LEFT, 4 - RIGHT, 5 - DOWN, 6 - ROTATE, 8 - HARD_DROP;
+ * остальные байты пропускаются). Игры продвигаются одним циклом событий
+ * epoll: таймер timerfd срабатывает каждые TICK_MS, и на каждом тике
+ * каждая игра выполняет один шаг stepGame() (calculate() из logic.c) с
+ * первым действием из очереди клиента, как игровой цикл tetris.c.
+ *
+ * После тика, изменившего игру, клиенту отправляется кадр из
+ * SERVER_FRAME_SIZE байт (числа - little-endian):
+ *
+ * | Смещение | Размер | Значение                                       |
+ * |----------|--------|------------------------------------------------|
+ * | 0        | 40     | 20 строк поля по uint16, бит `j` - столбец `j` |
+ * | 40       | 5      | Строки матрицы текущей фигуры                  |
+ * | 45       | 1      | Столбец матрицы фигуры (int8)                  |
+ * | 46       | 1      | Строка матрицы фигуры (int8)                   |
+ * | 47       | 1      | Фигура (0-6)                                   |
+ * | 48       | 1      | Поворот (0-3)                                  |
+ * | 49       | 1      | Следующая фигура                               |
+ * | 50       | 1      | Состояние BrickState                           |
+ * | 51       | 1      | Пауза (0 или 1)                                |
+ * | 52       | 1      | Уровень                                        |
+ * | 53       | 4      | Счёт (uint32)                                  |
+ * | 57       | 4      | Рекорд (uint32)                                |
+ * | 61       | 4      | Количество фигур (uint32)                      |
+ *
+ * Кадр - полное состояние игры, поэтому медленному клиенту неотправленные
+ * кадры не копятся: начатый кадр дописывается, а остальные заменяются
+ * последним. Память выделяется при запуске (таблица сеансов) и при
+ * подключении (одна игра), поэтому объём памяти ограничен `-m`. Пока нет
+ * подключений, таймер остановлен и сервер не расходует время процессора.
+ * После TERMINATE клиенту отправляется последний кадр и соединение
+ * закрывается.
+ *
+ * Запуск: `server [-S сокет] [-m сеансов] [-s seed] [-b]`, где `-s` задаёт
+ * начальное значение генератора фигур (игра `n`-го подключения получает
+ * seed + n), `-b` включает генератор "мешок из 7 фигур". SIGINT и SIGTERM
+ * завершают сервер и удаляют файл сокета.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../brick_game/tetris/brickgame.h"
+#include "../brick_game/tetris/tetris.h"
+
+#define SERVER_SOCKET "tetris.sock" /*!< Сокет по умолчанию */
+#define SERVER_SESSIONS 256         /*!< Наибольшее число сеансов */
+#define SERVER_QUEUE 64   /*!< Ёмкость очереди действий сеанса (степень 2) */
+#define SERVER_FRAME_SIZE 65 /*!< Размер кадра состояния игры в байтах */
+#define SERVER_CATCHUP_TICKS 5 /*!< Наибольшее число тиков за срабатывание */
+#define SERVER_EVENTS 64       /*!< Событий за один вызов epoll_wait() */
+#define TAG_LISTEN UINT32_MAX  /*!< Метка события слушающего сокета */
+#define TAG_TIMER (UINT32_MAX - 1)  /*!< Метка события таймера */
+#define TAG_SIGNAL (UINT32_MAX - 2) /*!< Метка события сигнала */
+
+/**
+ * @struct Session
+ * @brief Сеанс одного клиента.
+ *
+ * Буфер `out` хранит не больше двух кадров: начатый отправкой кадр и
+ * последний поставленный в очередь.
+ */
+typedef struct Session {
+  int fd;                          ///< Сокет клиента, -1 - сеанс свободен
+  BrickGame *game;                 ///< Игра сеанса
+  uint8_t actions[SERVER_QUEUE];   ///< Кольцевой буфер действий
+  unsigned head;                   ///< Номер следующего извлекаемого действия
+  unsigned tail;                   ///< Номер следующего добавляемого действия
+  uint8_t last[SERVER_FRAME_SIZE];     ///< Последний поставленный кадр
+  uint8_t out[2 * SERVER_FRAME_SIZE];  ///< Неотправленные кадры
+  size_t length;                   ///< Занято байт `out`
+  size_t sent;                     ///< Отправлено байт первого кадра `out`
+  bool closing;  ///< Закрыть после отправки последнего кадра
+} Session;
+
+/**
+ * @struct Server
+ * @brief Состояние сервера.
+ */
+typedef struct Server {
+  int epoll;             ///< Дескриптор epoll
+  int listen;            ///< Слушающий сокет
+  int timer;             ///< Таймер тиков timerfd
+  int signals;           ///< Дескриптор signalfd для SIGINT и SIGTERM
+  Session *sessions;     ///< Таблица сеансов
+  int capacity;          ///< Размер таблицы сеансов
+  int active;            ///< Открытых сеансов
+  BrickGameConfig game;  ///< Параметры новых игр
+  long long accepted;    ///< Принятых подключений
+  long long ticks;       ///< Выполненных тиков
+} Server;
+
+/**
+ * @brief Записывает число в буфер в порядке little-endian.
+ * @param out Буфер.
+ * @param value Число.
+ * @param size Размер числа в байтах.
+ */
+static void putLe(uint8_t *out, uint32_t value, int size) {
+  for (int i = 0; i < size; i++) out[i] = (uint8_t)(value >> (8 * i));
+}
+
+/**
+ * @brief Кодирует состояние игры в кадр (см. описание файла).
+ * @param game Игра.
+ * @param frame Кадр.
+ */
+static void encodeFrame(const BrickGame *game,
+                        uint8_t frame[SERVER_FRAME_SIZE]) {
+  BrickObservation o;
+  brickGameObserve(game, &o);
+  for (int i = 0; i < BRICKGAME_HEIGHT; i++) putLe(frame + 2 * i, o.rows[i], 2);
+  memcpy(frame + 40, o.figureRows, BRICKGAME_FIGURE);
+  frame[45] = (uint8_t)(int8_t)o.figureX;
+  frame[46] = (uint8_t)(int8_t)o.figureY;
+  frame[47] = (uint8_t)o.figureId;
+  frame[48] = (uint8_t)o.figureRotation;
+  frame[49] = (uint8_t)o.nextId;
+  frame[50] = (uint8_t)o.state;
+  frame[51] = (uint8_t)(o.paused != 0);
+  frame[52] = (uint8_t)o.level;
+  putLe(frame + 53, (uint32_t)o.score, 4);
+  putLe(frame + 57, (uint32_t)o.highScore, 4);
+  putLe(frame + 61, (uint32_t)o.pieces, 4);
+}
+
+/**
+ * @brief Ставит кадр в очередь отправки сеанса.
+ *
+ * Кадр, отправка которого уже началась, сохраняется; неотправленный кадр
+ * заменяется новым.
+ *
+ * @param session Сеанс.
+ * @param frame Кадр.
+ */
+static void queueFrame(Session *session, const uint8_t *frame) {
+  size_t keep = session->sent ? SERVER_FRAME_SIZE : 0;
+  memcpy(session->out + keep, frame, SERVER_FRAME_SIZE);
+  session->length = keep + SERVER_FRAME_SIZE;
+  memcpy(session->last, frame, SERVER_FRAME_SIZE);
+}
+
+/**
+ * @brief Отправляет клиенту неотправленные кадры без блокировки.
+ * @param session Сеанс.
+ * @return false, если соединение разорвано.
+ */
+static bool flushSession(Session *session) {
+  bool alive = true;
+  while (alive && session->sent < session->length) {
+    ssize_t n = send(session->fd, session->out + session->sent,
+                     session->length - session->sent, MSG_NOSIGNAL);
+    if (n > 0)
+      session->sent += (size_t)n;
+    else if (n < 0 && errno == EINTR)
+      continue;
+    else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      break;
+    else
+      alive = false;
+  }
+  if (session->sent == session->length) {
+    session->sent = 0;
+    session->length = 0;
+  } else if (session->sent >= SERVER_FRAME_SIZE) {
+    memmove(session->out, session->out + SERVER_FRAME_SIZE,
+            session->length - SERVER_FRAME_SIZE);
+    session->length -= SERVER_FRAME_SIZE;
+    session->sent -= SERVER_FRAME_SIZE;
+  }
+  return alive;
+}
+
+/**
+ * @brief Включает или останавливает таймер тиков.
+ * @param server Сервер.
+ * @param run true - тики каждые TICK_MS, false - остановить.
+ */
+static void armTimer(Server *server, bool run) {
+  struct itimerspec spec = {{0, 0}, {0, 0}};
+  if (run) {
+    spec.it_interval.tv_nsec = TICK_MS * 1000000L;
+    spec.it_value = spec.it_interval;
+  }
+  timerfd_settime(server->timer, 0, &spec, NULL);
+}
+
+/**
+ * @brief Закрывает сеанс и освобождает его игру.
+ * @param server Сервер.
+ * @param session Сеанс.
+ */
+static void closeSession(Server *server, Session *session) {
+  close(session->fd);
+  brickGameDestroy(session->game);
+  session->fd = -1;
+  session->game = NULL;
+  if (--server->active == 0) armTimer(server, false);
+}
+
+/**
+ * @brief Принимает ожидающие подключения.
+ *
+ * Если свободных сеансов нет, подключение сразу закрывается.
+ *
+ * @param server Сервер.
+ */
+static void acceptClients(Server *server) {
+  int fd;
+  while ((fd = accept(server->listen, NULL, NULL)) >= 0) {
+    Session *session = NULL;
+    for (int i = 0; !session && i < server->capacity; i++)
+      if (server->sessions[i].fd < 0) session = &server->sessions[i];
+    BrickGameConfig config = server->game;
+    config.seed += (uint64_t)server->accepted;
+    BrickGame *game = session ? brickGameCreate(&config) : NULL;
+    if (!game) {
+      close(fd);
+      continue;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    memset(session, 0, sizeof(*session));
+    session->fd = fd;
+    session->game = game;
+    struct epoll_event event = {.events = EPOLLIN};
+    event.data.u32 = (uint32_t)(session - server->sessions);
+    epoll_ctl(server->epoll, EPOLL_CTL_ADD, fd, &event);
+    if (server->active++ == 0) armTimer(server, true);
+    server->accepted++;
+
+    uint8_t frame[SERVER_FRAME_SIZE];
+    encodeFrame(game, frame);
+    queueFrame(session, frame);
+    if (!flushSession(session)) closeSession(server, session);
+  }
+}
+
+/**
+ * @brief Читает действия клиента в очередь сеанса.
+ *
+ * Действия, не поместившиеся в очередь, отбрасываются.
+ *
+ * @param server Сервер.
+ * @param session Сеанс.
+ */
+static void readClient(Server *server, Session *session) {
+  uint8_t buffer[256];
+  ssize_t n;
+  while ((n = read(session->fd, buffer, sizeof(buffer))) > 0) {
+    for (ssize_t i = 0; i < n; i++) {
+      bool valid = buffer[i] <= HARD_DROP && buffer[i] != ACTION;
+      if (valid && session->tail - session->head < SERVER_QUEUE)
+        session->actions[session->tail++ % SERVER_QUEUE] = buffer[i];
+    }
+  }
+  if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+    closeSession(server, session);
+}
+
+/**
+ * @brief Выполняет один тик всех игр и отправляет изменившиеся кадры.
+ * @param server Сервер.
+ */
+static void tickSessions(Server *server) {
+  for (int i = 0; i < server->capacity; i++) {
+    Session *session = &server->sessions[i];
+    if (session->fd < 0 || session->closing) continue;
+    BrickAction action = BRICK_NONE;
+    if (session->head != session->tail)
+      action = (BrickAction)session->actions[session->head++ % SERVER_QUEUE];
+    if (brickGameStep(session->game, action) == BRICK_STATE_QUIT)
+      session->closing = true;
+    uint8_t frame[SERVER_FRAME_SIZE];
+    encodeFrame(session->game, frame);
+    if (memcmp(frame, session->last, SERVER_FRAME_SIZE) != 0)
+      queueFrame(session, frame);
+  }
+  for (int i = 0; i < server->capacity; i++) {
+    Session *session = &server->sessions[i];
+    if (session->fd >= 0 &&
+        (!flushSession(session) || (session->closing && !session->length)))
+      closeSession(server, session);
+  }
+  server->ticks++;
+}
+
+/**
+ * @brief Создаёт слушающий сокет, таймер и epoll.
+ *
+ * Оставшийся от прошлого запуска сокет по пути `path` удаляется; любой
+ * другой файл по этому пути не трогается, и сервер не запускается.
+ *
+ * @param server Сервер.
+ * @param path Путь к сокету.
+ * @return true при успехе.
+ */
+static bool openServer(Server *server, const char *path) {
+  struct sockaddr_un address = {.sun_family = AF_UNIX};
+  bool ok = strlen(path) < sizeof(address.sun_path);
+  if (ok) {
+    strcpy(address.sun_path, path);
+    struct stat status;
+    if (lstat(path, &status) == 0)
+      ok = S_ISSOCK(status.st_mode) && unlink(path) == 0;
+  }
+  if (ok) {
+    server->listen = socket(AF_UNIX, SOCK_STREAM, 0);
+    ok = server->listen >= 0 &&
+         bind(server->listen, (struct sockaddr *)&address,
+              sizeof(address)) == 0 &&
+         listen(server->listen, SOMAXCONN) == 0;
+  }
+  if (ok) {
+    fcntl(server->listen, F_SETFL,
+          fcntl(server->listen, F_GETFL) | O_NONBLOCK);
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigprocmask(SIG_BLOCK, &mask, NULL);
+    server->signals = signalfd(-1, &mask, SFD_NONBLOCK);
+    server->timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+    server->epoll = epoll_create1(0);
+    ok = server->signals >= 0 && server->timer >= 0 && server->epoll >= 0;
+  }
+  const struct {
+    int fd;
+    uint32_t tag;
+  } watched[] = {{server->listen, TAG_LISTEN},
+                 {server->timer, TAG_TIMER},
+                 {server->signals, TAG_SIGNAL}};
+  for (int i = 0; ok && i < 3; i++) {
+    struct epoll_event event = {.events = EPOLLIN};
+    event.data.u32 = watched[i].tag;
+    ok = epoll_ctl(server->epoll, EPOLL_CTL_ADD, watched[i].fd, &event) == 0;
+  }
+  return ok;
+}
+
+/**
+ * @brief Выполняет цикл событий до сигнала завершения.
+ * @param server Сервер.
+ */
+static void runServer(Server *server) {
+  bool running = true;
+  while (running) {
+    struct epoll_event events[SERVER_EVENTS];
+    int count = epoll_wait(server->epoll, events, SERVER_EVENTS, -1);
+    for (int i = 0; i < count; i++) {
+      uint32_t tag = events[i].data.u32;
+      if (tag == TAG_LISTEN) {
+        acceptClients(server);
+      } else if (tag == TAG_TIMER) {
+        uint64_t expirations = 0;
+        if (read(server->timer, &expirations, sizeof(expirations)) > 0) {
+          if (expirations > SERVER_CATCHUP_TICKS)
+            expirations = SERVER_CATCHUP_TICKS;
+          for (uint64_t t = 0; t < expirations; t++) tickSessions(server);
+        }
+      } else if (tag == TAG_SIGNAL) {
+        running = false;
+      } else if (server->sessions[tag].fd >= 0) {
+        readClient(server, &server->sessions[tag]);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Запуск сервера.
+ * @return 0 при успешном завершении, 1 при неверных аргументах или ошибке
+ * создания сокета.
+ */
+int main(int argc, char **argv) {
+  const char *path = SERVER_SOCKET;
+  Server server = {.capacity = SERVER_SESSIONS,
+                   .game = {(uint64_t)time(NULL), 0, 0}};
+  int opt;
+  while ((opt = getopt(argc, argv, "S:m:s:b")) != -1) {
+    if (opt == 'S') {
+      path = optarg;
+    } else if (opt == 'm') {
+      server.capacity = atoi(optarg);
+    } else if (opt == 's') {
+      server.game.seed = strtoull(optarg, NULL, 10);
+    } else if (opt == 'b') {
+      server.game.useBag = 1;
+    } else {
+      fprintf(stderr, "usage: %s [-S socket] [-m sessions] [-s seed] [-b]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+  if (server.capacity < 1) server.capacity = 1;
+
+  int result = 0;
+  server.sessions = (Session *)calloc(server.capacity, sizeof(Session));
+  if (!server.sessions || !openServer(&server, path)) {
+    fprintf(stderr, "cannot listen on %s\n", path);
+    result = 1;
+  } else {
+    for (int i = 0; i < server.capacity; i++) server.sessions[i].fd = -1;
+    runServer(&server);
+    for (int i = 0; i < server.capacity; i++)
+      if (server.sessions[i].fd >= 0)
+        closeSession(&server, &server.sessions[i]);
+    fprintf(stderr, "sessions: %lld ticks: %lld\n", server.accepted,
+            server.ticks);
+    unlink(path);
+  }
+  free(server.sessions);
+  return result;
+}
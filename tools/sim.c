@@ -0,0 +1,419 @@
+/**
+ * @file sim.c
+ * @brief Пакетный запуск игр без интерфейса.
+ *
+ * Играет заданное количество игр до конца, используя случайные действия,
+ * сценарий действий или автоматического игрока, распределяя игры между
+ * потоками pthread. По окончании выводит количество игр, тиков и фигур в
+ * секунду, а для автоматического игрока - и оценённых мест в секунду.
+ *
+ * Запуск: `sim [-n игры] [-j потоки] [-s seed] [-t максимум тиков]
+ * [-a сценарий] [-b] [-A] [-l] [-w потоки поиска] [-T биты таблицы]
+ * [-B размер набора]`, где `-b` включает генератор "мешок из 7 фигур", `-A`
+ * - автоматического игрока (см. ai.h), `-l` - учёт им следующей фигуры,
+ * `-w` - параллельный поиск хода каждой игры на пуле из заданного числа
+ * потоков (см. search.h), `-T` - таблицу транспозиций из 2^биты записей на
+ * поток (см. table.h), `-B` - пакетный шаг игр наборами заданного размера
+ * (см. batch.h; результаты совпадают с запуском без `-B`, с `-A`, `-w` и
+ * `-T` не сочетается). Сценарий - строка из символов `l` (влево), `r`
+ * (вправо), `d` (вниз), `t` (поворот) и `.` (без действия), повторяемая по
+ * кругу.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../brick_game/tetris/batch.h"
+#include "../brick_game/tetris/search.h"
+#include "../brick_game/tetris/table.h"
+
+/**
+ * @struct SimOptions
+ * @brief Параметры пакетного запуска.
+ */
+typedef struct SimOptions {
+  int games;           ///< Количество игр
+  int threads;         ///< Количество потоков
+  uint64_t seed;       ///< Начальное значение для всех игр
+  long maxTicks;       ///< Ограничение длины одной игры в тиках
+  const char *script;  ///< Сценарий действий, NULL - случайные действия
+  bool useBag;         ///< Генератор "мешок из 7 фигур"
+  bool autoplay;       ///< Играет автоматический игрок
+  bool lookahead;      ///< Автоматический игрок учитывает следующую фигуру
+  int searchThreads;   ///< Потоков поиска на игру, 0 - поиск в потоке игры
+  int tableBits;       ///< Размер таблицы транспозиций, 0 - без таблицы
+  int batchSize;       ///< Размер набора для stepBatch(), 0 - по одной игре
+} SimOptions;
+
+/**
+ * @struct SimStats
+ * @brief Счётчики, накопленные одним потоком.
+ */
+typedef struct SimStats {
+  long games;       ///< Сыграно игр
+  long ticks;       ///< Выполнено вызовов calculate()
+  long pieces;      ///< Появилось фигур
+  long long score;  ///< Суммарный счёт
+  long long evaluations;  ///< Оценено мест автоматическим игроком
+  long long steals;       ///< Задач поиска, украденных потоками пула
+  double searchSeconds;   ///< Время поисков, сумма по всем играм
+  long long probes;       ///< Поисков в таблице транспозиций
+  long long hits;         ///< Найденных в таблице записей
+} SimStats;
+
+/**
+ * @struct SimWorker
+ * @brief Поток пакетного запуска.
+ */
+typedef struct SimWorker {
+  pthread_t thread;            ///< Идентификатор потока
+  const SimOptions *options;   ///< Параметры запуска
+  atomic_int *next;            ///< Номер следующей несыгранной игры
+  SimStats stats;              ///< Счётчики потока
+} SimWorker;
+
+/**
+ * @brief Перемешивает 64-битное значение (SplitMix64).
+ * @param x Исходное значение.
+ * @return Перемешанное значение.
+ */
+static uint64_t mixSeed(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/**
+ * @brief Возвращает действие сценария или случайное действие.
+ * @param options Параметры запуска.
+ * @param random Генератор случайных действий.
+ * @param tick Номер тика.
+ * @return Действие игрока.
+ */
+static UserAction nextAction(const SimOptions *options, Random *random,
+                             long tick) {
+  UserAction action = ACTION;
+  if (options->script) {
+    switch (options->script[tick % (long)strlen(options->script)]) {
+      case 'l':
+        action = LEFT;
+        break;
+      case 'r':
+        action = RIGHT;
+        break;
+      case 'd':
+        action = DOWN;
+        break;
+      case 't':
+        action = ROTATE;
+        break;
+      default:
+        break;
+    }
+  } else {
+    static const UserAction actions[] = {LEFT,   RIGHT,  DOWN,  ROTATE,
+                                         ACTION, ACTION, ACTION};
+    action = actions[randomRange(random, sizeof(actions) / sizeof(*actions))];
+  }
+  return action;
+}
+
+/**
+ * @brief Играет одну игру до конца и добавляет её результаты к счётчикам.
+ * @param worker Поток пакетного запуска.
+ * @param game Переиспользуемый объект игры.
+ * @param pool Пул потоков поиска или NULL.
+ * @param table Таблица транспозиций или NULL.
+ * @param index Номер игры.
+ */
+static void playGame(SimWorker *worker, Game *game, SearchPool *pool,
+                     TransTable *table, int index) {
+  const SimOptions *options = worker->options;
+  Random actions;
+  seedRandom(&game->gameInfo->random, mixSeed(options->seed + 2 * index));
+  seedRandom(&actions, mixSeed(options->seed + 2 * index + 1));
+  resetGame(game);
+  Autoplayer ai;
+  initAutoplayer(&ai, options->lookahead);
+  ai.pool = pool;
+  ai.table = table;
+
+  stepGame(game, START);
+  long tick = 1;
+  while (game->gameInfo->state != GameOver && tick < options->maxTicks) {
+    stepGame(game, options->autoplay ? aiAction(&ai, game)
+                                     : nextAction(options, &actions, tick));
+    tick++;
+  }
+
+  worker->stats.games++;
+  worker->stats.ticks += tick;
+  worker->stats.pieces += game->gameInfo->pieces;
+  worker->stats.score += game->gameInfo->score;
+  worker->stats.evaluations += ai.counters.evaluations;
+  worker->stats.probes += ai.counters.probes;
+  worker->stats.hits += ai.counters.hits;
+}
+
+/**
+ * @brief Помещает в ячейку набора следующую игру из общей очереди.
+ *
+ * Игра начинается и получает действия так же, как в playGame(), поэтому
+ * результаты совпадают с пошаговым запуском.
+ *
+ * @param worker Поток пакетного запуска.
+ * @param batch Набор игр.
+ * @param game Объект игры для подготовки начального состояния.
+ * @param slot Номер ячейки набора.
+ * @param actions Генератор случайных действий ячейки.
+ * @return false, если игры в очереди кончились.
+ */
+static bool loadBatchGame(SimWorker *worker, GameBatch *batch, Game *game,
+                          int slot, Random *actions) {
+  const SimOptions *options = worker->options;
+  int index = atomic_fetch_add(worker->next, 1);
+  bool loaded = index < options->games;
+  if (loaded) {
+    GameSnapshot snapshot;
+    seedRandom(&game->gameInfo->random, mixSeed(options->seed + 2 * index));
+    seedRandom(actions, mixSeed(options->seed + 2 * index + 1));
+    resetGame(game);
+    snapshotGame(game, &snapshot);
+    restoreBatchGame(batch, slot, &snapshot);
+  }
+  return loaded;
+}
+
+/**
+ * @brief Играет игры из общей очереди наборами функцией stepBatch().
+ *
+ * Каждая ячейка набора ведёт свою игру; закончившуюся игру ячейка
+ * заменяет следующей из очереди, поэтому все ячейки заняты, пока очередь
+ * не опустеет. Опустевшие ячейки получают пустое действие.
+ *
+ * @param worker Поток пакетного запуска.
+ * @param batch Набор игр.
+ * @param game Объект игры для подготовки начальных состояний.
+ */
+static void playBatch(SimWorker *worker, GameBatch *batch, Game *game) {
+  const SimOptions *options = worker->options;
+  int size = batch->count;
+  Random *actions = (Random *)malloc(size * sizeof(Random));
+  long *ticks = (long *)malloc(size * sizeof(long));
+  bool *busy = (bool *)malloc(size * sizeof(bool));
+  UserAction *step = (UserAction *)malloc(size * sizeof(UserAction));
+
+  int running = 0;
+  for (int b = 0; b < size; b++) {
+    busy[b] = loadBatchGame(worker, batch, game, b, &actions[b]);
+    ticks[b] = 0;
+    running += busy[b];
+  }
+
+  while (running > 0) {
+    for (int b = 0; b < size; b++)
+      step[b] = !busy[b]       ? ACTION
+                : ticks[b] == 0 ? START
+                                : nextAction(options, &actions[b], ticks[b]);
+    stepBatch(batch, step);
+
+    for (int b = 0; b < size; b++) {
+      if (busy[b]) ticks[b]++;
+      if (busy[b] && (batch->state[b] == GameOver ||
+                      ticks[b] >= options->maxTicks)) {
+        worker->stats.games++;
+        worker->stats.ticks += ticks[b];
+        worker->stats.pieces += batch->pieces[b];
+        worker->stats.score += batch->score[b];
+        busy[b] = loadBatchGame(worker, batch, game, b, &actions[b]);
+        ticks[b] = 0;
+        running -= !busy[b];
+      }
+    }
+  }
+
+  free(step);
+  free(busy);
+  free(ticks);
+  free(actions);
+}
+
+/**
+ * @brief Функция потока: берёт игры из общей очереди, пока они не кончатся.
+ * @param arg Указатель на SimWorker.
+ * @return NULL.
+ */
+static void *runWorker(void *arg) {
+  SimWorker *worker = (SimWorker *)arg;
+  GameConfig config = {NULL, worker->options->seed, worker->options->useBag};
+  Game *game = initGameWith(&config);
+  SearchPool *pool = worker->options->searchThreads
+                         ? createSearchPool(worker->options->searchThreads)
+                         : NULL;
+  TransTable *table = worker->options->tableBits
+                          ? createTable(worker->options->tableBits)
+                          : NULL;
+
+  int size = worker->options->batchSize;
+  GameBatch *batch = size ? createBatch(size, &config) : NULL;
+
+  int index;
+  if (batch) {
+    playBatch(worker, batch, game);
+    freeBatch(batch);
+  } else {
+    while ((index = atomic_fetch_add(worker->next, 1)) <
+           worker->options->games)
+      playGame(worker, game, pool, table, index);
+  }
+
+  if (table) freeTable(table);
+  if (pool) {
+    SearchStats stats = searchStats(pool);
+    worker->stats.steals = stats.steals;
+    worker->stats.searchSeconds = stats.seconds;
+    freeSearchPool(pool);
+  }
+  freeGame(game);
+  return NULL;
+}
+
+/**
+ * @brief Возвращает текущее время монотонных часов в секундах.
+ * @return Время в секундах.
+ */
+static double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Разбирает аргументы командной строки.
+ * @param argc Количество аргументов.
+ * @param argv Аргументы.
+ * @param options Заполняемые параметры запуска.
+ * @return 0 при успехе, 1 при ошибке.
+ */
+static int parseOptions(int argc, char **argv, SimOptions *options) {
+  int error = 0;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:j:s:t:a:bAlw:T:B:")) != -1 && !error) {
+    switch (opt) {
+      case 'n':
+        options->games = atoi(optarg);
+        break;
+      case 'j':
+        options->threads = atoi(optarg);
+        break;
+      case 's':
+        options->seed = strtoull(optarg, NULL, 10);
+        break;
+      case 't':
+        options->maxTicks = atol(optarg);
+        break;
+      case 'a':
+        options->script = optarg;
+        break;
+      case 'b':
+        options->useBag = true;
+        break;
+      case 'A':
+        options->autoplay = true;
+        break;
+      case 'l':
+        options->lookahead = true;
+        break;
+      case 'w':
+        options->searchThreads = atoi(optarg);
+        break;
+      case 'T':
+        options->tableBits = atoi(optarg);
+        break;
+      case 'B':
+        options->batchSize = atoi(optarg);
+        break;
+      default:
+        error = 1;
+        break;
+    }
+  }
+  if (options->games < 1 || options->threads < 1 || options->maxTicks < 1 ||
+      options->searchThreads < 0 || options->tableBits < 0 ||
+      options->tableBits > 30 || options->batchSize < 0 ||
+      (options->batchSize && (options->autoplay || options->searchThreads ||
+                              options->tableBits)) ||
+      (options->script && !*options->script))
+    error = 1;
+  return error;
+}
+
+/**
+ * @brief Запуск пакетной симуляции.
+ * @return 0 при успешном завершении, 1 при неверных аргументах.
+ */
+int main(int argc, char **argv) {
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  SimOptions options = {1000, cpus > 0 ? (int)cpus : 1, 1, 1000000, NULL,
+                        false, false, false, 0, 0, 0};
+  if (parseOptions(argc, argv, &options)) {
+    fprintf(stderr,
+            "usage: %s [-n games] [-j threads] [-s seed] [-t max_ticks] "
+            "[-a script] [-b] [-A] [-l] [-w search_threads] [-T table_bits] "
+            "[-B batch_size]\n",
+            argv[0]);
+    return 1;
+  }
+
+  SimWorker *workers = (SimWorker *)calloc(options.threads, sizeof(SimWorker));
+  atomic_int next = 0;
+  double start = now();
+  for (int i = 0; i < options.threads; i++) {
+    workers[i].options = &options;
+    workers[i].next = &next;
+    pthread_create(&workers[i].thread, NULL, runWorker, &workers[i]);
+  }
+
+  SimStats total = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+  for (int i = 0; i < options.threads; i++) {
+    pthread_join(workers[i].thread, NULL);
+    total.games += workers[i].stats.games;
+    total.ticks += workers[i].stats.ticks;
+    total.pieces += workers[i].stats.pieces;
+    total.score += workers[i].stats.score;
+    total.evaluations += workers[i].stats.evaluations;
+    total.steals += workers[i].stats.steals;
+    total.searchSeconds += workers[i].stats.searchSeconds;
+    total.probes += workers[i].stats.probes;
+    total.hits += workers[i].stats.hits;
+  }
+  double elapsed = now() - start;
+  free(workers);
+
+  printf("games:      %ld\n", total.games);
+  printf("threads:    %d\n", options.threads);
+  printf("time:       %.3f s\n", elapsed);
+  printf("games/sec:  %.1f\n", total.games / elapsed);
+  printf("ticks/sec:  %.0f\n", total.ticks / elapsed);
+  printf("pieces/sec: %.0f\n", total.pieces / elapsed);
+  printf("avg score:  %.1f\n", (double)total.score / total.games);
+  if (options.autoplay)
+    printf("evals/sec:  %.0f\n", total.evaluations / elapsed);
+  if (options.autoplay && options.searchThreads) {
+    printf("nodes/sec:  %.0f\n", total.evaluations / elapsed);
+    if (total.searchSeconds > 0)
+      printf("per game:   %.0f nodes/sec of search time\n",
+             total.evaluations / total.searchSeconds);
+    printf("steals:     %lld\n", total.steals);
+  }
+  if (options.autoplay && options.tableBits)
+    printf("table hits: %.1f%% of %lld probes\n",
+           total.probes ? 100.0 * total.hits / total.probes : 0.0,
+           total.probes);
+
+  return 0;
+}